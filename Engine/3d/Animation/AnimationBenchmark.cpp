@@ -0,0 +1,618 @@
+#define NOMINMAX
+#include "AnimationBenchmark.h"
+#include "Allocation/AllocationCounter.h"
+#include "AnimationBlender.h"
+#include "AnimationCompression.h"
+#include "AnimationLod.h"
+#include "AnimationResampler.h"
+#include "AnimationUpdateQueue.h"
+#include "Animator.h"
+#include "Bone.h"
+#include "Log/Logger.h"
+#include "String/CommandLine.h"
+#include "ModelAnimation.h"
+#include "Skin.h"
+#include "Thread/ThreadPool.h"
+#include <Engine/Frame/Frame.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <type_traits>
+#include <myMath.h>
+
+using namespace Logger;
+namespace fs = std::filesystem;
+
+const std::string AnimationBenchmark::kOutputDirectoryPath = "resources/jsons/AnimationBenchmark/";
+
+namespace {
+// 比較用: 毎回先頭から区間を探す従来の方式
+template <typename Keyframe>
+auto LinearSample(const std::vector<Keyframe> &keyframes, float time) {
+    if (keyframes.size() == 1 || time <= keyframes[0].time) {
+        return keyframes[0].value;
+    }
+    for (size_t index = 0; index < keyframes.size() - 1; ++index) {
+        size_t nextIndex = index + 1;
+        if (keyframes[index].time <= time && time <= keyframes[nextIndex].time) {
+            float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
+            if constexpr (std::is_same_v<Keyframe, KeyframeQuaternion>) {
+                return Slerp(keyframes[index].value, keyframes[nextIndex].value, t);
+            } else {
+                return Lerp(keyframes[index].value, keyframes[nextIndex].value, t);
+            }
+        }
+    }
+    return keyframes.back().value;
+}
+
+// 合成クリップ(Jointごとに位置・回転・スケールのトラック)
+std::vector<NodeAnimation> CreateClip(uint32_t keyCount, uint32_t joints, float keysPerSecond) {
+    std::vector<NodeAnimation> tracks(joints);
+    for (uint32_t joint = 0; joint < joints; ++joint) {
+        NodeAnimation &track = tracks[joint];
+        track.translate.resize(keyCount);
+        track.rotate.resize(keyCount);
+        track.scale.resize(keyCount);
+        for (uint32_t key = 0; key < keyCount; ++key) {
+            float time = static_cast<float>(key) / keysPerSecond;
+            float phase = time * 2.0f + static_cast<float>(joint);
+            track.translate[key] = {{std::sin(phase), std::cos(phase), 0.1f * phase}, time};
+            track.scale[key] = {{1.0f + 0.1f * std::sin(phase), 1.0f, 1.0f}, time};
+            track.rotate[key] = {Quaternion(0.0f, std::sin(phase * 0.5f), 0.0f, std::cos(phase * 0.5f)), time};
+        }
+    }
+    return tracks;
+}
+
+float Difference(const Vector3 &a, const Vector3 &b) {
+    return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z)});
+}
+
+float Difference(const Quaternion &a, const Quaternion &b) {
+    return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z), std::abs(a.w - b.w)});
+}
+
+// 各経路の誤差の許容値
+constexpr float kSampleTolerance = 1.0e-5f;   // 前回位置からの探索と線形探索(同じ式なので丸め誤差だけ)
+constexpr float kPoseTolerance = 1.0e-4f;     // SolvePoseとMakeAffineMatrix+行列積(相対誤差)
+constexpr float kPaletteTolerance = 1.0e-3f;  // BuildPaletteとTranspose(Inverse)
+constexpr float kResampleTolerance = 1.0e-3f; // 元のキー以上の間隔でサンプリングし直したクリップ
+constexpr float kCompressionSlack = 1.01f;    // 圧縮の許容誤差に対する浮動小数点の余裕
+
+// 誤差が許容値に収まっているか(超えたものをログに出す)
+bool IsWithinTolerance(const AnimationBenchmark::Result &result, const AnimationBenchmark::Options &options) {
+    const AnimationCompression::Tolerance compressionTolerance;
+    struct Check {
+        const char *name;
+        float error;
+        float tolerance;
+    };
+    const Check checks[] = {
+        {"maxError", result.maxError, kSampleTolerance},
+        {"poseMaxError", result.poseMaxError, kPoseTolerance},
+        {"paletteMaxError", result.paletteMaxError, kPaletteTolerance},
+        {"compressedTranslateError", result.compressedTranslateError,
+         std::max(compressionTolerance.translate, compressionTolerance.scale) * kCompressionSlack},
+        {"compressedRotateError", result.compressedRotateError, compressionTolerance.rotate * kCompressionSlack},
+        // 元のキーより粗くサンプリングし直した場合は形が変わるので比べない
+        {"resampledMaxError", options.resampleRate >= options.keysPerSecond ? result.resampledMaxError : 0.0f, kResampleTolerance},
+    };
+    bool isWithin = true;
+    for (const Check &check : checks) {
+        if (!(check.error <= check.tolerance)) {
+            Log("AnimationBenchmark: keys=" + std::to_string(result.keyCount) + " " + check.name + "=" + std::to_string(check.error) +
+                " exceeds " + std::to_string(check.tolerance) + "\n");
+            isWithin = false;
+        }
+    }
+    return isWithin;
+}
+} // namespace
+
+bool AnimationBenchmark::IsRequested(const std::string &commandLine) {
+    return commandLine.find("--animation-bench") != std::string::npos;
+}
+
+int AnimationBenchmark::RunFromCommandLine(const std::string &commandLine) {
+    Options options;
+    std::string value;
+    if (CommandLine::FindOption(commandLine, "keys", value)) {
+        options.keyCounts = CommandLine::SplitNumbers(value);
+    }
+    if (CommandLine::FindOption(commandLine, "joints", value)) {
+        options.joints = static_cast<uint32_t>(std::stoul(value));
+    }
+    if (CommandLine::FindOption(commandLine, "frames", value)) {
+        options.frames = static_cast<uint32_t>(std::stoul(value));
+    }
+    if (CommandLine::FindOption(commandLine, "resample", value)) {
+        options.resampleRate = std::stof(value);
+    }
+    if (CommandLine::FindOption(commandLine, "characters", value)) {
+        options.characters = static_cast<uint32_t>(std::stoul(value));
+    }
+    // キャラクターの並列更新を計るのでワーカーを立てる
+    ThreadPool::GetInstance()->Initialize();
+    std::vector<Result> results = Run(options);
+    ThreadPool::GetInstance()->Finalize();
+    if (results.empty()) {
+        return 1;
+    }
+    // 確保回数を確かめられないビルドでは成功扱いにしない
+    if (!AllocationCounter::IsEnabled()) {
+        Log("AnimationBenchmark: allocation counter disabled (run the Debug build, which defines ENABLE_ALLOCATION_COUNTER)\n");
+        return 3;
+    }
+    for (const Result &result : results) {
+        if (result.allocationsPerFrame > 0.0 || result.flushAllocationsPerFrame > 0.0) {
+            Log("AnimationBenchmark: heap allocations during update\n");
+            return 2;
+        }
+    }
+    // 高速な経路が従来の計算と一致しているか
+    for (const Result &result : results) {
+        if (!IsWithinTolerance(result, options)) {
+            return 4;
+        }
+    }
+    return 0;
+}
+
+std::vector<AnimationBenchmark::Result> AnimationBenchmark::Run(const Options &options) {
+    std::vector<Result> results;
+    for (uint32_t keyCount : options.keyCounts) {
+        if (keyCount < 2 || options.joints == 0) {
+            continue;
+        }
+        results.push_back(RunClip(keyCount, options));
+    }
+    WriteCsv(results);
+    return results;
+}
+
+AnimationBenchmark::Result AnimationBenchmark::RunClip(uint32_t keyCount, const Options &options) {
+    Result result;
+    result.keyCount = keyCount;
+    result.joints = options.joints;
+
+    const std::vector<NodeAnimation> tracks = CreateClip(keyCount, options.joints, options.keysPerSecond);
+    const float duration = static_cast<float>(keyCount - 1) / options.keysPerSecond;
+    const double samples = static_cast<double>(options.frames) * options.joints * 3.0;
+
+    // 同じ時刻の列で比べる(ループで先頭に戻る)
+    std::vector<float> times(options.frames);
+    float time = 0.0f;
+    for (float &frameTime : times) {
+        frameTime = time;
+        time = std::fmod(time + options.deltaTime, duration);
+    }
+
+    // 結果を捨てられないよう合計しておく
+    float sink = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    for (float frameTime : times) {
+        for (const NodeAnimation &track : tracks) {
+            sink += LinearSample(track.translate, frameTime).x;
+            sink += LinearSample(track.rotate, frameTime).w;
+            sink += LinearSample(track.scale, frameTime).x;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.linearNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / samples;
+
+    // 再生インスタンスごとに持つ前回のキー位置
+    std::vector<uint32_t> cursors(tracks.size() * 3, 0);
+    start = std::chrono::steady_clock::now();
+    for (float frameTime : times) {
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            sink += Animator::CalculateValue(tracks[i].translate, frameTime, cursors[i * 3 + 0]).x;
+            sink += Animator::CalculateValue(tracks[i].rotate, frameTime, cursors[i * 3 + 1]).w;
+            sink += Animator::CalculateValue(tracks[i].scale, frameTime, cursors[i * 3 + 2]).x;
+        }
+    }
+    end = std::chrono::steady_clock::now();
+    result.cursorNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / samples;
+
+    // ランダムなシーク(毎回二分探索になる)
+    std::mt19937 randomEngine(keyCount);
+    std::uniform_real_distribution<float> distribution(0.0f, duration);
+    std::vector<float> seekTimes(options.frames);
+    for (float &seekTime : seekTimes) {
+        seekTime = distribution(randomEngine);
+    }
+    start = std::chrono::steady_clock::now();
+    for (float seekTime : seekTimes) {
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            sink += Animator::CalculateValue(tracks[i].translate, seekTime, cursors[i * 3 + 0]).x;
+            sink += Animator::CalculateValue(tracks[i].rotate, seekTime, cursors[i * 3 + 1]).w;
+            sink += Animator::CalculateValue(tracks[i].scale, seekTime, cursors[i * 3 + 2]).x;
+        }
+    }
+    end = std::chrono::steady_clock::now();
+    result.seekNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / samples;
+
+    // 値が従来の方式と一致するか(再生とシークを混ぜて確認)
+    std::fill(cursors.begin(), cursors.end(), 0);
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        float checkTime = (frame % 2 == 0) ? times[frame] : seekTimes[frame];
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            result.maxError = std::max(result.maxError, Difference(Animator::CalculateValue(tracks[i].translate, checkTime, cursors[i * 3 + 0]),
+                                                                   LinearSample(tracks[i].translate, checkTime)));
+            result.maxError = std::max(result.maxError, Difference(Animator::CalculateValue(tracks[i].rotate, checkTime, cursors[i * 3 + 1]),
+                                                                   LinearSample(tracks[i].rotate, checkTime)));
+            result.maxError = std::max(result.maxError, Difference(Animator::CalculateValue(tracks[i].scale, checkTime, cursors[i * 3 + 2]),
+                                                                   LinearSample(tracks[i].scale, checkTime)));
+        }
+    }
+
+    // 圧縮: メモリ量と誤差、圧縮済みトラックからのサンプリング
+    Animation compressed;
+    compressed.duration = duration;
+    compressed.channels = tracks;
+    for (uint32_t joint = 0; joint < tracks.size(); ++joint) {
+        compressed.channelNames.push_back("joint" + std::to_string(joint));
+    }
+    AnimationCompression::Settings compressionSettings;
+    compressionSettings.isEnabled = true;
+    AnimationCompression::Report report = AnimationCompression::Compress(compressed, compressionSettings);
+    result.rawBytes = report.rawBytes;
+    result.compressedBytes = report.compressedBytes;
+    result.compressedKeys = report.compressedKeys;
+    result.compressedTranslateError = std::max(report.maxTranslateError, report.maxScaleError);
+    result.compressedRotateError = report.maxRotateError;
+    std::fill(cursors.begin(), cursors.end(), 0);
+    start = std::chrono::steady_clock::now();
+    for (float frameTime : times) {
+        for (size_t i = 0; i < compressed.compressedChannels.size(); ++i) {
+            const CompressedNodeAnimation &channel = compressed.compressedChannels[i];
+            sink += Animator::CalculateValue(channel.translate, frameTime, cursors[i * 3 + 0]).x;
+            sink += Animator::CalculateValue(channel.rotate, frameTime, cursors[i * 3 + 1]).w;
+            sink += Animator::CalculateValue(channel.scale, frameTime, cursors[i * 3 + 2]).x;
+        }
+    }
+    end = std::chrono::steady_clock::now();
+    result.compressedNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / samples;
+
+    // 一定間隔にサンプリングし直したクリップ(フレーム位置は1フレームに1回だけ求める)
+    Animation resampled;
+    resampled.duration = duration;
+    resampled.channels = tracks;
+    resampled.channelNames = compressed.channelNames;
+    AnimationResampler::Resample(resampled, options.resampleRate);
+    result.resampledBytes = AnimationResampler::GetByteSize(resampled.resampled);
+    start = std::chrono::steady_clock::now();
+    for (float frameTime : times) {
+        const AnimationResampler::FramePosition position = AnimationResampler::Locate(resampled.resampled, frameTime);
+        for (uint32_t i = 0; i < static_cast<uint32_t>(tracks.size()); ++i) {
+            sink += AnimationResampler::SampleTranslate(resampled.resampled, i, position).x;
+            sink += AnimationResampler::SampleRotate(resampled.resampled, i, position).w;
+            sink += AnimationResampler::SampleScale(resampled.resampled, i, position).x;
+        }
+    }
+    end = std::chrono::steady_clock::now();
+    result.resampledNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / samples;
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        const AnimationResampler::FramePosition position = AnimationResampler::Locate(resampled.resampled, seekTimes[frame]);
+        for (uint32_t i = 0; i < static_cast<uint32_t>(tracks.size()); ++i) {
+            Quaternion rotate = AnimationResampler::SampleRotate(resampled.resampled, i, position);
+            Quaternion reference = LinearSample(tracks[i].rotate, seekTimes[frame]);
+            if (rotate.Dot(reference) < 0.0f) {
+                rotate = rotate * -1.0f;
+            }
+            result.resampledMaxError = std::max(result.resampledMaxError, Difference(rotate, reference));
+            result.resampledMaxError = std::max(result.resampledMaxError, Difference(AnimationResampler::SampleTranslate(resampled.resampled, i, position),
+                                                                                     LinearSample(tracks[i].translate, seekTimes[frame])));
+            result.resampledMaxError = std::max(result.resampledMaxError, Difference(AnimationResampler::SampleScale(resampled.resampled, i, position),
+                                                                                     LinearSample(tracks[i].scale, seekTimes[frame])));
+        }
+    }
+
+    RunSkeleton(tracks, duration, options, result);
+
+    Log("AnimationBenchmark: keys=" + std::to_string(keyCount) + " joints=" + std::to_string(options.joints) +
+        " linear=" + std::to_string(result.linearNanoseconds) + "ns cursor=" + std::to_string(result.cursorNanoseconds) +
+        "ns seek=" + std::to_string(result.seekNanoseconds) + "ns maxError=" + std::to_string(result.maxError) +
+        " allocations/frame=" + std::to_string(result.allocationsPerFrame) + " pose=" + std::to_string(result.poseReferenceNanoseconds) +
+        "ns->" + std::to_string(result.poseSimdNanoseconds) + "ns/joint poseMaxError=" + std::to_string(result.poseMaxError) +
+        " compressed=" + std::to_string(result.rawBytes) + "->" + std::to_string(result.compressedBytes) + "bytes " +
+        std::to_string(result.compressedNanoseconds) + "ns error t=" + std::to_string(result.compressedTranslateError) + " r=" +
+        std::to_string(result.compressedRotateError) + " resampled=" + std::to_string(result.resampledBytes) + "bytes " +
+        std::to_string(result.resampledNanoseconds) + "ns error=" + std::to_string(result.resampledMaxError) +
+        " blend=" + std::to_string(result.blendNanoseconds) + "ns/joint buffers=" + std::to_string(result.blendPoseBuffers) +
+        " characters=" + std::to_string(result.characters) + " " + std::to_string(result.charactersSerialMicroseconds) + "us->" +
+        std::to_string(result.charactersParallelMicroseconds) + "us/frame(" + std::to_string(result.workerThreads) + " workers, allocations/flush=" +
+        std::to_string(result.flushAllocationsPerFrame) + ") lod reduced=" + std::to_string(result.lodReducedMicroseconds) +
+        "us minimum=" + std::to_string(result.lodMinimumMicroseconds) + "us/frame" +
+        " palette=" + std::to_string(result.paletteReferenceNanoseconds) + "ns->" + std::to_string(result.paletteAffineNanoseconds) +
+        "ns(uniform " + std::to_string(result.paletteUniformNanoseconds) + "ns)/joint paletteMaxError=" + std::to_string(result.paletteMaxError) +
+        " (" + std::to_string(sink) + ")\n");
+    return result;
+}
+
+void AnimationBenchmark::RunSkeleton(const std::vector<NodeAnimation> &tracks, float duration, const Options &options, Result &result) {
+    // トラックと同じ数のJointを親子に連ねたスケルトン
+    ModelData modelData;
+    Node *node = &modelData.rootNode;
+    for (uint32_t joint = 0; joint < tracks.size(); ++joint) {
+        node->name = "joint" + std::to_string(joint);
+        node->transform = {{1.0f, 1.0f, 1.0f}, Quaternion(), {0.0f, 0.0f, 0.0f}};
+        node->localMatrix = MakeIdentity4x4();
+        if (joint + 1 < tracks.size()) {
+            node = &node->children.emplace_back();
+        }
+    }
+    auto animation = std::make_shared<Animation>();
+    animation->duration = duration;
+    for (uint32_t joint = 0; joint < tracks.size(); ++joint) {
+        animation->channelNames.push_back("joint" + std::to_string(joint));
+        animation->channels.push_back(tracks[joint]);
+    }
+
+    // 実際のModelAnimation::Updateを通す(パレットはデバイスが要らないようCPU側の配列に書く)
+    ModelAnimation modelAnimation;
+    modelAnimation.SetModelData(modelData);
+    modelAnimation.Initialize(animation, true);
+    Animator &animator = *modelAnimation.GetAnimator();
+
+    // 1フレーム目は結び付けなどの準備を含むので計測しない
+    modelAnimation.Update(true);
+
+    // Frame::DeltaTimeは0のままなので再生位置はこちらで進める
+    float time = 0.0f;
+    AllocationCounter::Begin();
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        time = std::fmod(time + options.deltaTime, duration);
+        animator.SetAnimationTime(time);
+        modelAnimation.Update(true);
+    }
+    size_t allocations = AllocationCounter::End();
+
+    // クロスフェード中 + 半身のレイヤー(同じクリップを時刻をずらして重ねる)
+    AnimationBlender blender;
+    blender.Initialize(modelAnimation.GetSkeletonData());
+    blender.StartCrossfade(animation, duration * 0.5f, true, 1.0e6f);
+    uint32_t layer = blender.AddLayer();
+    blender.SetLayerMask(layer, "joint" + std::to_string(tracks.size() / 2));
+    blender.SetLayerClip(layer, animation, true);
+    blender.SetLayerWeight(layer, 0.5f);
+    // 1フレーム目はバッファを借りるので計測しない
+    modelAnimation.Update(true, &blender);
+
+    AllocationCounter::Begin();
+    auto blendStart = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        time = std::fmod(time + options.deltaTime, duration);
+        animator.SetAnimationTime(time);
+        modelAnimation.Update(true, &blender);
+    }
+    auto blendEnd = std::chrono::steady_clock::now();
+    allocations += AllocationCounter::End();
+    if (options.frames > 0) {
+        // 数えていないビルドでは-1(未計測)
+        result.allocationsPerFrame = AllocationCounter::IsEnabled() ? static_cast<double>(allocations) / (options.frames * 2.0) : -1.0;
+        result.blendNanoseconds = std::chrono::duration<double, std::nano>(blendEnd - blendStart).count() / (static_cast<double>(options.frames) * tracks.size());
+    }
+    result.blendPoseBuffers = blender.GetPoseBufferCount();
+
+    // 姿勢計算: 従来のJointごとのMakeAffineMatrix+行列積と比べる
+    Skeleton skeleton = modelAnimation.GetSkeletonData();
+    const size_t jointCount = skeleton.parents.size();
+    std::vector<Matrix4x4> reference(jointCount);
+    const double jointSteps = static_cast<double>(options.frames) * jointCount;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        for (size_t i = 0; i < jointCount; ++i) {
+            Matrix4x4 local = MakeAffineMatrix(skeleton.localPose.scales[i], skeleton.localPose.rotates[i], skeleton.localPose.translates[i]);
+            reference[i] = skeleton.parents[i] < 0 ? local : local * reference[skeleton.parents[i]];
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.poseReferenceNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / jointSteps;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        Bone::SolvePose(skeleton);
+    }
+    end = std::chrono::steady_clock::now();
+    result.poseSimdNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / jointSteps;
+
+    for (size_t i = 0; i < jointCount; ++i) {
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                float difference = std::abs(reference[i].m[row][column] - skeleton.modelMatrices[i].m[row][column]);
+                // 親を連ねるほど値が大きくなるので相対誤差で見る
+                result.poseMaxError = std::max(result.poseMaxError, difference / std::max(1.0f, std::abs(reference[i].m[row][column])));
+            }
+        }
+    }
+
+    RunPalette(skeleton, options, result);
+    RunCharacters(modelData, animation, options, result);
+}
+
+void AnimationBenchmark::RunCharacters(const ModelData &modelData, const std::shared_ptr<const Animation> &animation, const Options &options,
+                                       Result &result) {
+    if (options.characters == 0 || options.frames == 0) {
+        return;
+    }
+    // 実際のModelAnimation::Updateを使う(パレットはデバイスが要らないようCPU側の配列に書く)
+    const float previousDeltaTime = Frame::DeltaTime();
+    Frame::SetDeltaTime(options.deltaTime);
+    // 合成スケルトンは一本の鎖なので、Minimumでは末端側の1/4を省く
+    AnimationLodSettings lodSettings;
+    lodSettings.isEnabled = true;
+    lodSettings.skipJointHeight = static_cast<int32_t>(std::max(1u, options.joints / 4));
+    std::vector<std::unique_ptr<ModelAnimation>> characters(options.characters);
+    std::vector<AnimationLod> lods(options.characters);
+    for (uint32_t index = 0; index < options.characters; ++index) {
+        characters[index] = std::make_unique<ModelAnimation>();
+        characters[index]->SetModelData(modelData);
+        characters[index]->Initialize(animation, true);
+        // 全員が同じ姿勢にならないよう再生位置をずらす
+        characters[index]->GetAnimator()->SetAnimationTime(animation->duration * static_cast<float>(index) / static_cast<float>(options.characters));
+        lods[index].SetSettings(lodSettings);
+        lods[index].Initialize(characters[index]->GetSkeletonData());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        for (auto &character : characters) {
+            character->Update(true);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.charactersSerialMicroseconds = std::chrono::duration<double, std::micro>(end - start).count() / options.frames;
+
+    // BaseObjectManager::Updateと同じくAnimationUpdateQueueに積んでFlushする
+    AnimationUpdateQueue *queue = AnimationUpdateQueue::GetInstance();
+    auto pushAll = [&]() {
+        queue->Begin();
+        for (auto &character : characters) {
+            queue->Push(character.get(), true, nullptr, nullptr);
+        }
+    };
+    // 1フレーム目は積む配列の確保を含むので計測しない
+    pushAll();
+    queue->Flush();
+    size_t allocations = 0;
+    double microseconds = 0.0;
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        pushAll();
+        AllocationCounter::Begin();
+        start = std::chrono::steady_clock::now();
+        queue->Flush();
+        end = std::chrono::steady_clock::now();
+        allocations += AllocationCounter::End();
+        microseconds += std::chrono::duration<double, std::micro>(end - start).count();
+    }
+    result.charactersParallelMicroseconds = microseconds / options.frames;
+    result.flushAllocationsPerFrame = AllocationCounter::IsEnabled() ? static_cast<double>(allocations) / options.frames : -1.0;
+    result.characters = options.characters;
+    result.workerThreads = ThreadPool::GetInstance()->GetThreadCount();
+
+    // ModelAnimation::UpdateのLODの経路(間引いたフレームだけサンプリングし、間は補間)
+    for (AnimationLodTier tier : {AnimationLodTier::Reduced, AnimationLodTier::Minimum}) {
+        for (uint32_t index = 0; index < options.characters; ++index) {
+            lods[index].SetTier(tier);
+            // 1フレーム目は履歴の取り直し・省いたチャンネルの作成を含むので計測しない
+            characters[index]->Update(true, nullptr, &lods[index]);
+        }
+        start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < options.frames; ++frame) {
+            for (uint32_t index = 0; index < options.characters; ++index) {
+                characters[index]->Update(true, nullptr, &lods[index]);
+            }
+        }
+        end = std::chrono::steady_clock::now();
+        const double tierMicroseconds = std::chrono::duration<double, std::micro>(end - start).count() / options.frames;
+        (tier == AnimationLodTier::Reduced ? result.lodReducedMicroseconds : result.lodMinimumMicroseconds) = tierMicroseconds;
+    }
+    Frame::SetDeltaTime(previousDeltaTime);
+}
+
+void AnimationBenchmark::RunPalette(const Skeleton &skeleton, const Options &options, Result &result) {
+    const size_t jointCount = skeleton.modelMatrices.size();
+    if (jointCount == 0 || options.frames == 0) {
+        return;
+    }
+    // 逆バインド行列: 回転+平行移動に、一般の経路では非等方スケール、等方の経路では等方スケールを乗せる
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+    std::vector<Matrix4x4> inverseBindPoses(jointCount);
+    std::vector<Matrix4x4> uniformModels(jointCount);
+    std::vector<Matrix4x4> uniformInverseBindPoses(jointCount);
+    for (size_t i = 0; i < jointCount; ++i) {
+        Quaternion rotate = Quaternion::FromEulerAngles({angle(random), angle(random), angle(random)}).Normalize();
+        Vector3 translate = {angle(random), angle(random), angle(random)};
+        inverseBindPoses[i] = MakeAffineMatrix({scale(random), scale(random), scale(random)}, rotate, translate);
+        float uniform = scale(random);
+        uniformInverseBindPoses[i] = MakeAffineMatrix({uniform, uniform, uniform}, rotate, translate);
+        uniform = scale(random);
+        uniformModels[i] = MakeAffineMatrix({uniform, uniform, uniform}, rotate.Conjugate(), translate * -0.5f);
+    }
+
+    // 従来の計算(行列積 + Transpose(Inverse))
+    std::vector<WellForGPU> reference(jointCount);
+    const double jointSteps = static_cast<double>(options.frames) * jointCount;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        for (size_t i = 0; i < jointCount; ++i) {
+            reference[i].skeletonSpaceMatrix = inverseBindPoses[i] * skeleton.modelMatrices[i];
+            reference[i].skeletonSpaceInverseTransposeMatrix = Transpose(Inverse(reference[i].skeletonSpaceMatrix));
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    result.paletteReferenceNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / jointSteps;
+
+    std::vector<WellForGPU> palette(jointCount);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        Skin::BuildPalette(inverseBindPoses.data(), skeleton.modelMatrices.data(), jointCount, false, palette.data());
+    }
+    end = std::chrono::steady_clock::now();
+    result.paletteAffineNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / jointSteps;
+
+    std::vector<WellForGPU> uniformPalette(jointCount);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        Skin::BuildPalette(uniformInverseBindPoses.data(), uniformModels.data(), jointCount, true, uniformPalette.data());
+    }
+    end = std::chrono::steady_clock::now();
+    result.paletteUniformNanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / jointSteps;
+
+    // 相対誤差(行列の最大要素で割る)
+    auto compare = [&result](const Matrix4x4 &a, const Matrix4x4 &b) {
+        float magnitude = 1.0f;
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                magnitude = std::max(magnitude, std::abs(a.m[row][column]));
+            }
+        }
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                result.paletteMaxError = std::max(result.paletteMaxError, std::abs(a.m[row][column] - b.m[row][column]) / magnitude);
+            }
+        }
+    };
+    for (size_t i = 0; i < jointCount; ++i) {
+        compare(reference[i].skeletonSpaceMatrix, palette[i].skeletonSpaceMatrix);
+        compare(reference[i].skeletonSpaceInverseTransposeMatrix, palette[i].skeletonSpaceInverseTransposeMatrix);
+        Matrix4x4 uniformReference = uniformInverseBindPoses[i] * uniformModels[i];
+        compare(uniformReference, uniformPalette[i].skeletonSpaceMatrix);
+        compare(Transpose(Inverse(uniformReference)), uniformPalette[i].skeletonSpaceInverseTransposeMatrix);
+    }
+}
+
+void AnimationBenchmark::WriteCsv(const std::vector<Result> &results) {
+    fs::create_directories(kOutputDirectoryPath);
+    std::ofstream csv(kOutputDirectoryPath + "benchmark.csv");
+    if (!csv) {
+        Log("AnimationBenchmark: failed to write csv\n");
+        return;
+    }
+    csv << "keyCount,joints,linearNanoseconds,cursorNanoseconds,seekNanoseconds,maxError,allocationsPerFrame,"
+           "poseReferenceNanoseconds,poseSimdNanoseconds,poseMaxError,"
+           "paletteReferenceNanoseconds,paletteAffineNanoseconds,paletteUniformNanoseconds,paletteMaxError,"
+           "rawBytes,compressedBytes,compressedKeys,compressedNanoseconds,compressedTranslateError,compressedRotateError,"
+           "resampledBytes,resampledNanoseconds,resampledMaxError,blendNanoseconds,blendPoseBuffers,"
+           "characters,workerThreads,charactersSerialMicroseconds,charactersParallelMicroseconds,flushAllocationsPerFrame,"
+           "lodReducedMicroseconds,lodMinimumMicroseconds\n";
+    for (const Result &result : results) {
+        csv << result.keyCount << "," << result.joints << "," << result.linearNanoseconds << "," << result.cursorNanoseconds << ","
+            << result.seekNanoseconds << "," << result.maxError << "," << result.allocationsPerFrame << ","
+            << result.poseReferenceNanoseconds << "," << result.poseSimdNanoseconds << "," << result.poseMaxError << ","
+            << result.paletteReferenceNanoseconds << "," << result.paletteAffineNanoseconds << "," << result.paletteUniformNanoseconds << ","
+            << result.paletteMaxError << "," << result.rawBytes << "," << result.compressedBytes << "," << result.compressedKeys << ","
+            << result.compressedNanoseconds << "," << result.compressedTranslateError << "," << result.compressedRotateError << ","
+            << result.resampledBytes << "," << result.resampledNanoseconds << "," << result.resampledMaxError << ","
+            << result.blendNanoseconds << "," << result.blendPoseBuffers << "," << result.characters << "," << result.workerThreads << ","
+            << result.charactersSerialMicroseconds << "," << result.charactersParallelMicroseconds << "," << result.flushAllocationsPerFrame << ","
+            << result.lodReducedMicroseconds << "," << result.lodMinimumMicroseconds << "\n";
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "Model/ModelStructs.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// キーフレームのサンプリングを計測する(デバイス・モデルファイル不要)
+/// キー数を変えた合成クリップで、先頭からの線形探索・前回位置からの探索・ランダムシークを比べ、
+/// 結果を resources/jsons/AnimationBenchmark/benchmark.csv に書き出す
+/// </summary>
+class AnimationBenchmark {
+  public:
+    // 計測条件
+    struct Options {
+        std::vector<uint32_t> keyCounts = {30, 300, 3000, 30000}; // 1トラックあたりのキー数
+        uint32_t joints = 64;                                      // トラック(Joint)数
+        uint32_t frames = 600;                                     // 計測するフレーム数
+        float deltaTime = 1.0f / 60.0f;
+        float keysPerSecond = 30.0f;
+        float resampleRate = 30.0f; // 一定間隔にサンプリングし直すときの間隔 [Hz]
+        uint32_t characters = 64;   // 並列更新を比べるキャラクター数
+    };
+
+    // 1キー数あたりの結果(時間は1回のサンプリングの平均)
+    struct Result {
+        uint32_t keyCount = 0;
+        uint32_t joints = 0;
+        double linearNanoseconds = 0.0; // 毎回先頭から探す(従来の方式)
+        double cursorNanoseconds = 0.0; // 前回のキー位置から探す
+        double seekNanoseconds = 0.0;   // 毎フレームランダムな時刻(二分探索のみ)
+        float maxError = 0.0f;          // 線形探索との値の差の最大
+        double allocationsPerFrame = 0.0; // ModelAnimation::Update(+ブレンド)1回でのヒープ確保回数(0であること、数えないビルドでは-1)
+        double poseReferenceNanoseconds = 0.0; // 1Jointの姿勢計算(MakeAffineMatrix+行列積)
+        double poseSimdNanoseconds = 0.0;      // 1Jointの姿勢計算(Bone::SolvePose)
+        float poseMaxError = 0.0f;             // 2つの姿勢計算の行列の差の最大
+        double paletteReferenceNanoseconds = 0.0; // 1Jointのパレット計算(行列積+Transpose(Inverse))
+        double paletteAffineNanoseconds = 0.0;    // 1Jointのパレット計算(Skin::BuildPalette、余因子)
+        double paletteUniformNanoseconds = 0.0;   // 1Jointのパレット計算(Skin::BuildPalette、等方スケール)
+        float paletteMaxError = 0.0f;             // 逆転置行列の差の最大(両方の経路)
+        size_t rawBytes = 0;                      // 圧縮前のクリップのキーのメモリ量
+        size_t compressedBytes = 0;               // AnimationCompressionで圧縮した後のメモリ量
+        uint32_t compressedKeys = 0;              // 圧縮後に残ったキー数(全トラック)
+        double compressedNanoseconds = 0.0;       // 圧縮済みトラックからのサンプリング(前回位置から探す)
+        float compressedTranslateError = 0.0f;    // 元のキーとの差の最大(位置)
+        float compressedRotateError = 0.0f;       // 元のキーとのなす角の最大(ラジアン)
+        size_t resampledBytes = 0;                // 一定間隔にサンプリングし直した後のメモリ量
+        double resampledNanoseconds = 0.0;        // サンプリングし直したクリップからのサンプリング(探索なし)
+        float resampledMaxError = 0.0f;           // 線形探索との値の差の最大
+        double blendNanoseconds = 0.0;            // クロスフェード+半身レイヤーのある1フレームの更新(1Jointあたり)
+        uint32_t blendPoseBuffers = 0;            // そのとき確保した姿勢バッファの数(フェードとレイヤーで2)
+        uint32_t characters = 0;                  // 並列更新を比べたキャラクター数
+        double charactersSerialMicroseconds = 0.0;   // 全キャラクターの1フレームの更新(順番に)
+        double charactersParallelMicroseconds = 0.0; // 全キャラクターの1フレームの更新(AnimationUpdateQueue::Flush、1キャラクター=1ジョブ)
+        double flushAllocationsPerFrame = 0.0;       // そのFlush1回でのヒープ確保回数(ワーカー含む。0であること、数えないビルドでは-1)
+        uint32_t workerThreads = 0;                  // 並列更新に使ったワーカースレッド数
+        double lodReducedMicroseconds = 0.0;         // 全キャラクターをAnimationLodのReducedで更新(順番に)
+        double lodMinimumMicroseconds = 0.0;         // 全キャラクターをAnimationLodのMinimumで更新(順番に)
+    };
+
+  public:
+    /// <summary>
+    /// コマンドラインに --animation-bench が含まれるか
+    /// </summary>
+    static bool IsRequested(const std::string &commandLine);
+
+    /// <summary>
+    /// コマンドラインを解釈して実行する(戻り値はプロセスの終了コード、更新中にヒープ確保があれば2、確保回数を数えられないビルドなら3、誤差が許容値を超えれば4)
+    /// --animation-bench [--keys=30,300,3000] [--joints=64] [--frames=600] [--resample=30] [--characters=64]
+    /// </summary>
+    static int RunFromCommandLine(const std::string &commandLine);
+
+    /// <summary>
+    /// 計測の実行
+    /// </summary>
+    static std::vector<Result> Run(const Options &options);
+
+  private:
+    static Result RunClip(uint32_t keyCount, const Options &options);
+    static void RunSkeleton(const std::vector<NodeAnimation> &tracks, float duration, const Options &options, Result &result);
+    static void RunPalette(const Skeleton &skeleton, const Options &options, Result &result);
+    static void RunCharacters(const ModelData &modelData, const std::shared_ptr<const Animation> &animation, const Options &options, Result &result);
+    static void WriteCsv(const std::vector<Result> &results);
+
+    static const std::string kOutputDirectoryPath;
+};
@@ -0,0 +1,231 @@
+#define NOMINMAX
+#include "AnimationBlender.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <myMath.h>
+#include <xmmintrin.h>
+
+namespace {
+static_assert(sizeof(Quaternion) == sizeof(float) * 4, "Quaternion must be 4 packed floats");
+
+// 4成分の内積を全レーンに
+__m128 Dot4(__m128 a, __m128 b) {
+    __m128 product = _mm_mul_ps(a, b);
+    __m128 shuffled = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sum = _mm_add_ps(product, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sum);
+    sum = _mm_add_ss(sum, shuffled);
+    return _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(0, 0, 0, 0));
+}
+} // namespace
+
+void AnimationBlender::Initialize(const Skeleton &skeleton) {
+    jointMap_ = skeleton.jointMap;
+    parents_ = skeleton.parents;
+    bindPose_ = skeleton.localPose;
+    for (const Joint &joint : skeleton.joints) {
+        bindPose_.translates[joint.index] = joint.transform.translate;
+        bindPose_.rotates[joint.index] = joint.transform.rotate;
+        bindPose_.scales[joint.index] = joint.transform.scale;
+    }
+    fadeOut_ = ClipState{};
+    fadeWeight_ = 0.0f;
+    layers_.clear();
+    posePool_.clear();
+    freePoses_.clear();
+}
+
+void AnimationBlender::StartCrossfade(std::shared_ptr<const Animation> from, float time, bool isLoop, float duration) {
+    // フェード中に切り替えた場合は、それまでのフェードを打ち切る(バッファは使い回す)
+    if (!from || duration <= 0.0f) {
+        ReleasePose(fadeOut_);
+        fadeOut_.clip.reset();
+        fadeWeight_ = 0.0f;
+        return;
+    }
+    Bind(fadeOut_, std::move(from), time, isLoop);
+    fadeWeight_ = 1.0f;
+    fadeSpeed_ = 1.0f / duration;
+}
+
+uint32_t AnimationBlender::AddLayer() {
+    Layer &layer = layers_.emplace_back();
+    layer.jointWeights.assign(parents_.size(), 1.0f);
+    return static_cast<uint32_t>(layers_.size() - 1);
+}
+
+void AnimationBlender::SetLayerClip(uint32_t layer, std::shared_ptr<const Animation> clip, bool isLoop) {
+    assert(layer < layers_.size());
+    if (!clip) {
+        ReleasePose(layers_[layer].state);
+        layers_[layer].state.clip.reset();
+        return;
+    }
+    Bind(layers_[layer].state, std::move(clip), 0.0f, isLoop);
+}
+
+void AnimationBlender::SetLayerWeight(uint32_t layer, float weight, float fadeTime) {
+    assert(layer < layers_.size());
+    Layer &target = layers_[layer];
+    target.targetWeight = std::clamp(weight, 0.0f, 1.0f);
+    if (fadeTime <= 0.0f) {
+        target.weight = target.targetWeight;
+        target.weightSpeed = 0.0f;
+    } else {
+        target.weightSpeed = std::abs(target.targetWeight - target.weight) / fadeTime;
+    }
+}
+
+void AnimationBlender::SetLayerMask(uint32_t layer, const std::string &rootJointName) {
+    assert(layer < layers_.size());
+    auto it = jointMap_.find(rootJointName);
+    if (it == jointMap_.end()) {
+        return;
+    }
+    // 親が先に並んでいるので、親がマスク内なら子もマスク内
+    std::vector<float> &jointWeights = layers_[layer].jointWeights;
+    for (size_t joint = 0; joint < jointWeights.size(); ++joint) {
+        const int32_t parent = parents_[joint];
+        const bool isInside = static_cast<int32_t>(joint) == it->second || (parent >= 0 && jointWeights[parent] > 0.0f);
+        jointWeights[joint] = isInside ? 1.0f : 0.0f;
+    }
+}
+
+void AnimationBlender::SetLayerJointWeight(uint32_t layer, const std::string &jointName, float weight) {
+    assert(layer < layers_.size());
+    if (auto it = jointMap_.find(jointName); it != jointMap_.end()) {
+        layers_[layer].jointWeights[it->second] = std::clamp(weight, 0.0f, 1.0f);
+    }
+}
+
+bool AnimationBlender::IsActive() const {
+    if (fadeOut_.clip) {
+        return true;
+    }
+    for (const Layer &layer : layers_) {
+        if (layer.state.clip && (layer.weight > 0.0f || layer.targetWeight > 0.0f)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AnimationBlender::Update(float deltaTime, SkeletonLocalPose &pose) {
+    // フェードアウト中のクリップ(新しいクリップの重みは 1 - fadeWeight_)
+    if (AdvanceFade(deltaTime)) {
+        BlendPoses(pose, Sample(fadeOut_), fadeWeight_, nullptr);
+    }
+
+    // レイヤーを順に重ねる
+    for (Layer &layer : layers_) {
+        if (AdvanceLayer(layer, deltaTime)) {
+            BlendPoses(pose, Sample(layer.state), layer.weight, layer.jointWeights.data());
+        }
+    }
+}
+
+void AnimationBlender::AdvanceTime(float deltaTime) {
+    AdvanceFade(deltaTime);
+    for (Layer &layer : layers_) {
+        AdvanceLayer(layer, deltaTime);
+    }
+}
+
+bool AnimationBlender::AdvanceFade(float deltaTime) {
+    if (!fadeOut_.clip) {
+        return false;
+    }
+    fadeWeight_ -= fadeSpeed_ * deltaTime;
+    if (fadeWeight_ <= 0.0f) {
+        ReleasePose(fadeOut_);
+        fadeOut_.clip.reset();
+        fadeWeight_ = 0.0f;
+        return false;
+    }
+    Advance(fadeOut_, deltaTime);
+    return true;
+}
+
+bool AnimationBlender::AdvanceLayer(Layer &layer, float deltaTime) {
+    if (layer.weightSpeed > 0.0f) {
+        const float step = layer.weightSpeed * deltaTime;
+        layer.weight = layer.weight < layer.targetWeight ? std::min(layer.weight + step, layer.targetWeight)
+                                                         : std::max(layer.weight - step, layer.targetWeight);
+    }
+    if (!layer.state.clip || layer.weight <= 0.0f) {
+        // 重みが0の間はバッファを返しておく
+        ReleasePose(layer.state);
+        return false;
+    }
+    Advance(layer.state, deltaTime);
+    return true;
+}
+
+void AnimationBlender::BlendPoses(SkeletonLocalPose &destination, const SkeletonLocalPose &source, float weight, const float *jointWeights) {
+    const size_t jointCount = destination.rotates.size();
+    assert(source.rotates.size() == jointCount);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    for (size_t joint = 0; joint < jointCount; ++joint) {
+        const float t = jointWeights ? weight * jointWeights[joint] : weight;
+        if (t <= 0.0f) {
+            continue;
+        }
+        destination.translates[joint] = Lerp(destination.translates[joint], source.translates[joint], t);
+        destination.scales[joint] = Lerp(destination.scales[joint], source.scales[joint], t);
+
+        // nlerp(反対の半球ならsourceの符号を反転して近い方を通る)
+        float *rotate = &destination.rotates[joint].x;
+        __m128 q0 = _mm_loadu_ps(rotate);
+        __m128 q1 = _mm_loadu_ps(&source.rotates[joint].x);
+        q1 = _mm_xor_ps(q1, _mm_and_ps(Dot4(q0, q1), signMask));
+        __m128 result = _mm_add_ps(q0, _mm_mul_ps(_mm_sub_ps(q1, q0), _mm_set1_ps(t)));
+        result = _mm_div_ps(result, _mm_sqrt_ps(Dot4(result, result)));
+        _mm_storeu_ps(rotate, result);
+    }
+}
+
+void AnimationBlender::Bind(ClipState &state, std::shared_ptr<const Animation> clip, float time, bool isLoop) {
+    state.clip = std::move(clip);
+    Bone::BindChannels(jointMap_, *state.clip, state.bindings, state.cursors);
+    state.time = time;
+    state.isLoop = isLoop;
+}
+
+void AnimationBlender::Advance(ClipState &state, float deltaTime) const {
+    const float duration = state.clip->duration;
+    state.time += deltaTime;
+    if (duration <= 0.0f) {
+        state.time = 0.0f;
+    } else if (state.isLoop) {
+        state.time = std::fmod(state.time, duration);
+    } else {
+        state.time = std::min(state.time, duration);
+    }
+}
+
+SkeletonLocalPose &AnimationBlender::Sample(ClipState &state) {
+    if (state.poseIndex < 0) {
+        if (!freePoses_.empty()) {
+            state.poseIndex = freePoses_.back();
+            freePoses_.pop_back();
+        } else {
+            state.poseIndex = static_cast<int32_t>(posePool_.size());
+            posePool_.push_back(bindPose_);
+        }
+    }
+    // チャンネルの無いJointは初期姿勢(同じ大きさなのでコピーで確保は起きない)
+    SkeletonLocalPose &pose = posePool_[state.poseIndex];
+    pose.translates = bindPose_.translates;
+    pose.rotates = bindPose_.rotates;
+    pose.scales = bindPose_.scales;
+    Bone::SampleChannels(*state.clip, state.bindings, state.cursors, state.time, pose);
+    return pose;
+}
+
+void AnimationBlender::ReleasePose(ClipState &state) {
+    if (state.poseIndex >= 0) {
+        freePoses_.push_back(state.poseIndex);
+        state.poseIndex = -1;
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include "Bone.h"
+#include "Model/ModelStructs.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 姿勢のブレンド(クロスフェード・レイヤー)
+/// 再生中のクリップをBoneが書き込んだ姿勢に、フェードアウト中のクリップ・上に重ねるレイヤーを順にブレンドする
+/// クリップはプールした姿勢バッファにサンプリングし、追加のバッファは有効なレイヤー(フェード含む)1つにつき1つまで
+/// </summary>
+class AnimationBlender {
+  private:
+    // 1クリップ分の再生状態
+    struct ClipState {
+        std::shared_ptr<const Animation> clip;
+        std::vector<Bone::ChannelBinding> bindings;
+        std::vector<Bone::KeyframeCursor> cursors;
+        float time = 0.0f;
+        bool isLoop = true;
+        int32_t poseIndex = -1; // 借りている姿勢バッファ(-1なら無し)
+    };
+
+    struct Layer {
+        ClipState state;
+        float weight = 0.0f;             // 現在の重み
+        float targetWeight = 0.0f;       // フェード先の重み
+        float weightSpeed = 0.0f;        // 1秒あたりの重みの変化量(0なら即座)
+        std::vector<float> jointWeights; // Jointごとの重み(マスク)
+    };
+
+  public:
+    /// <summary>
+    /// 初期化(スケルトンのJoint名・親子・初期姿勢を写しておく。同じモデルのスケルトンなら共通で使える)
+    /// </summary>
+    void Initialize(const Skeleton &skeleton);
+
+    /// <summary>
+    /// 再生中のクリップからのクロスフェードを始める(fromのクリップをtimeから進めつつ、duration秒で重みを0にする)
+    /// </summary>
+    void StartCrossfade(std::shared_ptr<const Animation> from, float time, bool isLoop, float duration);
+
+    /// <summary>
+    /// レイヤーの追加(戻り値はレイヤー番号。重み0・マスクは全Jointで始まる)
+    /// </summary>
+    uint32_t AddLayer();
+
+    /// <summary>
+    /// レイヤーのクリップを設定する(時刻は0から)
+    /// </summary>
+    void SetLayerClip(uint32_t layer, std::shared_ptr<const Animation> clip, bool isLoop);
+
+    /// <summary>
+    /// レイヤーの重みを設定する(fadeTime秒かけて変える)
+    /// </summary>
+    void SetLayerWeight(uint32_t layer, float weight, float fadeTime = 0.0f);
+
+    /// <summary>
+    /// レイヤーのマスクをrootJointName以下のJointだけにする(見つからなければ変更しない)
+    /// </summary>
+    void SetLayerMask(uint32_t layer, const std::string &rootJointName);
+
+    /// <summary>
+    /// レイヤーのJointごとの重みを設定する
+    /// </summary>
+    void SetLayerJointWeight(uint32_t layer, const std::string &jointName, float weight);
+
+    /// <summary>
+    /// クロスフェード・重みのあるレイヤーがあるか(無ければUpdateは何もしない)
+    /// </summary>
+    bool IsActive() const;
+
+    /// <summary>
+    /// 時間を進めて、poseにフェードアウト中のクリップ・レイヤーを順にブレンドする
+    /// </summary>
+    void Update(float deltaTime, SkeletonLocalPose &pose);
+
+    /// <summary>
+    /// 姿勢はサンプリングせず、フェード・レイヤーの重みと再生時刻だけ進める(画面外で止めている間)
+    /// </summary>
+    void AdvanceTime(float deltaTime);
+
+    /// <summary>
+    /// 2つの姿勢のブレンド(位置・スケールはlerp、回転はnlerp。SSE)
+    /// jointWeightsがnullptrなら全Joint同じweight
+    /// </summary>
+    static void BlendPoses(SkeletonLocalPose &destination, const SkeletonLocalPose &source, float weight, const float *jointWeights);
+
+    /// <summary>
+    /// 確保した姿勢バッファの数(同時に有効だったレイヤー・フェードの最大数)
+    /// </summary>
+    uint32_t GetPoseBufferCount() const { return static_cast<uint32_t>(posePool_.size()); }
+
+    /// <summary>
+    /// ブレンドに使うクリップ(フェードアウト中・レイヤー)ごとにfunctionを呼ぶ
+    /// </summary>
+    template <typename Function>
+    void ForEachClip(Function function) const {
+        if (fadeOut_.clip) {
+            function(*fadeOut_.clip);
+        }
+        for (const Layer &layer : layers_) {
+            if (layer.state.clip) {
+                function(*layer.state.clip);
+            }
+        }
+    }
+
+  private:
+    void Bind(ClipState &state, std::shared_ptr<const Animation> clip, float time, bool isLoop);
+    void Advance(ClipState &state, float deltaTime) const;
+    // 重みと時刻を進め、ブレンドするならtrue
+    bool AdvanceFade(float deltaTime);
+    bool AdvanceLayer(Layer &layer, float deltaTime);
+    SkeletonLocalPose &Sample(ClipState &state);
+    void ReleasePose(ClipState &state);
+
+  private:
+    std::map<std::string, int32_t> jointMap_;
+    std::vector<int32_t> parents_;
+    SkeletonLocalPose bindPose_; // サンプリング前に姿勢バッファを初期化する(チャンネルの無いJoint用)
+
+    ClipState fadeOut_;
+    float fadeWeight_ = 0.0f; // フェードアウト中のクリップの重み
+    float fadeSpeed_ = 0.0f;
+
+    std::vector<Layer> layers_;
+
+    // 姿勢バッファのプール(返されたものは次に借りるときに使い回す)
+    std::vector<SkeletonLocalPose> posePool_;
+    std::vector<int32_t> freePoses_;
+};
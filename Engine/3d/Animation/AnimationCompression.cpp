@@ -0,0 +1,221 @@
+#define NOMINMAX
+#include "AnimationCompression.h"
+#include "Animator.h"
+#include <myMath.h>
+
+namespace {
+// 1区間で確かめるキー数の上限(長いトラックで削除判定がキー数の2乗にならないようにする)
+constexpr uint32_t kMaxSegmentKeys = 256;
+constexpr float kVector3Levels = 65535.0f;
+// 15bitの量子化で増えるなす角の目安(1成分あたり半段 √2/32767/2 が3成分ぶん)
+constexpr float kQuaternionQuantizationError = 1.5e-4f;
+
+float Error(const Vector3 &a, const Vector3 &b) {
+    return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z)});
+}
+
+// 2つの回転のなす角
+float Error(const Quaternion &a, const Quaternion &b) {
+    float dot = std::abs(a.Normalize().Dot(b.Normalize()));
+    return 2.0f * std::acos(std::min(dot, 1.0f));
+}
+
+Vector3 Interpolate(const Vector3 &a, const Vector3 &b, float t) {
+    return Lerp(a, b, t);
+}
+
+Quaternion Interpolate(const Quaternion &a, const Quaternion &b, float t) {
+    return Slerp(a, b, t);
+}
+
+// 前後の残したキーの補間で許容誤差内に収まるキーを削り、残すキーの番号を返す
+template <typename Keyframe>
+std::vector<uint32_t> ReduceKeys(const std::vector<Keyframe> &keyframes, float tolerance) {
+    std::vector<uint32_t> kept;
+    if (keyframes.empty()) {
+        return kept;
+    }
+    kept.push_back(0);
+    const uint32_t count = static_cast<uint32_t>(keyframes.size());
+    // 全体が一定なら1キーにする
+    bool isConstant = true;
+    for (uint32_t i = 1; i < count && isConstant; ++i) {
+        isConstant = Error(keyframes[i].value, keyframes[0].value) <= tolerance;
+    }
+    if (isConstant) {
+        return kept;
+    }
+
+    uint32_t anchor = 0;
+    for (uint32_t end = 2; end < count; ++end) {
+        const float span = keyframes[end].time - keyframes[anchor].time;
+        bool isFit = end - anchor <= kMaxSegmentKeys && span > 0.0f;
+        for (uint32_t i = anchor + 1; isFit && i < end; ++i) {
+            float t = (keyframes[i].time - keyframes[anchor].time) / span;
+            isFit = Error(Interpolate(keyframes[anchor].value, keyframes[end].value, t), keyframes[i].value) <= tolerance;
+        }
+        if (!isFit) {
+            anchor = end - 1;
+            kept.push_back(anchor);
+        }
+    }
+    kept.push_back(count - 1);
+    return kept;
+}
+
+uint16_t Quantize(float value, float minimum, float step) {
+    if (step <= 0.0f) {
+        return 0;
+    }
+    return static_cast<uint16_t>(std::clamp(std::round((value - minimum) / step), 0.0f, kVector3Levels));
+}
+
+CompressedTrackVector3 CompressTrack(const std::vector<KeyframeVector3> &keyframes, float tolerance) {
+    CompressedTrackVector3 track;
+    if (keyframes.empty()) {
+        return track;
+    }
+    // 量子化の範囲は全キーから決め、量子化で増える誤差(半段)をキー削除の許容誤差から差し引く
+    Vector3 minimum = keyframes[0].value;
+    Vector3 maximum = minimum;
+    for (const KeyframeVector3 &keyframe : keyframes) {
+        const Vector3 &value = keyframe.value;
+        minimum = {std::min(minimum.x, value.x), std::min(minimum.y, value.y), std::min(minimum.z, value.z)};
+        maximum = {std::max(maximum.x, value.x), std::max(maximum.y, value.y), std::max(maximum.z, value.z)};
+    }
+    track.minimum = minimum;
+    track.step = {(maximum.x - minimum.x) / kVector3Levels, (maximum.y - minimum.y) / kVector3Levels,
+                  (maximum.z - minimum.z) / kVector3Levels};
+    const float quantizationError = 0.5f * std::max({track.step.x, track.step.y, track.step.z});
+
+    // 範囲が広く16bitの半段が許容誤差を超えるトラックは量子化しない
+    if (quantizationError > tolerance) {
+        const std::vector<uint32_t> kept = ReduceKeys(keyframes, tolerance);
+        track.times.reserve(kept.size());
+        track.rawValues.reserve(kept.size());
+        for (uint32_t index : kept) {
+            track.times.push_back(keyframes[index].time);
+            track.rawValues.push_back(keyframes[index].value);
+        }
+        return track;
+    }
+
+    const std::vector<uint32_t> kept = ReduceKeys(keyframes, tolerance - quantizationError);
+    track.times.reserve(kept.size());
+    track.values.reserve(kept.size());
+    for (uint32_t index : kept) {
+        const Vector3 &value = keyframes[index].value;
+        track.times.push_back(keyframes[index].time);
+        track.values.push_back({Quantize(value.x, minimum.x, track.step.x), Quantize(value.y, minimum.y, track.step.y),
+                                Quantize(value.z, minimum.z, track.step.z)});
+    }
+    return track;
+}
+
+// smallest-three: 絶対値が最大の成分を省き(正になるよう符号をそろえる)、残り3成分を15bitずつにする
+std::array<uint16_t, 3> EncodeQuaternion(const Quaternion &rotate) {
+    Quaternion normalized = rotate.Normalize();
+    const float components[4] = {normalized.x, normalized.y, normalized.z, normalized.w};
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; ++i) {
+        if (std::abs(components[i]) > std::abs(components[largest])) {
+            largest = i;
+        }
+    }
+    const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+    std::array<uint16_t, 3> packed{};
+    for (uint32_t i = 0, slot = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        float normalizedComponent = std::clamp(components[i] * sign / 1.41421356f + 0.5f, 0.0f, 1.0f);
+        packed[slot++] = static_cast<uint16_t>(std::round(normalizedComponent * 32767.0f));
+    }
+    packed[0] |= static_cast<uint16_t>((largest & 1u) << 15);
+    packed[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+    return packed;
+}
+
+CompressedTrackQuaternion CompressTrack(const std::vector<KeyframeQuaternion> &keyframes, float tolerance) {
+    CompressedTrackQuaternion track;
+    // 許容誤差が15bitの量子化誤差より小さければ量子化しない
+    if (kQuaternionQuantizationError > tolerance) {
+        const std::vector<uint32_t> kept = ReduceKeys(keyframes, tolerance);
+        track.times.reserve(kept.size());
+        track.rawValues.reserve(kept.size());
+        for (uint32_t index : kept) {
+            track.times.push_back(keyframes[index].time);
+            track.rawValues.push_back(keyframes[index].value);
+        }
+        return track;
+    }
+
+    const std::vector<uint32_t> kept = ReduceKeys(keyframes, tolerance - kQuaternionQuantizationError);
+    track.times.reserve(kept.size());
+    track.values.reserve(kept.size());
+    for (uint32_t index : kept) {
+        track.times.push_back(keyframes[index].time);
+        track.values.push_back(EncodeQuaternion(keyframes[index].value));
+    }
+    return track;
+}
+
+// 元のキーの時刻で復号した値と比べた誤差の最大
+template <typename Keyframe, typename Track>
+float MeasureError(const std::vector<Keyframe> &keyframes, const Track &track) {
+    float maxError = 0.0f;
+    uint32_t cursor = 0;
+    for (const Keyframe &keyframe : keyframes) {
+        maxError = std::max(maxError, Error(Animator::CalculateValue(track, keyframe.time, cursor), keyframe.value));
+    }
+    return maxError;
+}
+} // namespace
+
+AnimationCompression::Report AnimationCompression::Compress(Animation &animation, const Settings &settings) {
+    Report report;
+    if (!settings.isEnabled || animation.channels.empty()) {
+        return report;
+    }
+    animation.compressedChannels.resize(animation.channels.size());
+    for (size_t channelIndex = 0; channelIndex < animation.channels.size(); ++channelIndex) {
+        const NodeAnimation &channel = animation.channels[channelIndex];
+        Tolerance tolerance = settings.tolerance;
+        if (auto it = settings.jointTolerances.find(animation.channelNames[channelIndex]); it != settings.jointTolerances.end()) {
+            tolerance = it->second;
+        }
+
+        CompressedNodeAnimation &compressed = animation.compressedChannels[channelIndex];
+        compressed.translate = CompressTrack(channel.translate, tolerance.translate);
+        compressed.rotate = CompressTrack(channel.rotate, tolerance.rotate);
+        compressed.scale = CompressTrack(channel.scale, tolerance.scale);
+
+        report.rawKeys += static_cast<uint32_t>(channel.translate.size() + channel.rotate.size() + channel.scale.size());
+        report.compressedKeys += static_cast<uint32_t>(compressed.translate.times.size() + compressed.rotate.times.size() +
+                                                       compressed.scale.times.size());
+        report.rawBytes += sizeof(KeyframeVector3) * (channel.translate.size() + channel.scale.size()) +
+                           sizeof(KeyframeQuaternion) * channel.rotate.size();
+        report.compressedBytes += GetByteSize(compressed);
+        if (!channel.translate.empty()) {
+            report.maxTranslateError = std::max(report.maxTranslateError, MeasureError(channel.translate, compressed.translate));
+        }
+        if (!channel.rotate.empty()) {
+            report.maxRotateError = std::max(report.maxRotateError, MeasureError(channel.rotate, compressed.rotate));
+        }
+        if (!channel.scale.empty()) {
+            report.maxScaleError = std::max(report.maxScaleError, MeasureError(channel.scale, compressed.scale));
+        }
+    }
+    // 元のキーは以降使わない
+    animation.channels.clear();
+    animation.channels.shrink_to_fit();
+    return report;
+}
+
+size_t AnimationCompression::GetByteSize(const CompressedNodeAnimation &channel) {
+    auto trackSize = [](const auto &track) {
+        return track.times.size() * sizeof(float) + track.values.size() * sizeof(std::array<uint16_t, 3>) +
+               track.rawValues.size() * sizeof(track.rawValues[0]);
+    };
+    return trackSize(channel.translate) + trackSize(channel.rotate) + trackSize(channel.scale) + sizeof(Vector3) * 4;
+}
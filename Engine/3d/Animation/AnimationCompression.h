@@ -0,0 +1,95 @@
+#pragma once
+#include "Model/ModelStructs.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/// <summary>
+/// アニメーションクリップの圧縮(読み込み時に1回)
+/// 許容誤差内で補間できるキーを削り、回転はsmallest-three 48bit、位置・スケールはトラックの範囲で16bitに量子化する
+/// 量子化の誤差だけで許容誤差を超えるトラックは量子化せず、キーの削除だけ行う
+/// 既定では無効(resources/jsons/Animation/compression.json かAnimationLibrary::SetCompressionSettingsで有効にする)
+/// </summary>
+class AnimationCompression {
+  public:
+    // 許容誤差(位置・スケールは成分ごとの差、回転はラジアン)
+    struct Tolerance {
+        float translate = 1.0e-4f;
+        float rotate = 1.0e-3f;
+        float scale = 1.0e-4f;
+    };
+
+    struct Settings {
+        bool isEnabled = false;
+        Tolerance tolerance;                                          // 既定の許容誤差
+        std::unordered_map<std::string, Tolerance> jointTolerances; // Joint(チャンネル名)ごとの許容誤差
+    };
+
+    // 圧縮の結果(誤差は元のキーの時刻で、復号して補間した値と比べたもの)
+    struct Report {
+        size_t rawBytes = 0;
+        size_t compressedBytes = 0;
+        uint32_t rawKeys = 0;
+        uint32_t compressedKeys = 0;
+        float maxTranslateError = 0.0f;
+        float maxRotateError = 0.0f;
+        float maxScaleError = 0.0f;
+    };
+
+  public:
+    /// <summary>
+    /// channelsを圧縮してcompressedChannelsに置き換える(channelsは解放する)
+    /// </summary>
+    /// <param name="animation"></param>
+    /// <param name="settings"></param>
+    /// <returns></returns>
+    static Report Compress(Animation &animation, const Settings &settings);
+
+    /// <summary>
+    /// 1キーの復号(Vector3)
+    /// </summary>
+    static Vector3 Decode(const CompressedTrackVector3 &track, uint32_t index) {
+        if (!track.rawValues.empty()) {
+            return track.rawValues[index];
+        }
+        const std::array<uint16_t, 3> &value = track.values[index];
+        return {track.minimum.x + track.step.x * value[0], track.minimum.y + track.step.y * value[1],
+                track.minimum.z + track.step.z * value[2]};
+    }
+
+    /// <summary>
+    /// 1キーの復号(Quaternion)
+    /// 先頭2つの最上位bitに省いた成分の位置、残り15bitずつに3成分が入っている
+    /// </summary>
+    static Quaternion Decode(const CompressedTrackQuaternion &track, uint32_t index) {
+        if (!track.rawValues.empty()) {
+            return track.rawValues[index];
+        }
+        const std::array<uint16_t, 3> &value = track.values[index];
+        const uint32_t largest = (value[0] >> 15) | ((value[1] >> 15) << 1);
+        float components[4];
+        float sum = 0.0f;
+        for (uint32_t i = 0, packed = 0; i < 4; ++i) {
+            if (i == largest) {
+                continue;
+            }
+            float component = (static_cast<float>(value[packed++] & kQuaternionMask) * (1.0f / kQuaternionMask) - 0.5f) * kQuaternionRange;
+            components[i] = component;
+            sum += component * component;
+        }
+        components[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+        return Quaternion(components[0], components[1], components[2], components[3]);
+    }
+
+    /// <summary>
+    /// 圧縮後のメモリ量
+    /// </summary>
+    static size_t GetByteSize(const CompressedNodeAnimation &channel);
+
+  private:
+    static constexpr uint16_t kQuaternionMask = 0x7fff;
+    // 最大の成分を除いた3成分は[-1/√2, 1/√2]に収まる
+    static constexpr float kQuaternionRange = 1.41421356f;
+};
@@ -0,0 +1,175 @@
+#define NOMINMAX
+#include "AnimationLibrary.h"
+#include "AnimationResampler.h"
+#include "Data/DataHandler.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+using namespace Logger;
+
+AnimationLibrary *AnimationLibrary::instance = nullptr;
+
+namespace {
+// 書かれていない項目はbaseのまま
+AnimationCompression::Tolerance ReadTolerance(const json &data, const AnimationCompression::Tolerance &base) {
+    AnimationCompression::Tolerance tolerance = base;
+    tolerance.translate = data.value("translate", base.translate);
+    tolerance.rotate = data.value("rotate", base.rotate);
+    tolerance.scale = data.value("scale", base.scale);
+    return tolerance;
+}
+} // namespace
+
+AnimationLibrary *AnimationLibrary::GetInstance() {
+    if (instance == nullptr) {
+        instance = new AnimationLibrary();
+    }
+    return instance;
+}
+
+void AnimationLibrary::Finalize() {
+    delete instance;
+    instance = nullptr;
+}
+
+void AnimationLibrary::LoadCompressionSettings() {
+    json data = DataHandler("Animation", "compression").LoadAll();
+    AnimationCompression::Settings settings;
+    settings.isEnabled = data.value("isEnabled", false);
+    settings.tolerance = ReadTolerance(data, settings.tolerance);
+    if (auto joints = data.find("joints"); joints != data.end() && joints->is_object()) {
+        for (const auto &[jointName, jointData] : joints->items()) {
+            settings.jointTolerances[jointName] = ReadTolerance(jointData, settings.tolerance);
+        }
+    }
+    compressionSettings_ = settings;
+}
+
+AnimationClipHandle AnimationLibrary::Find(const std::string &directoryPath, const std::string &filename, const std::string &clipName) {
+    AnimationClipHandle handle;
+    const uint32_t fileIndex = LoadFile(directoryPath, filename);
+    const AnimationFile &file = files_[fileIndex];
+    if (file.clips.empty()) {
+        return handle;
+    }
+    if (clipName.empty()) {
+        handle.file = fileIndex;
+        handle.clip = 0;
+        return handle;
+    }
+    auto it = std::find(file.clipNames.begin(), file.clipNames.end(), clipName);
+    if (it == file.clipNames.end()) {
+        Log("AnimationLibrary: clip " + clipName + " not found in " + filename + "\n");
+        return handle;
+    }
+    handle.file = fileIndex;
+    handle.clip = static_cast<uint32_t>(it - file.clipNames.begin());
+    return handle;
+}
+
+std::shared_ptr<const Animation> AnimationLibrary::GetClip(const AnimationClipHandle &handle) const {
+    if (!handle.IsValid() || handle.file >= files_.size() || handle.clip >= files_[handle.file].clips.size()) {
+        return nullptr;
+    }
+    return files_[handle.file].clips[handle.clip];
+}
+
+const std::vector<std::string> &AnimationLibrary::GetClipNames(const std::string &directoryPath, const std::string &filename) {
+    return files_[LoadFile(directoryPath, filename)].clipNames;
+}
+
+uint32_t AnimationLibrary::LoadFile(const std::string &directoryPath, const std::string &filename) {
+    // 読み込み済みならファイルを開かない
+    const std::string filePath = directoryPath + "/" + filename;
+    if (auto it = fileIndices_.find(filePath); it != fileIndices_.end()) {
+        return it->second;
+    }
+
+    const uint32_t fileIndex = static_cast<uint32_t>(files_.size());
+    AnimationFile &file = files_.emplace_back();
+    fileIndices_.emplace(filePath, fileIndex);
+
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(filePath.c_str(), 0);
+    if (!scene) {
+        return fileIndex; // アニメーションなし
+    }
+    // 1回の読み込みで全クリップを取り込む
+    for (uint32_t animationIndex = 0; animationIndex < scene->mNumAnimations; ++animationIndex) {
+        const aiAnimation &animationAssimp = *scene->mAnimations[animationIndex];
+        // 名前の無いクリップは番号で呼ぶ
+        std::string clipName = animationAssimp.mName.length > 0 ? animationAssimp.mName.C_Str() : std::to_string(animationIndex);
+        file.clips.push_back(ImportClip(animationAssimp, filename, clipName));
+        file.clipNames.push_back(std::move(clipName));
+    }
+    return fileIndex;
+}
+
+std::shared_ptr<const Animation> AnimationLibrary::ImportClip(const aiAnimation &animationAssimp, const std::string &filename,
+                                                              const std::string &clipName) const {
+    auto animation = std::make_shared<Animation>();
+    animation->duration = float(animationAssimp.mDuration / animationAssimp.mTicksPerSecond);
+
+    // ノードアニメーションの読み込み
+    for (uint32_t channelIndex = 0; channelIndex < animationAssimp.mNumChannels; ++channelIndex) {
+        const aiNodeAnim *nodeAnimationAssimp = animationAssimp.mChannels[channelIndex];
+        animation->channelNames.push_back(nodeAnimationAssimp->mNodeName.C_Str());
+        NodeAnimation &nodeAnimation = animation->channels.emplace_back();
+
+        // Position
+        nodeAnimation.translate.reserve(nodeAnimationAssimp->mNumPositionKeys);
+        for (uint32_t keyIndex = 0; keyIndex < nodeAnimationAssimp->mNumPositionKeys; ++keyIndex) {
+            const aiVectorKey &keyAssimp = nodeAnimationAssimp->mPositionKeys[keyIndex];
+            KeyframeVector3 keyframe;
+            keyframe.time = float(keyAssimp.mTime / animationAssimp.mTicksPerSecond);
+            keyframe.value = {-keyAssimp.mValue.x, keyAssimp.mValue.y, keyAssimp.mValue.z};
+            nodeAnimation.translate.push_back(keyframe);
+        }
+
+        // Rotation
+        nodeAnimation.rotate.reserve(nodeAnimationAssimp->mNumRotationKeys);
+        for (uint32_t keyIndex = 0; keyIndex < nodeAnimationAssimp->mNumRotationKeys; ++keyIndex) {
+            const aiQuatKey &keyAssimp = nodeAnimationAssimp->mRotationKeys[keyIndex];
+            KeyframeQuaternion keyframe;
+            keyframe.time = float(keyAssimp.mTime / animationAssimp.mTicksPerSecond);
+            keyframe.value = {keyAssimp.mValue.x, -keyAssimp.mValue.y, -keyAssimp.mValue.z, keyAssimp.mValue.w};
+            nodeAnimation.rotate.push_back(keyframe);
+        }
+
+        // Scale
+        nodeAnimation.scale.reserve(nodeAnimationAssimp->mNumScalingKeys);
+        for (uint32_t keyIndex = 0; keyIndex < nodeAnimationAssimp->mNumScalingKeys; ++keyIndex) {
+            const aiVectorKey &keyAssimp = nodeAnimationAssimp->mScalingKeys[keyIndex];
+            KeyframeVector3 keyframe;
+            keyframe.time = float(keyAssimp.mTime / animationAssimp.mTicksPerSecond);
+            keyframe.value = {keyAssimp.mValue.x, keyAssimp.mValue.y, keyAssimp.mValue.z};
+            nodeAnimation.scale.push_back(keyframe);
+        }
+    }
+
+    // 読み込み時に1回だけ、サンプリングし直すか圧縮する(クリップ名の指定がファイル全体の指定より優先)
+    const std::string clipPath = filename + "/" + clipName;
+    auto rate = resampleRates_.find({filename, clipName});
+    if (rate == resampleRates_.end()) {
+        rate = resampleRates_.find({filename, ""});
+    }
+    if (rate != resampleRates_.end()) {
+        AnimationResampler::Resample(*animation, rate->second);
+        Log("AnimationLibrary: resampled " + clipPath + " at " + std::to_string(animation->resampled.framesPerSecond) + "Hz frames " +
+            std::to_string(animation->resampled.frameCount) + " bytes " + std::to_string(AnimationResampler::GetByteSize(animation->resampled)) +
+            "\n");
+    } else if (compressionSettings_.isEnabled) {
+        AnimationCompression::Report report = AnimationCompression::Compress(*animation, compressionSettings_);
+        if (report.rawBytes > 0) {
+            Log("AnimationLibrary: compressed " + clipPath + " keys " + std::to_string(report.rawKeys) + "->" +
+                std::to_string(report.compressedKeys) + " bytes " + std::to_string(report.rawBytes) + "->" +
+                std::to_string(report.compressedBytes) + " (saved " +
+                std::to_string(report.rawBytes - std::min(report.rawBytes, report.compressedBytes)) + ") maxError t=" +
+                std::to_string(report.maxTranslateError) + " r=" + std::to_string(report.maxRotateError) + " s=" +
+                std::to_string(report.maxScaleError) + "\n");
+        }
+    }
+    return animation;
+}
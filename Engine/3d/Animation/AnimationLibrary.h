@@ -0,0 +1,101 @@
+#pragma once
+#include "AnimationCompression.h"
+#include "Model/ModelStructs.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct aiAnimation;
+
+/// <summary>
+/// 読み込み済みクリップの参照((ファイル, クリップ名)を解決したもの)
+/// </summary>
+struct AnimationClipHandle {
+    static constexpr uint32_t kInvalid = UINT32_MAX;
+    uint32_t file = kInvalid;
+    uint32_t clip = kInvalid;
+    bool IsValid() const { return file != kInvalid && clip != kInvalid; }
+};
+
+/// <summary>
+/// アニメーションクリップのキャッシュ
+/// ファイルは1回だけ読み込んで全クリップを取り込み、以降は(ファイル, クリップ名)で共有する
+/// </summary>
+class AnimationLibrary {
+  private:
+    static AnimationLibrary *instance;
+    AnimationLibrary() = default;
+    ~AnimationLibrary() = default;
+    AnimationLibrary(AnimationLibrary &) = delete;
+    AnimationLibrary &operator=(AnimationLibrary &) = delete;
+
+    // 1ファイル分のクリップ(アニメーションが無いファイルも空で登録し、読み直さない)
+    struct AnimationFile {
+        std::vector<std::string> clipNames;
+        std::vector<std::shared_ptr<const Animation>> clips; // clipNamesと同じ並び
+    };
+
+  public:
+    /// <summary>
+    /// シングルトンインスタンスの取得
+    /// </summary>
+    static AnimationLibrary *GetInstance();
+
+    /// <summary>
+    /// 終了
+    /// </summary>
+    void Finalize();
+
+    /// <summary>
+    /// クリップの検索(ファイルが未読み込みならここで1回だけ読む)
+    /// clipNameが空ならファイルの最初のクリップ
+    /// </summary>
+    /// <param name="directoryPath"></param>
+    /// <param name="filename"></param>
+    /// <param name="clipName"></param>
+    /// <returns>見つからなければ無効なハンドル</returns>
+    AnimationClipHandle Find(const std::string &directoryPath, const std::string &filename, const std::string &clipName = "");
+
+    /// <summary>
+    /// クリップの取得(無効なハンドルならnullptr)
+    /// </summary>
+    std::shared_ptr<const Animation> GetClip(const AnimationClipHandle &handle) const;
+
+    /// <summary>
+    /// ファイルに含まれるクリップ名(未読み込みならここで読む)
+    /// </summary>
+    const std::vector<std::string> &GetClipNames(const std::string &directoryPath, const std::string &filename);
+
+    /// <summary>
+    /// 以降に読み込むクリップの圧縮設定(読み込み済みのクリップには影響しない)
+    /// </summary>
+    void SetCompressionSettings(const AnimationCompression::Settings &settings) { compressionSettings_ = settings; }
+
+    /// <summary>
+    /// 圧縮設定を resources/jsons/Animation/compression.json から読む(Framework::Initializeで呼ぶ。ファイルが無ければ無効のまま)
+    /// {"isEnabled": true, "translate": 1e-4, "rotate": 1e-3, "scale": 1e-4, "joints": {"Joint名": {"rotate": 1e-4}}}
+    /// </summary>
+    void LoadCompressionSettings();
+
+    /// <summary>
+    /// クリップを一定間隔(sampleRate [Hz])にサンプリングし直して読み込むよう指定する(圧縮の代わり。読み込み前に呼ぶ)
+    /// メモリは増えるが探索なしでサンプリングできるので、処理の重いキャラクター向け。clipNameが空ならファイルの全クリップ
+    /// </summary>
+    void SetResampleRate(const std::string &filename, float sampleRate, const std::string &clipName = "") {
+        resampleRates_[{filename, clipName}] = sampleRate;
+    }
+
+  private:
+    uint32_t LoadFile(const std::string &directoryPath, const std::string &filename);
+    std::shared_ptr<const Animation> ImportClip(const aiAnimation &animationAssimp, const std::string &filename, const std::string &clipName) const;
+
+  private:
+    std::unordered_map<std::string, uint32_t> fileIndices_; // ファイルパス → files_の番号
+    std::vector<AnimationFile> files_;
+    AnimationCompression::Settings compressionSettings_;
+    std::map<std::pair<std::string, std::string>, float> resampleRates_; // (ファイル名, クリップ名) → Hz
+};
@@ -0,0 +1,120 @@
+#define NOMINMAX
+#include "AnimationLod.h"
+#include "AnimationBlender.h"
+#include "ViewProjection/ViewProjection.h"
+#include <algorithm>
+#include <cmath>
+#include <myMath.h>
+
+void AnimationLod::Initialize(const Skeleton &skeleton) {
+    // 初期姿勢のJoint位置を囲む球(メッシュは少しはみ出すが、閾値はモデルごとに合わせる)
+    Vector3 minimum = {0.0f, 0.0f, 0.0f};
+    Vector3 maximum = {0.0f, 0.0f, 0.0f};
+    for (size_t joint = 0; joint < skeleton.modelMatrices.size(); ++joint) {
+        const Matrix4x4 &matrix = skeleton.modelMatrices[joint];
+        const Vector3 position = {matrix.m[3][0], matrix.m[3][1], matrix.m[3][2]};
+        minimum = joint == 0 ? position : Vector3{std::min(minimum.x, position.x), std::min(minimum.y, position.y), std::min(minimum.z, position.z)};
+        maximum = joint == 0 ? position : Vector3{std::max(maximum.x, position.x), std::max(maximum.y, position.y), std::max(maximum.z, position.z)};
+    }
+    boundsCenter_ = (minimum + maximum) * 0.5f;
+    boundsRadius_ = std::max((maximum - minimum).Length() * 0.5f, 0.1f);
+
+    // 履歴は同じ大きさで確保しておき、以降はコピーだけ
+    poses_[0] = skeleton.localPose;
+    poses_[1] = skeleton.localPose;
+    latest_ = 0;
+    hasHistory_ = false;
+    tier_ = AnimationLodTier::Full;
+    coverage_ = 1.0f;
+    framesSinceSample_ = 0;
+    pendingDeltaTime_ = 0.0f;
+}
+
+void AnimationLod::Select(const Matrix4x4 &worldMatrix, const ViewProjection &viewProjection) {
+    AnimationLodTier tier = AnimationLodTier::Full;
+    if (settings_.isEnabled) {
+        // ワールド行列の行の長さの最大を等方スケールとみなす
+        const float scale = std::max({Vector3{worldMatrix.m[0][0], worldMatrix.m[0][1], worldMatrix.m[0][2]}.Length(),
+                                      Vector3{worldMatrix.m[1][0], worldMatrix.m[1][1], worldMatrix.m[1][2]}.Length(),
+                                      Vector3{worldMatrix.m[2][0], worldMatrix.m[2][1], worldMatrix.m[2][2]}.Length()});
+        const float radius = (settings_.radius > 0.0f ? settings_.radius : boundsRadius_) * scale;
+        coverage_ = CalculateCoverage(Transformation(boundsCenter_, worldMatrix), radius, viewProjection);
+        if (coverage_ < 0.0f) {
+            tier = AnimationLodTier::Frozen;
+        } else if (coverage_ < settings_.minimumCoverage) {
+            tier = AnimationLodTier::Minimum;
+        } else if (coverage_ < settings_.reducedCoverage) {
+            tier = AnimationLodTier::Reduced;
+        }
+    } else {
+        coverage_ = 1.0f;
+    }
+    SetTier(tier);
+}
+
+void AnimationLod::SetTier(AnimationLodTier tier) {
+    tier_ = tier;
+    if (tier_ == AnimationLodTier::Reduced) {
+        interval_ = std::max(settings_.reducedInterval, 1);
+    } else if (tier_ == AnimationLodTier::Minimum) {
+        interval_ = std::max(settings_.minimumInterval, 1);
+    } else {
+        // 間引かない間の姿勢は履歴に入らないので、次に間引くときは取り直す
+        hasHistory_ = false;
+        pendingDeltaTime_ = 0.0f;
+    }
+}
+
+float AnimationLod::CalculateCoverage(const Vector3 &center, float radius, const ViewProjection &viewProjection) {
+    const Vector3 view = Transformation(center, viewProjection.matView_);
+    // カメラの後ろ・farより奥
+    if (view.z + radius < viewProjection.nearZ || view.z - radius > viewProjection.farZ) {
+        return -1.0f;
+    }
+    // 左右・上下の面(x * m[0][0] = ±z、y * m[1][1] = ±z)からはみ出しているか
+    const float xScale = viewProjection.matProjection_.m[0][0];
+    const float yScale = viewProjection.matProjection_.m[1][1];
+    if (std::abs(view.x) * xScale - view.z > radius * std::sqrt(xScale * xScale + 1.0f) ||
+        std::abs(view.y) * yScale - view.z > radius * std::sqrt(yScale * yScale + 1.0f)) {
+        return -1.0f;
+    }
+    // 射影後の直径 / 画面の高さ(2)
+    return radius * yScale / std::max(view.z, viewProjection.nearZ);
+}
+
+bool AnimationLod::Advance(float deltaTime, float &sampleDeltaTime) {
+    pendingDeltaTime_ += deltaTime;
+    if (hasHistory_ && ++framesSinceSample_ < interval_) {
+        return false;
+    }
+    framesSinceSample_ = 0;
+    sampleDeltaTime = pendingDeltaTime_;
+    pendingDeltaTime_ = 0.0f;
+    return true;
+}
+
+void AnimationLod::StorePose(const SkeletonLocalPose &pose) {
+    if (!hasHistory_) {
+        poses_[0] = pose;
+        poses_[1] = pose;
+        latest_ = 0;
+        hasHistory_ = true;
+        return;
+    }
+    latest_ ^= 1;
+    poses_[latest_] = pose;
+}
+
+void AnimationLod::Interpolate(SkeletonLocalPose &pose) const {
+    if (!hasHistory_) {
+        return;
+    }
+    // 1つ前のサンプルから最新のサンプルへ、次のサンプリングでちょうど最新に着くよう進める
+    const float t = static_cast<float>(framesSinceSample_ + 1) / static_cast<float>(interval_);
+    pose = poses_[latest_ ^ 1];
+    AnimationBlender::BlendPoses(pose, poses_[latest_], t, nullptr);
+}
+
+uint32_t AnimationLod::GetSkipJointHeight() const {
+    return tier_ == AnimationLodTier::Minimum ? static_cast<uint32_t>(std::max(settings_.skipJointHeight, 0)) : 0u;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "Model/ModelStructs.h"
+#include "type/Matrix4x4.h"
+#include "type/Vector3.h"
+#include <cstdint>
+
+class ViewProjection;
+
+/// <summary>
+/// アニメーションのLODの段階
+/// </summary>
+enum class AnimationLodTier {
+    Full,    // 毎フレーム全Jointをサンプリング
+    Reduced, // 間引いてサンプリングし、間は直近2つの姿勢を補間
+    Minimum, // さらに間引き、末端のJoint(指・顔など)のチャンネルも省く
+    Frozen,  // 画面外。時間だけ進めて姿勢は止める
+};
+
+/// <summary>
+/// アニメーションのLODの設定(モデルごと。BaseObjectのJSONに保存する)
+/// 大きさは画面の高さに対する、スケルトンを囲む球の直径の割合
+/// </summary>
+struct AnimationLodSettings {
+    bool isEnabled = false;
+    float reducedCoverage = 0.25f; // これ未満でReduced
+    float minimumCoverage = 0.08f; // これ未満でMinimum
+    int32_t reducedInterval = 2;   // Reducedで何フレームに1回サンプリングするか
+    int32_t minimumInterval = 4;   // Minimumで何フレームに1回サンプリングするか
+    int32_t skipJointHeight = 1;   // Minimumで省くJointの、末端からの高さ(1なら末端だけ、2なら末端とその親)
+    float radius = 0.0f;           // 囲む球の半径(0ならスケルトンの初期姿勢から求める)
+};
+
+/// <summary>
+/// アニメーションのLOD
+/// Selectでカメラから段階を選び(メインスレッド)、ModelAnimation::Updateが段階に応じて間引く(ワーカースレッド)
+/// </summary>
+class AnimationLod {
+  public:
+    /// <summary>
+    /// 初期化(スケルトンを囲む球と姿勢の履歴を用意する。設定はそのまま)
+    /// </summary>
+    void Initialize(const Skeleton &skeleton);
+
+    void SetSettings(const AnimationLodSettings &settings) { settings_ = settings; }
+    const AnimationLodSettings &GetSettings() const { return settings_; }
+
+    /// <summary>
+    /// 画面上の大きさから段階を選ぶ
+    /// </summary>
+    /// <param name="worldMatrix">オブジェクトのワールド行列</param>
+    /// <param name="viewProjection"></param>
+    void Select(const Matrix4x4 &worldMatrix, const ViewProjection &viewProjection);
+
+    /// <summary>
+    /// 段階を直接指定する(演出中に固定する場合など。次のSelectで選び直される)
+    /// </summary>
+    void SetTier(AnimationLodTier tier);
+
+    /// <summary>
+    /// 球の画面上の大きさ(画面の高さに対する直径の割合。視錐台の外なら負)
+    /// </summary>
+    static float CalculateCoverage(const Vector3 &center, float radius, const ViewProjection &viewProjection);
+
+    /// <summary>
+    /// 時間を進め、このフレームでサンプリングするかを返す(ReducedとMinimumのみ)
+    /// </summary>
+    /// <param name="deltaTime"></param>
+    /// <param name="sampleDeltaTime">前回サンプリングしてからの時間(ブレンドを進める分)</param>
+    bool Advance(float deltaTime, float &sampleDeltaTime);
+
+    /// <summary>
+    /// サンプリングした姿勢を履歴に入れる
+    /// </summary>
+    void StorePose(const SkeletonLocalPose &pose);
+
+    /// <summary>
+    /// 直近2つの姿勢を、次のサンプリングまでの進み具合で補間してposeに書き込む
+    /// </summary>
+    void Interpolate(SkeletonLocalPose &pose) const;
+
+    /// <summary>
+    /// サンプリングで省くJointの末端からの高さ(0なら省かない)
+    /// </summary>
+    uint32_t GetSkipJointHeight() const;
+
+    AnimationLodTier GetTier() const { return tier_; }
+    float GetCoverage() const { return coverage_; }
+
+  private:
+    AnimationLodSettings settings_;
+    AnimationLodTier tier_ = AnimationLodTier::Full;
+    float coverage_ = 1.0f;
+
+    // スケルトン空間で初期姿勢を囲む球
+    Vector3 boundsCenter_ = {0.0f, 0.0f, 0.0f};
+    float boundsRadius_ = 1.0f;
+
+    // 姿勢の履歴(poses_[latest_]が最新)
+    SkeletonLocalPose poses_[2];
+    int32_t latest_ = 0;
+    bool hasHistory_ = false;
+    int32_t interval_ = 1;
+    int32_t framesSinceSample_ = 0;
+    float pendingDeltaTime_ = 0.0f;
+};
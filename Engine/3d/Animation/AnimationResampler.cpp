@@ -0,0 +1,41 @@
+#define NOMINMAX
+#include "AnimationResampler.h"
+#include "Animator.h"
+
+void AnimationResampler::Resample(Animation &animation, float sampleRate) {
+    if (animation.channels.empty() || sampleRate <= 0.0f) {
+        return;
+    }
+    // 最後のフレームがちょうどdurationに来るよう、間隔はsampleRate以上で等分にする
+    ResampledAnimation &resampled = animation.resampled;
+    resampled.frameCount = std::max(2u, static_cast<uint32_t>(std::ceil(animation.duration * sampleRate)) + 1);
+    resampled.framesPerSecond = animation.duration > 0.0f ? static_cast<float>(resampled.frameCount - 1) / animation.duration : 0.0f;
+
+    const size_t channelCount = animation.channels.size();
+    resampled.translates.resize(channelCount * resampled.frameCount);
+    resampled.rotates.resize(channelCount * resampled.frameCount);
+    resampled.scales.resize(channelCount * resampled.frameCount);
+    for (size_t channel = 0; channel < channelCount; ++channel) {
+        const NodeAnimation &nodeAnimation = animation.channels[channel];
+        const size_t offset = channel * resampled.frameCount;
+        // 時刻は増える一方なのでカーソルで順に進める
+        uint32_t translateCursor = 0;
+        uint32_t rotateCursor = 0;
+        uint32_t scaleCursor = 0;
+        for (uint32_t frame = 0; frame < resampled.frameCount; ++frame) {
+            const float time = resampled.framesPerSecond > 0.0f ? static_cast<float>(frame) / resampled.framesPerSecond : 0.0f;
+            resampled.translates[offset + frame] =
+                nodeAnimation.translate.empty() ? Vector3{} : Animator::CalculateValue(nodeAnimation.translate, time, translateCursor);
+            resampled.scales[offset + frame] =
+                nodeAnimation.scale.empty() ? Vector3{1.0f, 1.0f, 1.0f} : Animator::CalculateValue(nodeAnimation.scale, time, scaleCursor);
+            Quaternion rotate = nodeAnimation.rotate.empty() ? Quaternion() : Animator::CalculateValue(nodeAnimation.rotate, time, rotateCursor);
+            if (frame > 0 && rotate.Dot(resampled.rotates[offset + frame - 1]) < 0.0f) {
+                rotate = rotate * -1.0f;
+            }
+            resampled.rotates[offset + frame] = rotate;
+        }
+    }
+    // 元のキーは以降使わない
+    animation.channels.clear();
+    animation.channels.shrink_to_fit();
+}
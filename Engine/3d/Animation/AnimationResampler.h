@@ -0,0 +1,67 @@
+#pragma once
+#include "Model/ModelStructs.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/// <summary>
+/// クリップを一定間隔でサンプリングし直す(読み込み時に1回)
+/// メモリは増えるが、サンプリングはフレーム番号の計算と1回の補間だけになる
+/// </summary>
+class AnimationResampler {
+  public:
+    // 時刻に対応するフレームの位置(1回の姿勢計算で全Jointが共有する)
+    struct FramePosition {
+        uint32_t frame = 0; // frameとframe + 1の間
+        float t = 0.0f;
+    };
+
+  public:
+    /// <summary>
+    /// channels(圧縮前のキー)から sampleRate [Hz] 以上の間隔でサンプリングし直し、channelsを解放する
+    /// </summary>
+    /// <param name="animation"></param>
+    /// <param name="sampleRate"></param>
+    static void Resample(Animation &animation, float sampleRate);
+
+    /// <summary>
+    /// 時刻からフレームの位置を求める
+    /// </summary>
+    static FramePosition Locate(const ResampledAnimation &resampled, float time) {
+        const float lastFrame = static_cast<float>(resampled.frameCount - 1);
+        const float position = std::clamp(time * resampled.framesPerSecond, 0.0f, lastFrame);
+        FramePosition result;
+        result.frame = std::min(static_cast<uint32_t>(position), resampled.frameCount - 2);
+        result.t = position - static_cast<float>(result.frame);
+        return result;
+    }
+
+    static Vector3 SampleTranslate(const ResampledAnimation &resampled, uint32_t channel, const FramePosition &position) {
+        const Vector3 *values = resampled.translates.data() + channel * resampled.frameCount + position.frame;
+        return values[0] + (values[1] - values[0]) * position.t;
+    }
+
+    static Vector3 SampleScale(const ResampledAnimation &resampled, uint32_t channel, const FramePosition &position) {
+        const Vector3 *values = resampled.scales.data() + channel * resampled.frameCount + position.frame;
+        return values[0] + (values[1] - values[0]) * position.t;
+    }
+
+    // nlerp(隣のフレームは同じ半球にそろえてあるので符号の判定は要らない)
+    static Quaternion SampleRotate(const ResampledAnimation &resampled, uint32_t channel, const FramePosition &position) {
+        const Quaternion *values = resampled.rotates.data() + channel * resampled.frameCount + position.frame;
+        const Quaternion &q0 = values[0];
+        const Quaternion &q1 = values[1];
+        const float s = 1.0f - position.t;
+        Quaternion result(q0.x * s + q1.x * position.t, q0.y * s + q1.y * position.t, q0.z * s + q1.z * position.t,
+                          q0.w * s + q1.w * position.t);
+        const float inverseLength = 1.0f / std::sqrt(result.x * result.x + result.y * result.y + result.z * result.z + result.w * result.w);
+        return Quaternion(result.x * inverseLength, result.y * inverseLength, result.z * inverseLength, result.w * inverseLength);
+    }
+
+    /// <summary>
+    /// サンプリングし直した後のメモリ量
+    /// </summary>
+    static size_t GetByteSize(const ResampledAnimation &resampled) {
+        return sizeof(Vector3) * (resampled.translates.size() + resampled.scales.size()) + sizeof(Quaternion) * resampled.rotates.size();
+    }
+};
@@ -0,0 +1,51 @@
+#include "AnimationUpdateQueue.h"
+#include "ModelAnimation.h"
+#include "Thread/ThreadPool.h"
+#include <algorithm>
+
+AnimationUpdateQueue *AnimationUpdateQueue::instance = nullptr;
+
+AnimationUpdateQueue *AnimationUpdateQueue::GetInstance() {
+    if (instance == nullptr) {
+        instance = new AnimationUpdateQueue();
+    }
+    return instance;
+}
+
+void AnimationUpdateQueue::Finalize() {
+    delete instance;
+    instance = nullptr;
+}
+
+void AnimationUpdateQueue::Begin() {
+    jobs_.clear();
+    isRecording_ = true;
+}
+
+bool AnimationUpdateQueue::Push(ModelAnimation *animation, bool roop, AnimationBlender *blender, AnimationLod *lod) {
+    if (!isRecording_) {
+        return false;
+    }
+    // 同じアニメーションを2つのジョブが同時に触らないようにする
+    auto it = std::find_if(jobs_.begin(), jobs_.end(), [animation](const Job &job) { return job.animation == animation; });
+    if (it == jobs_.end()) {
+        it = jobs_.insert(jobs_.end(), Job{animation});
+    }
+    it->blender = blender;
+    it->lod = lod;
+    it->roop = roop;
+    return true;
+}
+
+void AnimationUpdateQueue::Flush() {
+    isRecording_ = false;
+    lastJobCount_ = static_cast<uint32_t>(jobs_.size());
+    // 1オブジェクト=1ジョブ(Jointの数が違うので、空いたワーカーから順に取っていく)
+    ThreadPool::GetInstance()->ParallelFor(lastJobCount_, 1, [this](uint32_t begin, uint32_t end) {
+        for (uint32_t index = begin; index < end; ++index) {
+            const Job &job = jobs_[index];
+            job.animation->Update(job.roop, job.blender, job.lod);
+        }
+    });
+    jobs_.clear();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class ModelAnimation;
+class AnimationBlender;
+class AnimationLod;
+
+/// <summary>
+/// アニメーション更新のまとめ役
+/// Begin〜Flushの間に呼ばれたObject3d::AnimationUpdateを積んでおき、Flushでオブジェクトごとにワーカースレッドで並列に更新する
+/// (サンプリング・ブレンド・姿勢計算・パレットへの書き込みまで。オブジェクト同士は何も共有しないので同期は要らない)
+/// パレットはアップロードヒープに直接書くので、Flushは描画コマンドを積む前(Update中)に呼ぶこと
+/// 前のフレームのGPU処理はDirectXCommon::PostDrawのフェンス待ちで終わっているので、書き込みとGPUの読み込みは重ならない
+/// </summary>
+class AnimationUpdateQueue {
+  private:
+    static AnimationUpdateQueue *instance;
+    AnimationUpdateQueue() = default;
+    ~AnimationUpdateQueue() = default;
+    AnimationUpdateQueue(AnimationUpdateQueue &) = delete;
+    AnimationUpdateQueue &operator=(AnimationUpdateQueue &) = delete;
+
+    // 1オブジェクト分の更新
+    struct Job {
+        ModelAnimation *animation = nullptr;
+        AnimationBlender *blender = nullptr;
+        AnimationLod *lod = nullptr;
+        bool roop = false;
+    };
+
+  public:
+    /// <summary>
+    /// シングルトンインスタンスの取得
+    /// </summary>
+    static AnimationUpdateQueue *GetInstance();
+
+    /// <summary>
+    /// 終了
+    /// </summary>
+    void Finalize();
+
+    /// <summary>
+    /// 以降のアニメーション更新を積むようにする
+    /// </summary>
+    void Begin();
+
+    /// <summary>
+    /// 更新を積む(Begin前ならfalseを返すので、呼び出し側でその場で更新する)
+    /// 同じフレームに同じアニメーションが積まれたら、後の指定で1回だけ更新する
+    /// </summary>
+    bool Push(ModelAnimation *animation, bool roop, AnimationBlender *blender, AnimationLod *lod);
+
+    /// <summary>
+    /// 積んだ更新を並列に実行し、全部終わってから戻る
+    /// </summary>
+    void Flush();
+
+    /// <summary>
+    /// 直前のFlushで更新したオブジェクトの数
+    /// </summary>
+    uint32_t GetLastJobCount() const { return lastJobCount_; }
+
+  private:
+    std::vector<Job> jobs_;
+    bool isRecording_ = false;
+    uint32_t lastJobCount_ = 0;
+};
@@ -1,18 +1,65 @@
+#define NOMINMAX
 #include "Animator.h"
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
+#include <algorithm>
 #include <cassert>
 #include <Engine/Frame/Frame.h>
 #include <myMath.h>
+#include "AnimationLibrary.h"
+
+namespace {
+constexpr uint32_t kInvalidCursor = UINT32_MAX;
+constexpr uint32_t kMaxCursorSteps = 4; // 前回の位置から線形に進める最大キー数
+
+// timeAt(i) <= time < timeAt(i + 1) となるiを探す(countはキー数)
+// (呼び出し側で最初のキー以前・最後のキー以降は除いておく)
+template <typename TimeAt>
+uint32_t FindKeyIndex(uint32_t count, TimeAt timeAt, float time, uint32_t cursor) {
+    const uint32_t lastIndex = count - 2;
+    if (cursor <= lastIndex && timeAt(cursor) <= time) {
+        // 通常の再生では前回と同じ区間か、数キー先にある
+        for (uint32_t step = 0; step < kMaxCursorSteps && cursor <= lastIndex; ++step, ++cursor) {
+            if (time < timeAt(cursor + 1)) {
+                return cursor;
+            }
+        }
+    }
+    // ループで先頭に戻った・シークした・大きく進んだときは二分探索
+    uint32_t first = 0;
+    uint32_t length = count;
+    while (length > 0) {
+        uint32_t half = length / 2;
+        if (timeAt(first + half) <= time) {
+            first += half + 1;
+            length -= half + 1;
+        } else {
+            length = half;
+        }
+    }
+    return std::min(first > 0 ? first - 1 : 0, lastIndex);
+}
 
-std::unordered_map<std::string, Animation> Animator::animationCache;
+template <typename Keyframe>
+uint32_t FindKeyIndex(const std::vector<Keyframe> &keyframes, float time, uint32_t cursor) {
+    return FindKeyIndex(static_cast<uint32_t>(keyframes.size()), [&keyframes](uint32_t i) { return keyframes[i].time; }, time, cursor);
+}
 
-void Animator::Initialize(const std::string &directorypath, const std::string &filename) {
+uint32_t FindKeyIndex(const std::vector<float> &times, float time, uint32_t cursor) {
+    return FindKeyIndex(static_cast<uint32_t>(times.size()), [&times](uint32_t i) { return times[i]; }, time, cursor);
+}
+} // namespace
+
+void Animator::Initialize(const std::string &directorypath, const std::string &filename, const std::string &clipName) {
     haveAnimation = false;
     directorypath_ = directorypath;
     filename_ = filename;
 
-    animation_ = LoadAnimationFile(directorypath_, filename_);
+    animation_ = LoadAnimationFile(directorypath_, filename_, clipName);
+}
+
+void Animator::SetAnimation(std::shared_ptr<const Animation> animation) {
+    animation_ = animation ? std::move(animation) : std::make_shared<const Animation>();
+    haveAnimation = !animation_->channelNames.empty();
+    animationTime = 0.0f;
 }
 
 void Animator::Update(bool roop) {
@@ -20,15 +67,15 @@ void Animator::Update(bool roop) {
         if (roop) {
             // ループアニメーションの場合、アニメーション時間を進めて、超えたら最初に戻る
             animationTime += Frame::DeltaTime();
-            animationTime = std::fmod(animationTime, animation_.duration); // 終わったら戻る
+            animationTime = std::fmod(animationTime, animation_->duration); // 終わったら戻る
         } else {
             // ループしない場合、アニメーションが終了するまで進行
-            if (animationTime < animation_.duration) {
+            if (animationTime < animation_->duration) {
                 isFinish_ = false;
                 animationTime += Frame::DeltaTime();
                 // 時間がdurationを超えたら停止（アニメーションの終了時刻を超えないように）
-                if (animationTime > animation_.duration) {
-                    animationTime = animation_.duration;
+                if (animationTime > animation_->duration) {
+                    animationTime = animation_->duration;
                     // アニメーションが終了した時の処理
                     isAnimation_ = false; // ここでアニメーション終了を示す
                     isFinish_ = true;
@@ -38,102 +85,91 @@ void Animator::Update(bool roop) {
     }
 }
 
-Animation Animator::LoadAnimationFile(const std::string &directoryPath, const std::string &filename) {
-    // キャッシュキーの生成
-    std::string filePath = directoryPath + "/" + filename;
-    Animation animation;
-    Assimp::Importer importer;
-    const aiScene *scene = importer.ReadFile(filePath.c_str(), 0);
-    if (!scene || scene->mNumAnimations == 0) {
-        haveAnimation = false;
-        return animation; // アニメーションなし
+std::shared_ptr<const Animation> Animator::LoadAnimationFile(const std::string &directoryPath, const std::string &filename,
+                                                             const std::string &clipName) {
+    // ファイルの読み込み・クリップの共有はAnimationLibraryが行う
+    AnimationLibrary *library = AnimationLibrary::GetInstance();
+    std::shared_ptr<const Animation> animation = library->GetClip(library->Find(directoryPath, filename, clipName));
+    haveAnimation = animation != nullptr;
+    if (!animation) {
+        return std::make_shared<const Animation>(); // アニメーションなし
     }
-
-    haveAnimation = true;
-
-    // キャッシュチェック
-    auto it = animationCache.find(filePath);
-    if (it != animationCache.end()) {
-        return it->second; // すでに読み込み済みならキャッシュから返す
-    }
-
-    aiAnimation *animationAssimp = scene->mAnimations[0];
-    animation.duration = float(animationAssimp->mDuration / animationAssimp->mTicksPerSecond);
-
-    // ノードアニメーションの読み込み
-    for (uint32_t channelIndex = 0; channelIndex < animationAssimp->mNumChannels; ++channelIndex) {
-        aiNodeAnim *nodeAnimationAssimp = animationAssimp->mChannels[channelIndex];
-        NodeAnimation &nodeAnimation = animation.nodeAnimations[nodeAnimationAssimp->mNodeName.C_Str()];
-
-        // Position
-        for (uint32_t keyIndex = 0; keyIndex < nodeAnimationAssimp->mNumPositionKeys; ++keyIndex) {
-            aiVectorKey &keyAssimp = nodeAnimationAssimp->mPositionKeys[keyIndex];
-            KeyframeVector3 keyframe;
-            keyframe.time = float(keyAssimp.mTime / animationAssimp->mTicksPerSecond);
-            keyframe.value = {-keyAssimp.mValue.x, keyAssimp.mValue.y, keyAssimp.mValue.z};
-            nodeAnimation.translate.push_back(keyframe);
-        }
-
-        // Rotation
-        for (uint32_t keyIndex = 0; keyIndex < nodeAnimationAssimp->mNumRotationKeys; ++keyIndex) {
-            aiQuatKey &keyAssimp = nodeAnimationAssimp->mRotationKeys[keyIndex];
-            KeyframeQuaternion keyframe;
-            keyframe.time = float(keyAssimp.mTime / animationAssimp->mTicksPerSecond);
-            keyframe.value = {keyAssimp.mValue.x, -keyAssimp.mValue.y, -keyAssimp.mValue.z, keyAssimp.mValue.w};
-            nodeAnimation.rotate.push_back(keyframe);
-        }
-
-        // Scale
-        for (uint32_t keyIndex = 0; keyIndex < nodeAnimationAssimp->mNumScalingKeys; ++keyIndex) {
-            aiVectorKey &keyAssimp = nodeAnimationAssimp->mScalingKeys[keyIndex];
-            KeyframeVector3 keyframe;
-            keyframe.time = float(keyAssimp.mTime / animationAssimp->mTicksPerSecond);
-            keyframe.value = {keyAssimp.mValue.x, keyAssimp.mValue.y, keyAssimp.mValue.z};
-            nodeAnimation.scale.push_back(keyframe);
-        }
-    }
-
-    // キャッシュに登録
-    animationCache[filePath] = animation;
     return animation;
 }
 
 Vector3 Animator::CalculateValue(const std::vector<KeyframeVector3> &keyframes, float time) {
+    uint32_t cursor = kInvalidCursor;
+    return CalculateValue(keyframes, time, cursor);
+}
+
+Quaternion Animator::CalculateValue(const std::vector<KeyframeQuaternion> &keyframes, float time) {
+    uint32_t cursor = kInvalidCursor;
+    return CalculateValue(keyframes, time, cursor);
+}
+
+Vector3 Animator::CalculateValue(const std::vector<KeyframeVector3> &keyframes, float time, uint32_t &cursor) {
     assert(!keyframes.empty());                               // キーがないものは返す値がわからないのでダメ
     if (keyframes.size() == 1 || time <= keyframes[0].time) { // キーが一つまたは時刻がキーフレーム前なら最初の値とする
+        cursor = 0;
         return keyframes[0].value;
     }
-
-    for (size_t index = 0; index < keyframes.size() - 1; ++index) {
-        size_t nextIndex = index + 1;
-        // indexとnextIndexの二つのキーフレームを取得して範囲内に時刻があるか確認
-        if (keyframes[index].time <= time && time <= keyframes[nextIndex].time) {
-            // 範囲内を保管する
-            float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
-            return Lerp(keyframes[index].value, keyframes[nextIndex].value, t);
-        }
+    if (time >= keyframes.back().time) { // 1番後の時刻よりも後ろなので最後の値を返す
+        cursor = static_cast<uint32_t>(keyframes.size()) - 2;
+        return keyframes.back().value;
     }
-    // ここまできた場合は1番後の時刻よりも後ろなので最後の値を返す
-    return (*keyframes.rbegin()).value;
+    cursor = FindKeyIndex(keyframes, time, cursor);
+    const KeyframeVector3 &key = keyframes[cursor];
+    const KeyframeVector3 &nextKey = keyframes[cursor + 1];
+    float t = (time - key.time) / (nextKey.time - key.time);
+    return Lerp(key.value, nextKey.value, t);
 }
 
-Quaternion Animator::CalculateValue(const std::vector<KeyframeQuaternion> &keyframes, float time) {
+Quaternion Animator::CalculateValue(const std::vector<KeyframeQuaternion> &keyframes, float time, uint32_t &cursor) {
     assert(!keyframes.empty()); // キーフレームが空でないことを確認
     if (keyframes.size() == 1 || time <= keyframes[0].time) {
         // キーフレームが一つしかないか、時刻が最初のキーフレームより前なら最初の値を返す
+        cursor = 0;
         return keyframes[0].value;
     }
+    if (time >= keyframes.back().time) { // 最後の時刻よりも後ろなので最後の値を返す
+        cursor = static_cast<uint32_t>(keyframes.size()) - 2;
+        return keyframes.back().value;
+    }
+    cursor = FindKeyIndex(keyframes, time, cursor);
+    const KeyframeQuaternion &key = keyframes[cursor];
+    const KeyframeQuaternion &nextKey = keyframes[cursor + 1];
+    float t = (time - key.time) / (nextKey.time - key.time);
+    return Slerp(key.value, nextKey.value, t);
+}
 
-    for (size_t index = 0; index < keyframes.size() - 1; ++index) {
-        size_t nextIndex = index + 1;
-        // indexとnextIndexの二つのキーフレームを取得して範囲内に時刻があるか確認
-        if (keyframes[index].time <= time && time <= keyframes[nextIndex].time) {
-            // 時刻が範囲内の場合は補間を行う
-            float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
-            return Slerp(keyframes[index].value, keyframes[nextIndex].value, t);
-        }
+Vector3 Animator::CalculateValue(const CompressedTrackVector3 &track, float time, uint32_t &cursor) {
+    assert(!track.times.empty());
+    const uint32_t count = static_cast<uint32_t>(track.times.size());
+    if (count == 1 || time <= track.times[0]) {
+        cursor = 0;
+        return AnimationCompression::Decode(track, 0);
     }
+    if (time >= track.times.back()) {
+        cursor = count - 2;
+        return AnimationCompression::Decode(track, count - 1);
+    }
+    cursor = FindKeyIndex(track.times, time, cursor);
+    float t = (time - track.times[cursor]) / (track.times[cursor + 1] - track.times[cursor]);
+    return Lerp(AnimationCompression::Decode(track, cursor), AnimationCompression::Decode(track, cursor + 1), t);
+}
 
-    // ここまで来た場合は最後の時刻よりも後ろなので最後の値を返す
-    return (*keyframes.rbegin()).value;
-}
\ No newline at end of file
+Quaternion Animator::CalculateValue(const CompressedTrackQuaternion &track, float time, uint32_t &cursor) {
+    assert(!track.times.empty());
+    const uint32_t count = static_cast<uint32_t>(track.times.size());
+    if (count == 1 || time <= track.times[0]) {
+        cursor = 0;
+        return AnimationCompression::Decode(track, 0);
+    }
+    if (time >= track.times.back()) {
+        cursor = count - 2;
+        return AnimationCompression::Decode(track, count - 1);
+    }
+    cursor = FindKeyIndex(track.times, time, cursor);
+    float t = (time - track.times[cursor]) / (track.times[cursor + 1] - track.times[cursor]);
+    return Slerp(AnimationCompression::Decode(track, cursor), AnimationCompression::Decode(track, cursor + 1), t);
+}
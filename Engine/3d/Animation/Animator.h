@@ -1,8 +1,11 @@
 #pragma once
 #include"Model/ModelStructs.h"
+#include "AnimationCompression.h"
+#include "AnimationResampler.h"
 #include <type/Quaternion.h>
 #include <type/Vector3.h>
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -12,31 +15,37 @@ class Animator {
     std::string directorypath_;
     bool haveAnimation = false;
     float animationTime = 0.0f;
-    Animation animation_;
+    std::shared_ptr<const Animation> animation_; // 同じファイルのAnimator間で共有する(変更しない)
     bool isRoop_;
     bool isAnimation_ = true;
     bool isFinish_ = false;
-    static std::unordered_map<std::string, Animation> animationCache;
 
   public:
-    void Initialize(const std::string &directorypath, const std::string &filename);
+    /// <summary>
+    /// 初期化(clipNameが空ならファイルの最初のクリップ)
+    /// </summary>
+    void Initialize(const std::string &directorypath, const std::string &filename, const std::string &clipName = "");
 
     void Update(bool roop);
 
-    bool HaveAnimation() { return haveAnimation; }
-    Animation GetAnimation() { return animation_; }
-    float GetAnimationTime() { return animationTime; }
+    bool HaveAnimation() const { return haveAnimation; }
+    const Animation &GetAnimation() const { return *animation_; }
+    const std::shared_ptr<const Animation> &GetSharedAnimation() const { return animation_; }
+    // 読み込み済みのクリップを差し替える(ファイルを介さない場合用、Boneは次の更新で結び付け直す)
+    void SetAnimation(std::shared_ptr<const Animation> animation);
+    float GetAnimationTime() const { return animationTime; }
     void SetAnimationTime(float time) { animationTime = time; }
     void SetIsAnimation(bool isAnimation) { isAnimation_ = isAnimation; }
     bool IsFinish() { return isFinish_; }
 
     /// <summary>
-    /// アニメーションファイル読み込み
+    /// アニメーションファイル読み込み(AnimationLibraryで共有しているクリップを返す)
     /// </summary>
     /// <param name="directoryPath"></param>
     /// <param name="filename"></param>
+    /// <param name="clipName">空ならファイルの最初のクリップ</param>
     /// <returns></returns>
-    Animation LoadAnimationFile(const std::string &directoryPath, const std::string &filename);
+    std::shared_ptr<const Animation> LoadAnimationFile(const std::string &directoryPath, const std::string &filename, const std::string &clipName = "");
 
     /// <summary>
     /// 値の計算(Vector3)
@@ -53,4 +62,26 @@ class Animator {
     /// <param name="time"></param>
     /// <returns></returns>
     static Quaternion CalculateValue(const std::vector<KeyframeQuaternion> &keyframes, float time);
+
+    /// <summary>
+    /// 値の計算(Vector3)
+    /// cursorに前回のキー位置を覚えておき、そこから先を探す(戻り・飛びは二分探索)
+    /// </summary>
+    static Vector3 CalculateValue(const std::vector<KeyframeVector3> &keyframes, float time, uint32_t &cursor);
+
+    /// <summary>
+    /// 値の計算(Quaternion)
+    /// cursorに前回のキー位置を覚えておき、そこから先を探す(戻り・飛びは二分探索)
+    /// </summary>
+    static Quaternion CalculateValue(const std::vector<KeyframeQuaternion> &keyframes, float time, uint32_t &cursor);
+
+    /// <summary>
+    /// 値の計算(圧縮済みVector3)
+    /// </summary>
+    static Vector3 CalculateValue(const CompressedTrackVector3 &track, float time, uint32_t &cursor);
+
+    /// <summary>
+    /// 値の計算(圧縮済みQuaternion)
+    /// </summary>
+    static Quaternion CalculateValue(const CompressedTrackQuaternion &track, float time, uint32_t &cursor);
 };
@@ -1,24 +1,99 @@
 #include "Bone.h"
 #include <myMath.h>
 #include "Animator.h"
+#include <algorithm>
+#include <cassert>
+#include <xmmintrin.h>
 
-void Bone::Initialize(ModelData modelData)
+void Bone::Initialize(const ModelData& modelData)
 {
 	skeleton_ = CreateSkeleton(modelData.rootNode);
+	bindings_.clear();
+	cursors_.clear();
+	boundAnimation_ = nullptr;
+	skipJointHeight_ = 0;
+
+	// 子が親より後に並ぶので、後ろから親に高さを伝える
+	jointHeights_.assign(skeleton_.parents.size(), 0);
+	for (size_t joint = skeleton_.parents.size(); joint-- > 0;) {
+		const int32_t parent = skeleton_.parents[joint];
+		if (parent >= 0) {
+			jointHeights_[parent] = std::max(jointHeights_[parent], jointHeights_[joint] + 1);
+		}
+	}
+}
+
+void Bone::Bind(const Animation& animation)
+{
+	BindChannels(skeleton_.jointMap, animation, bindings_, cursors_);
+	boundAnimation_ = &animation;
+	skipJointHeight_ = 0;
+}
+
+void Bone::BindChannels(const std::map<std::string, int32_t>& jointMap, const Animation& animation, std::vector<ChannelBinding>& bindings, std::vector<KeyframeCursor>& cursors)
+{
+	bindings.clear();
+	for (uint32_t channel = 0; channel < animation.channelNames.size(); ++channel) {
+		if (auto it = jointMap.find(animation.channelNames[channel]); it != jointMap.end()) {
+			bindings.push_back({channel, it->second});
+		}
+	}
+	// Jointの順に並べて書き込み先を連続させる
+	std::sort(bindings.begin(), bindings.end(), [](const ChannelBinding& a, const ChannelBinding& b) { return a.joint < b.joint; });
+	cursors.assign(bindings.size(), KeyframeCursor{});
 }
 
 void Bone::Update(const Animation& animation, float animationTime)
 {
 	ApplyAnimation(animation, animationTime);
-	// すべてのJointを更新。親が若いので通常ループで処理可能
-	for (Joint& joint : skeleton_.joints) {
-		joint.localMatrix = MakeAffineMatrix(joint.transform.scale, joint.transform.rotate, joint.transform.translate);
-		if (joint.parent) { // 親がいれば親の行列を掛ける
-			joint.skeletonSpaceMatrix = joint.localMatrix * skeleton_.joints[*joint.parent].skeletonSpaceMatrix;
-		}
-		else { // 親がいないのでlocalMatrixとskeletonSpaceMatrixは一致する
-			joint.skeletonSpaceMatrix = joint.localMatrix;
+	SolvePose(skeleton_);
+}
+
+void Bone::SolvePose(Skeleton& skeleton)
+{
+	const SkeletonLocalPose& pose = skeleton.localPose;
+	const int32_t* parents = skeleton.parents.data();
+	Matrix4x4* modelMatrices = skeleton.modelMatrices.data();
+	const size_t count = skeleton.parents.size();
+
+	for (size_t i = 0; i < count; ++i) {
+		// ローカル行列(S * R * T)の各行。回転はQuaternionToMatrix4x4と同じ式
+		const Quaternion& q = pose.rotates[i];
+		const Vector3& s = pose.scales[i];
+		const Vector3& t = pose.translates[i];
+		float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+		__m128 row0 = _mm_mul_ps(_mm_set_ps(0.0f, 2.0f * (xz - wy), 2.0f * (xy + wz), 1.0f - 2.0f * (yy + zz)), _mm_set1_ps(s.x));
+		__m128 row1 = _mm_mul_ps(_mm_set_ps(0.0f, 2.0f * (yz + wx), 1.0f - 2.0f * (xx + zz), 2.0f * (xy - wz)), _mm_set1_ps(s.y));
+		__m128 row2 = _mm_mul_ps(_mm_set_ps(0.0f, 1.0f - 2.0f * (xx + yy), 2.0f * (yz - wx), 2.0f * (xz + wy)), _mm_set1_ps(s.z));
+		__m128 row3 = _mm_set_ps(1.0f, t.z, t.y, t.x);
+
+		float* out = &modelMatrices[i].m[0][0];
+		if (parents[i] < 0) { // 親がいないのでローカル行列がそのままスケルトン空間の行列
+			_mm_storeu_ps(out + 0, row0);
+			_mm_storeu_ps(out + 4, row1);
+			_mm_storeu_ps(out + 8, row2);
+			_mm_storeu_ps(out + 12, row3);
+			continue;
 		}
+
+		// 親は先に解いてあるので、その行列を掛ける(アフィンなので4列目は0,0,0,1)
+		const float* parent = &modelMatrices[parents[i]].m[0][0];
+		__m128 parent0 = _mm_loadu_ps(parent + 0);
+		__m128 parent1 = _mm_loadu_ps(parent + 4);
+		__m128 parent2 = _mm_loadu_ps(parent + 8);
+		__m128 parent3 = _mm_loadu_ps(parent + 12);
+		auto transformRow = [&](__m128 row) {
+			__m128 result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), parent0);
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), parent1));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), parent2));
+			return result;
+		};
+		_mm_storeu_ps(out + 0, transformRow(row0));
+		_mm_storeu_ps(out + 4, transformRow(row1));
+		_mm_storeu_ps(out + 8, transformRow(row2));
+		_mm_storeu_ps(out + 12, _mm_add_ps(transformRow(row3), parent3));
 	}
 }
 
@@ -26,8 +101,6 @@ int32_t Bone::CreateJoint(const Node& node, const std::optional<int32_t>& parent
 {
 	Joint joint;
 	joint.name = node.name;
-	joint.localMatrix = node.localMatrix;
-	joint.skeletonSpaceMatrix = MakeIdentity4x4();
 	joint.transform = node.transform;
 	joint.index = static_cast<int32_t>(joints.size());
 	joint.parent = parent;
@@ -45,21 +118,92 @@ Skeleton Bone::CreateSkeleton(const Node& rootNode)
 	Skeleton skeleton;
 	skeleton.root = CreateJoint(rootNode, {}, skeleton.joints);
 
+	// 毎フレーム使う姿勢は平坦な配列にする(CreateJointは親から順に追加するので親が先に並ぶ)
+	const size_t jointCount = skeleton.joints.size();
+	skeleton.parents.resize(jointCount);
+	skeleton.localPose.translates.resize(jointCount);
+	skeleton.localPose.rotates.resize(jointCount);
+	skeleton.localPose.scales.resize(jointCount);
+	skeleton.modelMatrices.resize(jointCount);
 	for (const Joint& joint : skeleton.joints) {
 		skeleton.jointMap.emplace(joint.name, joint.index);
+		skeleton.parents[joint.index] = joint.parent ? *joint.parent : -1;
+		assert(skeleton.parents[joint.index] < joint.index);
+		skeleton.localPose.translates[joint.index] = joint.transform.translate;
+		skeleton.localPose.rotates[joint.index] = joint.transform.rotate;
+		skeleton.localPose.scales[joint.index] = joint.transform.scale;
 	}
+	SolvePose(skeleton);
 
 	return skeleton;
 }
 
 void Bone::ApplyAnimation(const Animation& animation, float animationTime)
 {
-	for (Joint& joint : skeleton_.joints) {
-		if (auto it = animation.nodeAnimations.find(joint.name); it != animation.nodeAnimations.end()) {
-			const NodeAnimation& rootNodeAnimation = (*it).second;
-			joint.transform.translate = Animator::CalculateValue(rootNodeAnimation.translate, animationTime);
-			joint.transform.rotate = Animator::CalculateValue(rootNodeAnimation.rotate, animationTime);
-			joint.transform.scale = Animator::CalculateValue(rootNodeAnimation.scale, animationTime);
+	// 未バインド(SetSkeletonで差し替えられた場合など)・クリップが差し替えられたならここで結び付ける
+	// (チャンネルの番号は前のクリップのものなので、そのまま使うと範囲外を読む)
+	if (boundAnimation_ != &animation) {
+		Bind(animation);
+	}
+	SampleChannels(animation, bindings_, cursors_, animationTime, skeleton_.localPose);
+}
+
+void Bone::ApplyAnimation(const Animation& animation, float animationTime, uint32_t skipJointHeight)
+{
+	if (skipJointHeight == 0 || jointHeights_.size() != skeleton_.parents.size()) {
+		ApplyAnimation(animation, animationTime);
+		return;
+	}
+	if (boundAnimation_ != &animation) {
+		Bind(animation);
+	}
+	// 高さが変わったときだけ作り直す
+	if (skipJointHeight_ != skipJointHeight) {
+		coreBindings_.clear();
+		for (const ChannelBinding& binding : bindings_) {
+			if (jointHeights_[binding.joint] >= skipJointHeight) {
+				coreBindings_.push_back(binding);
+			}
+		}
+		coreCursors_.assign(coreBindings_.size(), KeyframeCursor{});
+		skipJointHeight_ = skipJointHeight;
+	}
+	SampleChannels(animation, coreBindings_, coreCursors_, animationTime, skeleton_.localPose);
+}
+
+void Bone::SampleChannels(const Animation& animation, const std::vector<ChannelBinding>& bindings, std::vector<KeyframeCursor>& cursors,
+	float animationTime, SkeletonLocalPose& pose)
+{
+	if (animation.resampled.frameCount > 0) {
+		// フレーム位置は全Jointで同じなので1回だけ求める
+		const ResampledAnimation& resampled = animation.resampled;
+		const AnimationResampler::FramePosition position = AnimationResampler::Locate(resampled, animationTime);
+		for (size_t i = 0; i < bindings.size(); ++i) {
+			const uint32_t channel = bindings[i].channel;
+			const int32_t joint = bindings[i].joint;
+			pose.translates[joint] = AnimationResampler::SampleTranslate(resampled, channel, position);
+			pose.rotates[joint] = AnimationResampler::SampleRotate(resampled, channel, position);
+			pose.scales[joint] = AnimationResampler::SampleScale(resampled, channel, position);
+		}
+		return;
+	}
+	if (!animation.compressedChannels.empty()) {
+		for (size_t i = 0; i < bindings.size(); ++i) {
+			const CompressedNodeAnimation& nodeAnimation = animation.compressedChannels[bindings[i].channel];
+			const int32_t joint = bindings[i].joint;
+			KeyframeCursor& cursor = cursors[i];
+			pose.translates[joint] = Animator::CalculateValue(nodeAnimation.translate, animationTime, cursor.translate);
+			pose.rotates[joint] = Animator::CalculateValue(nodeAnimation.rotate, animationTime, cursor.rotate);
+			pose.scales[joint] = Animator::CalculateValue(nodeAnimation.scale, animationTime, cursor.scale);
 		}
+		return;
+	}
+	for (size_t i = 0; i < bindings.size(); ++i) {
+		const NodeAnimation& nodeAnimation = animation.channels[bindings[i].channel];
+		const int32_t joint = bindings[i].joint;
+		KeyframeCursor& cursor = cursors[i];
+		pose.translates[joint] = Animator::CalculateValue(nodeAnimation.translate, animationTime, cursor.translate);
+		pose.rotates[joint] = Animator::CalculateValue(nodeAnimation.rotate, animationTime, cursor.rotate);
+		pose.scales[joint] = Animator::CalculateValue(nodeAnimation.scale, animationTime, cursor.scale);
 	}
 }
@@ -3,17 +3,83 @@
 class Bone
 {
 public:
-	
+	// トラックごとの前回のキー位置(この再生インスタンス専用)
+	struct KeyframeCursor {
+		uint32_t translate = 0;
+		uint32_t rotate = 0;
+		uint32_t scale = 0;
+	};
+
+	// チャンネルとJointの対応
+	struct ChannelBinding {
+		uint32_t channel;
+		int32_t joint;
+	};
+
 private:
 	Skeleton skeleton_;
+	std::vector<ChannelBinding> bindings_; // Jointの順
+	std::vector<KeyframeCursor> cursors_;  // bindings_と同じ並び
+	const Animation* boundAnimation_ = nullptr; // 結び付けたクリップ(Animatorで差し替えられたら結び付け直す)
+
+	// 末端のJointを省くときのチャンネル(bindings_から、末端からの高さがskipJointHeight_以上のJointだけ)
+	std::vector<uint32_t> jointHeights_; // Jointの末端からの高さ(末端は0)
+	std::vector<ChannelBinding> coreBindings_;
+	std::vector<KeyframeCursor> coreCursors_;
+	uint32_t skipJointHeight_ = 0; // coreBindings_を作ったときの高さ(0なら未作成)
 
 public:
-	void Initialize(ModelData modelData);
+	void Initialize(const ModelData& modelData);
 
 	void Update(const Animation& animation, float animtaionTime);
 
-	Skeleton GetSkeleton() { return skeleton_; }
-	void SetSkeleton(Skeleton& skeleton) { skeleton_ = skeleton; }
+	/// <summary>
+	/// アニメーションのチャンネルをJointのindexに結び付ける(クリップの読み込み時に1回)
+	/// </summary>
+	/// <param name="animation"></param>
+	void Bind(const Animation& animation);
+
+	const Skeleton& GetSkeleton() const { return skeleton_; }
+	void SetSkeleton(const Skeleton& skeleton) { skeleton_ = skeleton; boundAnimation_ = nullptr; }
+
+	/// <summary>
+	/// ローカルのTRSからスケルトン空間の行列を求める(親が先の並びを1回で処理、SSE)
+	/// </summary>
+	/// <param name="skeleton"></param>
+	static void SolvePose(Skeleton& skeleton);
+
+	/// <summary>
+	/// アニメーションの適応(ローカルのTRSだけ。行列はSolvePoseで求める)
+	/// </summary>
+	/// <param name="animation"></param>
+	/// <param name="animationTime"></param>
+	void ApplyAnimation(const Animation& animation, float animationTime);
+
+	/// <summary>
+	/// 末端からの高さがskipJointHeight未満のJoint(指・顔など)のチャンネルを省いて適応する(省いたJointは前の値のまま。0なら全Joint)
+	/// </summary>
+	/// <param name="animation"></param>
+	/// <param name="animationTime"></param>
+	/// <param name="skipJointHeight"></param>
+	void ApplyAnimation(const Animation& animation, float animationTime, uint32_t skipJointHeight);
+
+	/// <summary>
+	/// 姿勢の計算(ApplyAnimationの後、ブレンドなどでローカルのTRSを書き換えた後に呼ぶ)
+	/// </summary>
+	void Solve() { SolvePose(skeleton_); }
+
+	SkeletonLocalPose& GetLocalPose() { return skeleton_.localPose; }
+
+	/// <summary>
+	/// クリップのチャンネルをJoint名からJointのindexに結び付ける(Jointの順に並べる)
+	/// </summary>
+	static void BindChannels(const std::map<std::string, int32_t>& jointMap, const Animation& animation, std::vector<ChannelBinding>& bindings, std::vector<KeyframeCursor>& cursors);
+
+	/// <summary>
+	/// 結び付けたチャンネルをサンプリングしてposeに書き込む(結び付いていないJointはそのまま)
+	/// </summary>
+	static void SampleChannels(const Animation& animation, const std::vector<ChannelBinding>& bindings, std::vector<KeyframeCursor>& cursors,
+		float animationTime, SkeletonLocalPose& pose);
 private:
 	/// <summary>
 	/// Joint作成
@@ -30,15 +96,5 @@ private:
 	/// <param name="rootNode"></param>
 	/// <returns></returns>
 	Skeleton CreateSkeleton(const Node& rootNode);
-
-
-	/// <summary>
-	/// アニメーションの適応
-	/// </summary>
-	/// <param name="skeleton"></param>
-	/// <param name="animation"></param>
-	/// <param name="animtionTime"></param>
-	void ApplyAnimation(const Animation& animation, float animationTime);
-
 };
 
@@ -1,27 +1,86 @@
 #include "ModelAnimation.h"
+#include <Engine/Frame/Frame.h>
 
-void ModelAnimation::Initialize(const std::string& directorypath, const std::string& filename)
+void ModelAnimation::Initialize(const std::string& directorypath, const std::string& filename, const std::string& clipName)
 {
 	directorypath_ = directorypath;
 	filename_ = filename;
 	animator_ = std::make_unique<Animator>();
 	bone_ = std::make_unique<Bone>();
 	skin_ = std::make_unique<Skin>();
-	animator_->Initialize(directorypath_, filename_);
+	animator_->Initialize(directorypath_, filename_, clipName);
+	InitializeSkeleton(false);
+}
+
+void ModelAnimation::Initialize(std::shared_ptr<const Animation> animation, bool isHeadless)
+{
+	animator_ = std::make_unique<Animator>();
+	bone_ = std::make_unique<Bone>();
+	skin_ = std::make_unique<Skin>();
+	animator_->SetAnimation(std::move(animation));
+	InitializeSkeleton(isHeadless);
+}
 
-	if (animator_->HaveAnimation()) {
-		bone_->Initialize(modelData_);
+void ModelAnimation::InitializeSkeleton(bool isHeadless)
+{
+	if (!animator_->HaveAnimation()) {
+		return;
+	}
+	bone_->Initialize(modelData_);
+	bone_->Bind(animator_->GetAnimation());
+	if (isHeadless) {
+		skin_->InitializeHeadless(bone_->GetSkeleton(), modelData_);
+	} else {
 		skin_->Initialize(bone_->GetSkeleton(), modelData_);
 	}
+	// 等方スケールだけのモデルは法線行列を安く作る
+	skin_->SetUniformScale(Skin::DetectUniformScale(bone_->GetSkeleton(), skin_->GetSkinCluster(), animator_->GetAnimation()));
 }
 
-void ModelAnimation::Update(bool roop)
+void ModelAnimation::AddBlendClip(const Animation &clip)
 {
-	if (animator_->HaveAnimation()) {
-		animator_->Update(roop);
-		bone_->Update(animator_->GetAnimation(), animator_->GetAnimationTime());
-		skin_->Update(bone_->GetSkeleton());
+	if (!animator_->HaveAnimation() || !skin_->IsUniformScale()) {
+		return;
+	}
+	skin_->SetUniformScale(Skin::DetectUniformScale(bone_->GetSkeleton(), skin_->GetSkinCluster(), clip));
+}
+
+void ModelAnimation::Update(bool roop, AnimationBlender* blender, AnimationLod* lod)
+{
+	if (!animator_->HaveAnimation()) {
+		return;
+	}
+	animator_->Update(roop);
+	const AnimationLodTier tier = lod ? lod->GetTier() : AnimationLodTier::Full;
+	if (tier == AnimationLodTier::Frozen) {
+		// 画面外は時間だけ進めて、姿勢とパレットは前のまま(フェードも止めずに進める)
+		if (blender && blender->IsActive()) {
+			blender->AdvanceTime(Frame::DeltaTime());
+		}
+		return;
+	}
+	if (tier == AnimationLodTier::Full) {
+		if (blender && blender->IsActive()) {
+			bone_->ApplyAnimation(animator_->GetAnimation(), animator_->GetAnimationTime());
+			blender->Update(Frame::DeltaTime(), bone_->GetLocalPose());
+			bone_->Solve();
+		} else {
+			bone_->Update(animator_->GetAnimation(), animator_->GetAnimationTime());
+		}
+	} else {
+		// 間引いたフレームだけサンプリング・ブレンドし、間は直近2つの姿勢を補間する
+		float sampleDeltaTime = 0.0f;
+		if (lod->Advance(Frame::DeltaTime(), sampleDeltaTime)) {
+			bone_->ApplyAnimation(animator_->GetAnimation(), animator_->GetAnimationTime(), lod->GetSkipJointHeight());
+			if (blender && blender->IsActive()) {
+				blender->Update(sampleDeltaTime, bone_->GetLocalPose());
+			}
+			lod->StorePose(bone_->GetLocalPose());
+		}
+		lod->Interpolate(bone_->GetLocalPose());
+		bone_->Solve();
 	}
+	skin_->Update(bone_->GetSkeleton());
 }
 
 void ModelAnimation::PlayAnimation()
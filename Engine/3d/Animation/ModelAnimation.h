@@ -1,4 +1,6 @@
 #pragma once
+#include "AnimationBlender.h"
+#include "AnimationLod.h"
 #include "Animator.h"
 #include "Bone.h"
 #include "Skin.h"
@@ -14,18 +16,39 @@ class ModelAnimation {
     ModelData modelData_;
 
   public:
-    void Initialize(const std::string &directorypath, const std::string &filename);
+    /// <summary>
+    /// 初期化(clipNameが空ならファイルの最初のクリップ)
+    /// </summary>
+    void Initialize(const std::string &directorypath, const std::string &filename, const std::string &clipName = "");
 
-    void Update(bool roop);
+    /// <summary>
+    /// 読み込み済みのクリップで初期化(isHeadlessならパレットをCPUの配列に書くだけで描画しない、ベンチマーク用)
+    /// </summary>
+    void Initialize(std::shared_ptr<const Animation> animation, bool isHeadless);
+
+    /// <summary>
+    /// 更新(blenderがあれば、再生中のクリップの姿勢にクロスフェード・レイヤーをブレンドしてから行列を求める)
+    /// lodがあれば、選ばれた段階に応じてサンプリングを間引く・止める
+    /// </summary>
+    void Update(bool roop, AnimationBlender *blender = nullptr, AnimationLod *lod = nullptr);
 
     void PlayAnimation();
 
-    void SetModelData(ModelData modelData) { modelData_ = modelData; }
-    Skeleton GetSkeletonData() { return bone_->GetSkeleton(); }
+    /// <summary>
+    /// ブレンドで混ざるクリップ(クロスフェード・レイヤー)の登録
+    /// 非等方スケールを含むなら法線行列を余因子で求める計算に戻す
+    /// </summary>
+    void AddBlendClip(const Animation &clip);
+
+    void SetModelData(const ModelData &modelData) { modelData_ = modelData; }
+    const Skeleton &GetSkeletonData() const { return bone_->GetSkeleton(); }
     Animator *GetAnimator() { return animator_.get(); }
     Bone *GetBone() { return bone_.get(); }
     Skin *GetSkin() { return skin_.get(); }
     bool IsFinish() { return animator_->IsFinish(); }
 
     void SetIsAnimation(bool anime) { animator_->SetIsAnimation(anime); }
+
+  private:
+    void InitializeSkeleton(bool isHeadless);
 };
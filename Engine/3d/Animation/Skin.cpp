@@ -1,8 +1,11 @@
 #include "Skin.h"
 #include <DirectXCommon.h>
 #include"Srv/SrvManager.h"
+#include "AnimationCompression.h"
 #include <myMath.h>
 #include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
 #include"algorithm"
 
 void Skin::Initialize(const Skeleton& skeleton, const ModelData& modelData)
@@ -10,15 +13,160 @@ void Skin::Initialize(const Skeleton& skeleton, const ModelData& modelData)
 	skinCluster_ = CreateSkinCluster(skeleton,modelData);
 }
 
+void Skin::InitializeHeadless(const Skeleton& skeleton, const ModelData& modelData)
+{
+	skinCluster_ = SkinCluster{};
+	headlessPalette_.assign(skeleton.joints.size(), WellForGPU{});
+	skinCluster_.mappedPalette = { headlessPalette_.data(), headlessPalette_.size() };
+	skinCluster_.inverseBindPoseMatrices.assign(skeleton.joints.size(), MakeIdentity4x4());
+	for (const auto& jointWeight : modelData.skinClusterData) {
+		auto it = skeleton.jointMap.find(jointWeight.first);
+		if (it != skeleton.jointMap.end()) {
+			skinCluster_.inverseBindPoseMatrices[(*it).second] = jointWeight.second.inverseBindPoseMatrix;
+		}
+	}
+}
+
 void Skin::Update(const Skeleton& skeleton)
 {
-	for (size_t jointIndex = 0; jointIndex < skeleton.joints.size(); ++jointIndex) {
-		assert(jointIndex < skinCluster_.inverseBindPoseMatrices.size());
-		skinCluster_.mappedPalette[jointIndex].skeletonSpaceMatrix =
-			skinCluster_.inverseBindPoseMatrices[jointIndex] * skeleton.joints[jointIndex].skeletonSpaceMatrix;
-		skinCluster_.mappedPalette[jointIndex].skeletonSpaceInverseTransposeMatrix =
-			Transpose(Inverse(skinCluster_.mappedPalette[jointIndex].skeletonSpaceMatrix));
+	assert(skeleton.modelMatrices.size() <= skinCluster_.inverseBindPoseMatrices.size());
+	BuildPalette(skinCluster_.inverseBindPoseMatrices.data(), skeleton.modelMatrices.data(), skeleton.modelMatrices.size(),
+		isUniformScale_, skinCluster_.mappedPalette.data());
+}
+
+namespace {
+// 3成分の内積(w成分は0の前提)
+float Dot3(__m128 a, __m128 b)
+{
+	__m128 product = _mm_mul_ps(a, b);
+	__m128 sum = _mm_add_ps(product, _mm_movehl_ps(product, product));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(sum);
+}
+
+__m128 Cross(__m128 a, __m128 b)
+{
+	__m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 result = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+	return _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+// 行ベクトル * アフィン行列(rowのw成分が0なら平行移動を含めない)
+__m128 TransformRow(__m128 row, __m128 m0, __m128 m1, __m128 m2, __m128 m3)
+{
+	__m128 result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), m0);
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), m1));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), m2));
+	return _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), m3));
+}
+
+bool IsUniform(const Vector3& scale)
+{
+	constexpr float kEpsilon = 1.0e-3f;
+	return std::abs(scale.x - scale.y) <= kEpsilon * std::abs(scale.x) && std::abs(scale.x - scale.z) <= kEpsilon * std::abs(scale.x);
+}
+} // namespace
+
+void Skin::BuildPalette(const Matrix4x4* inverseBindPoseMatrices, const Matrix4x4* modelMatrices, size_t count, bool isUniformScale, WellForGPU* palette)
+{
+	const __m128 lastRow = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+	for (size_t jointIndex = 0; jointIndex < count; ++jointIndex) {
+		// skeletonSpaceMatrix = inverseBindPose * model
+		const float* model = &modelMatrices[jointIndex].m[0][0];
+		const float* inverseBindPose = &inverseBindPoseMatrices[jointIndex].m[0][0];
+		__m128 m0 = _mm_loadu_ps(model + 0);
+		__m128 m1 = _mm_loadu_ps(model + 4);
+		__m128 m2 = _mm_loadu_ps(model + 8);
+		__m128 m3 = _mm_loadu_ps(model + 12);
+		__m128 r0 = TransformRow(_mm_loadu_ps(inverseBindPose + 0), m0, m1, m2, m3);
+		__m128 r1 = TransformRow(_mm_loadu_ps(inverseBindPose + 4), m0, m1, m2, m3);
+		__m128 r2 = TransformRow(_mm_loadu_ps(inverseBindPose + 8), m0, m1, m2, m3);
+		__m128 t = TransformRow(_mm_loadu_ps(inverseBindPose + 12), m0, m1, m2, m3);
+
+		float* out = &palette[jointIndex].skeletonSpaceMatrix.m[0][0];
+		_mm_storeu_ps(out + 0, r0);
+		_mm_storeu_ps(out + 4, r1);
+		_mm_storeu_ps(out + 8, r2);
+		_mm_storeu_ps(out + 12, t);
+
+		// アフィン行列 [A 0; t 1] の逆転置は [A^-T -(t・A^-Tの各行); 0 1]
+		__m128 c0, c1, c2;
+		if (isUniformScale) {
+			// A = sR なら A^-T = A / s^2
+			float lengthSq = Dot3(r0, r0);
+			__m128 inverse = _mm_set1_ps(lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f);
+			c0 = _mm_mul_ps(r0, inverse);
+			c1 = _mm_mul_ps(r1, inverse);
+			c2 = _mm_mul_ps(r2, inverse);
+		} else {
+			// A^-T = 余因子行列 / 行列式(余因子の各行は残り2行の外積)
+			c0 = Cross(r1, r2);
+			c1 = Cross(r2, r0);
+			c2 = Cross(r0, r1);
+			float determinant = Dot3(r0, c0);
+			__m128 inverse = _mm_set1_ps(determinant != 0.0f ? 1.0f / determinant : 0.0f);
+			c0 = _mm_mul_ps(c0, inverse);
+			c1 = _mm_mul_ps(c1, inverse);
+			c2 = _mm_mul_ps(c2, inverse);
+		}
+		alignas(16) float rows[3][4];
+		_mm_store_ps(rows[0], c0);
+		_mm_store_ps(rows[1], c1);
+		_mm_store_ps(rows[2], c2);
+		rows[0][3] = -Dot3(t, c0);
+		rows[1][3] = -Dot3(t, c1);
+		rows[2][3] = -Dot3(t, c2);
+
+		float* outInverseTranspose = &palette[jointIndex].skeletonSpaceInverseTransposeMatrix.m[0][0];
+		_mm_storeu_ps(outInverseTranspose + 0, _mm_load_ps(rows[0]));
+		_mm_storeu_ps(outInverseTranspose + 4, _mm_load_ps(rows[1]));
+		_mm_storeu_ps(outInverseTranspose + 8, _mm_load_ps(rows[2]));
+		_mm_storeu_ps(outInverseTranspose + 12, lastRow);
+	}
+}
+
+bool Skin::DetectUniformScale(const Skeleton& skeleton, const SkinCluster& skinCluster, const Animation& animation)
+{
+	for (const Vector3& scale : skeleton.localPose.scales) {
+		if (!IsUniform(scale)) {
+			return false;
+		}
+	}
+	for (const NodeAnimation& channel : animation.channels) {
+		for (const KeyframeVector3& keyframe : channel.scale) {
+			if (!IsUniform(keyframe.value)) {
+				return false;
+			}
+		}
+	}
+	for (const Vector3& scale : animation.resampled.scales) {
+		if (!IsUniform(scale)) {
+			return false;
+		}
+	}
+	for (const CompressedNodeAnimation& channel : animation.compressedChannels) {
+		for (uint32_t keyIndex = 0; keyIndex < channel.scale.times.size(); ++keyIndex) {
+			if (!IsUniform(AnimationCompression::Decode(channel.scale, keyIndex))) {
+				return false;
+			}
+		}
+	}
+	// 逆バインド行列の3x3が回転*等方スケールか(各行の長さが等しく直交)
+	constexpr float kEpsilon = 1.0e-3f;
+	for (const Matrix4x4& matrix : skinCluster.inverseBindPoseMatrices) {
+		Vector3 rows[3] = {{matrix.m[0][0], matrix.m[0][1], matrix.m[0][2]},
+		                   {matrix.m[1][0], matrix.m[1][1], matrix.m[1][2]},
+		                   {matrix.m[2][0], matrix.m[2][1], matrix.m[2][2]}};
+		float lengthSq = rows[0].Dot(rows[0]);
+		for (int i = 0; i < 3; ++i) {
+			if (std::abs(rows[i].Dot(rows[i]) - lengthSq) > kEpsilon * lengthSq ||
+				std::abs(rows[i].Dot(rows[(i + 1) % 3])) > kEpsilon * lengthSq) {
+				return false;
+			}
+		}
 	}
+	return true;
 }
 
 SkinCluster Skin::CreateSkinCluster(const Skeleton& skeleton, const ModelData& modelData)
@@ -1,16 +1,43 @@
 #pragma once
 #include <cstdint>
+#include <vector>
 #include"Model/ModelStructs.h"
 class Skin
 {
 private:
 	SkinCluster skinCluster_;
 	uint32_t skinClusterSrvIndex_ = 0;
+	bool isUniformScale_ = false; // 全Jointが等方スケールなら逆転置の計算を省く
+	std::vector<WellForGPU> headlessPalette_; // ヘッドレス時のパレットの書き込み先
 public:
 	void Initialize(const Skeleton& skeleton, const ModelData& modelData);
+	// GPUリソースを作らず、パレットをCPUの配列に書き込むだけの初期化(ベンチマーク用、描画しない)
+	void InitializeHeadless(const Skeleton& skeleton, const ModelData& modelData);
 	void Update(const Skeleton& skeleton);
 	uint32_t GetSrvIndex() { return skinClusterSrvIndex_; }
-	SkinCluster GetSkinCluster() { return skinCluster_; }
+	const SkinCluster& GetSkinCluster() const { return skinCluster_; }
+
+	/// <summary>
+	/// 等方スケールとして扱うか(逆転置を 3x3 / スケールの2乗 で求める)
+	/// </summary>
+	void SetUniformScale(bool isUniformScale) { isUniformScale_ = isUniformScale; }
+	bool IsUniformScale() const { return isUniformScale_; }
+
+	/// <summary>
+	/// パレットの生成(inverseBindPose * model と、その逆転置)
+	/// 行列はどちらもアフィンとして3x3の部分だけで逆転置を求める(SSE)
+	/// </summary>
+	/// <param name="inverseBindPoseMatrices"></param>
+	/// <param name="modelMatrices"></param>
+	/// <param name="count"></param>
+	/// <param name="isUniformScale">等方スケールなら余因子を使わず 3x3 / スケールの2乗 にする</param>
+	/// <param name="palette"></param>
+	static void BuildPalette(const Matrix4x4* inverseBindPoseMatrices, const Matrix4x4* modelMatrices, size_t count, bool isUniformScale, WellForGPU* palette);
+
+	/// <summary>
+	/// 初期姿勢・逆バインド行列・クリップのスケールがすべて等方か
+	/// </summary>
+	static bool DetectUniformScale(const Skeleton& skeleton, const SkinCluster& skinCluster, const Animation& animation);
 private:
 	/// <summary>
 	/// SkinClusterの生成
@@ -51,20 +51,31 @@ struct Node {
     std::vector<Node> children;
 };
 
+// Jointの構造情報(読み込み時のみ使う。毎フレームの姿勢はSkeletonの配列側に持つ)
 struct Joint {
-    QuaternionTransform transform;
-    Matrix4x4 localMatrix;
-    Matrix4x4 skeletonSpaceMatrix;
+    QuaternionTransform transform; // 初期姿勢
     std::string name;
     std::vector<int32_t> children;
     int32_t index;
     std::optional<int32_t> parent;
 };
 
+// Jointごとのローカルの姿勢(SoA、Jointと同じ並び)
+struct SkeletonLocalPose {
+    std::vector<Vector3> translates;
+    std::vector<Quaternion> rotates;
+    std::vector<Vector3> scales;
+};
+
 struct Skeleton {
     int32_t root;
     std::map<std::string, int32_t> jointMap;
-    std::vector<Joint> joints;
+    std::vector<Joint> joints; // 親が先に並ぶ
+
+    // 毎フレーム更新する姿勢(jointsと同じ並びの平坦な配列)
+    std::vector<int32_t> parents;         // 親のindex(ルートは-1)
+    SkeletonLocalPose localPose;          // ローカルのTRS
+    std::vector<Matrix4x4> modelMatrices; // スケルトン空間の行列
 };
 
 struct VertexWeightData {
@@ -122,9 +133,47 @@ struct NodeAnimation {
     std::vector<KeyframeVector3> scale;
 };
 
+// 圧縮したVector3のトラック(値はトラックの範囲に対して各成分16bitに量子化)
+struct CompressedTrackVector3 {
+    std::vector<float> times;
+    std::vector<std::array<uint16_t, 3>> values;
+    std::vector<Vector3> rawValues; // 量子化すると許容誤差に収まらないトラックは元の値で持つ(valuesは空)
+    Vector3 minimum;
+    Vector3 step; // 量子化1段あたりの値((最大 - 最小) / 65535)
+};
+
+// 圧縮したQuaternionのトラック(smallest-three 48bit)
+struct CompressedTrackQuaternion {
+    std::vector<float> times;
+    std::vector<std::array<uint16_t, 3>> values;
+    std::vector<Quaternion> rawValues; // 量子化すると許容誤差に収まらないトラックは元の値で持つ(valuesは空)
+};
+
+struct CompressedNodeAnimation {
+    CompressedTrackVector3 translate;
+    CompressedTrackQuaternion rotate;
+    CompressedTrackVector3 scale;
+};
+
+// 一定間隔でサンプリングし直したクリップ(時刻からフレームを直接求めるので探索しない)
+// 各配列は[channel * frameCount + frame]のJointごとに連続した並び
+struct ResampledAnimation {
+    uint32_t frameCount = 0;     // 0なら未使用(2以上)
+    float framesPerSecond = 0.0f; // (frameCount - 1) / duration
+    std::vector<Vector3> translates;
+    std::vector<Quaternion> rotates; // 隣のフレームと同じ半球にそろえてある(nlerpで補間できる)
+    std::vector<Vector3> scales;
+};
+
 struct Animation {
-    float duration;
-    std::map<std::string, NodeAnimation> nodeAnimations;
+    float duration = 0.0f;
+    // ノードごとのアニメーション(読み込み順の配列。名前からJointへの解決はBone::Bindで1回だけ行う)
+    std::vector<std::string> channelNames;
+    std::vector<NodeAnimation> channels;
+    // 圧縮済みのチャンネル(空でなければchannelsの代わりにこちらを使う。channelNamesと同じ並び)
+    std::vector<CompressedNodeAnimation> compressedChannels;
+    // 一定間隔にサンプリングし直したもの(frameCountが0でなければ他より優先する)
+    ResampledAnimation resampled;
 };
 
 struct ParticleForGPU {
@@ -135,6 +184,7 @@ struct ParticleForGPU {
 
 struct Particle {
     WorldTransform transform; // 位置
+    Vector3 prevTranslation;  // 前ステップの位置(描画補間用)
     Vector3 emitterPosition;
     Vector3 velocity; // 速度
     Vector3 Acce;
@@ -150,19 +200,11 @@ struct Particle {
     float lifeTime;    // ライフタイム
     float currentTime; // 現在の時間
     float initialAlpha;
-    //std::weak_ptr<Particle> parent;                  // 親パーティクルへの弱参照
-    //std::vector<std::shared_ptr<Particle>> children; // 子パーティクルのリスト
-    Vector3 relativePosition;                        // 親からの相対位置
-    Vector3 parentOffset;                            // 親に対するオフセット
-    bool isChild;                                    // 子パーティクルかどうか
-    bool createTrail;                                // 軌跡を作成するか
-    float trailSpawnTimer;                           // 軌跡生成のタイマー
-    float trailSpawnInterval;                        // 軌跡生成間隔
-    int maxChildren;                                 // 最大子供数
-    float childLifeScale;                            // 子の寿命スケール（親より短く）
+    int32_t trailSlot;     // 軌跡スロット(ParticleTrail内のインデックス)
+    float trailSpawnTimer; // 軌跡点生成のタイマー
+    bool isStuck;          // 当たり判定で張り付いたか(以降は移動しない)
 
-    Particle() : isChild(false), createTrail(false), trailSpawnTimer(0.0f),
-                 trailSpawnInterval(0.1f), maxChildren(10), childLifeScale(0.8f) {}
+    Particle() : trailSlot(-1), trailSpawnTimer(0.0f), isStuck(false) {}
 };
 
 struct ParticleGroupData {
@@ -170,14 +212,8 @@ struct ParticleGroupData {
     std::vector<MaterialData> materials;
     // パーティクルのリスト (std::list<Particle> 型)
     std::list<Particle> particles;
-    // インスタンシングデータ用SRVインデックス
-    uint32_t instancingSRVIndex = 0;
-    // インスタンシングリソース
-    Microsoft::WRL::ComPtr<ID3D12Resource> instancingResource = nullptr;
-    // インスタンス数
+    // インスタンス数(インスタンシングデータはParticleGroupが借りるページに書き込む)
     uint32_t instanceCount = 0;
-    // インスタンシングデータを書き込むためのポインタ
-    ParticleForGPU *instancingData = nullptr;
     // グループ名
     std::string groupName;
 };
@@ -1,5 +1,6 @@
 #include "BaseObjectManager.h"
 #include"ImGui/ImGuizmoManager.h"
+#include "Animation/AnimationUpdateQueue.h"
 
 BaseObjectManager *BaseObjectManager::instance = nullptr;
 
@@ -26,10 +27,19 @@ void BaseObjectManager::AddObject(std::unique_ptr<BaseObject> baseObject) {
     baseObjects_.emplace(name, std::move(baseObject));
 }
 
-void BaseObjectManager::Update() {
+void BaseObjectManager::Update(const ViewProjection *viewProjection) {
+    // アニメーションの更新は積んでおき、全オブジェクトの更新後にまとめて並列に行う
+    // (同じUpdateの中では前のフレームの姿勢が見える)
+    AnimationUpdateQueue::GetInstance()->Begin();
     for (auto &[name, obj] : baseObjects_) {
         obj->Update();
+        // 積んだ更新はFlushで行うので、ここで選んだ段階が使われる
+        if (viewProjection) {
+            obj->SelectAnimationLod(*viewProjection);
+        }
     }
+    // 描画コマンドを積む前に、パレットの書き込みまで終わらせる
+    AnimationUpdateQueue::GetInstance()->Flush();
 }
 
 void BaseObjectManager::Draw(const ViewProjection &viewProjection, Vector3 offSet) {
@@ -24,7 +24,10 @@ class BaseObjectManager {
 
     void AddObject(std::unique_ptr<BaseObject> baseObject);
 
-    void Update();
+    /// <summary>
+    /// 更新(viewProjectionがあれば、アニメーションのLODをそのカメラで選ぶ)
+    /// </summary>
+    void Update(const ViewProjection *viewProjection = nullptr);
 
     void Draw(const ViewProjection &viewProjection, Vector3 offSet = {0.0f, 0.0f, 0.0f});
 
@@ -1,5 +1,7 @@
 #include "Object3d.h"
 #include "Object3dCommon.h"
+#include "Animation/AnimationLibrary.h"
+#include "Animation/AnimationUpdateQueue.h"
 #include "cassert"
 #include "myMath.h"
 #include <Engine/Frame/Frame.h>
@@ -37,6 +39,7 @@ void Object3d::CreateModel(const std::string &filePath) {
         model->SetAnimator(currentModelAnimation_->GetAnimator());
         model->SetBone(currentModelAnimation_->GetBone());
         model->SetSkin(currentModelAnimation_->GetSkin());
+        InitializeAnimationBlender();
     }
 }
 
@@ -66,23 +69,45 @@ void Object3d::Update(const WorldTransform &worldTransform, const ViewProjection
 }
 
 void Object3d::AnimationUpdate(bool roop) {
-    if (currentModelAnimation_) {
-        currentModelAnimation_->Update(roop);
+    isAnimationLoop_ = roop;
+    if (!currentModelAnimation_) {
+        return;
+    }
+    // BaseObjectManager::Updateの中なら、後でまとめて並列に更新される
+    // LODの履歴はスケルトンと同じ大きさで用意したときだけ使う
+    AnimationLod *lod = animationBlender_ ? &animationLod_ : nullptr;
+    if (AnimationUpdateQueue::GetInstance()->Push(currentModelAnimation_.get(), roop, animationBlender_.get(), lod)) {
+        return;
     }
+    currentModelAnimation_->Update(roop, animationBlender_.get(), lod);
 }
 
-void Object3d::SetAnimation(const std::string &fileName) {
+void Object3d::SetAnimation(const std::string &fileName, const std::string &clipName) {
+    // ファイル名とクリップ名からmodelAnimations_のキーを作る
+    const std::string key = clipName.empty() ? fileName : fileName + "#" + clipName;
+
     // すでにセット済みのアニメーションなら何もしない
-    if (fileName == filePath_) {
+    if (key == filePath_) {
         return;
     }
 
-    // modelAnimations_ 内に fileName に対応するアニメーションがあるか検索
-    auto it = modelAnimations_.find(fileName);
+    // modelAnimations_ 内に key に対応するアニメーションがあるか検索
+    auto it = modelAnimations_.find(key);
 
     // アニメーションが見つからなかった場合、強制的にプログラムを停止
     assert(it != modelAnimations_.end() && "Error: Animation file not found in modelAnimations_!");
 
+    // 切り替え前のクリップを、今の時刻からフェードアウトさせる
+    if (animationBlender_ && currentModelAnimation_ && currentModelAnimation_ != it->second &&
+        currentModelAnimation_->GetAnimator()->HaveAnimation()) {
+        const Animator *previous = currentModelAnimation_->GetAnimator();
+        animationBlender_->StartCrossfade(previous->GetSharedAnimation(), previous->GetAnimationTime(), isAnimationLoop_, crossfadeTime_);
+    }
+    // フェードアウト中・レイヤーのクリップは切り替え先のスキンに混ざる
+    if (animationBlender_) {
+        animationBlender_->ForEachClip([&](const Animation &clip) { it->second->AddBlendClip(clip); });
+    }
+
     // 見つかったアニメーションを shared_ptr に格納
     currentModelAnimation_ = it->second;
 
@@ -94,17 +119,66 @@ void Object3d::SetAnimation(const std::string &fileName) {
     currentModelAnimation_->GetAnimator()->SetAnimationTime(0.0f);
 
     // ファイルパスを更新
-    filePath_ = fileName;
+    filePath_ = key;
 }
 
-void Object3d::AddAnimation(const std::string &fileName) {
+void Object3d::AddAnimation(const std::string &fileName, const std::string &clipName) {
     auto animation = std::make_unique<ModelAnimation>();
 
+    // クリップはAnimationLibraryで共有されるので、同じファイルを何度追加してもファイルは1回しか読まない
     animation->SetModelData(model->GetModelData());
-    animation->Initialize("resources/models/", fileName);
+    animation->Initialize("resources/models/", fileName, clipName);
     animation->GetAnimator()->SetAnimationTime(0.0f);
 
-    modelAnimations_.emplace(fileName, std::move(animation));
+    modelAnimations_.emplace(clipName.empty() ? fileName : fileName + "#" + clipName, std::move(animation));
+}
+
+uint32_t Object3d::AddAnimationLayer(const std::string &rootJointName) {
+    if (!animationBlender_) {
+        return UINT32_MAX;
+    }
+    uint32_t layer = animationBlender_->AddLayer();
+    if (!rootJointName.empty()) {
+        animationBlender_->SetLayerMask(layer, rootJointName);
+    }
+    return layer;
+}
+
+void Object3d::SetAnimationLayer(uint32_t layer, const std::string &fileName, const std::string &clipName, float weight, float fadeTime,
+                                 bool isLoop) {
+    if (!animationBlender_) {
+        return;
+    }
+    AnimationLibrary *library = AnimationLibrary::GetInstance();
+    std::shared_ptr<const Animation> clip = library->GetClip(library->Find("resources/models/", fileName, clipName));
+    // 再生中のスキンに混ざる(他のクリップはSetAnimationで切り替えたときに確かめる)
+    if (clip && currentModelAnimation_) {
+        currentModelAnimation_->AddBlendClip(*clip);
+    }
+    animationBlender_->SetLayerClip(layer, std::move(clip), isLoop);
+    animationBlender_->SetLayerWeight(layer, weight, fadeTime);
+}
+
+void Object3d::SetAnimationLayerWeight(uint32_t layer, float weight, float fadeTime) {
+    if (animationBlender_) {
+        animationBlender_->SetLayerWeight(layer, weight, fadeTime);
+    }
+}
+
+void Object3d::InitializeAnimationBlender() {
+    // スキンのあるモデルだけ(スケルトンはモデルごとに共通)
+    animationBlender_.reset();
+    if (currentModelAnimation_ && currentModelAnimation_->GetAnimator()->HaveAnimation()) {
+        animationBlender_ = std::make_unique<AnimationBlender>();
+        animationBlender_->Initialize(currentModelAnimation_->GetSkeletonData());
+        animationLod_.Initialize(currentModelAnimation_->GetSkeletonData());
+    }
+}
+
+void Object3d::SelectAnimationLod(const WorldTransform &worldTransform, const ViewProjection &viewProjection) {
+    if (animationBlender_) {
+        animationLod_.Select(worldTransform.matWorld_, viewProjection);
+    }
 }
 
 void Object3d::DrawWireframe(const WorldTransform &worldTransform, const ViewProjection &viewProjection) {
@@ -265,24 +339,29 @@ void Object3d::Draw(const WorldTransform &worldTransform, const ViewProjection &
     }
 }
 
+const Skeleton *Object3d::GetSkeleton() const {
+    if (!currentModelAnimation_ || !currentModelAnimation_->GetAnimator()->HaveAnimation()) {
+        return nullptr;
+    }
+    return &currentModelAnimation_->GetSkeletonData();
+}
+
 void Object3d::DrawSkeleton(const WorldTransform &worldTransform, const ViewProjection &viewProjection) {
     Update(worldTransform, viewProjection);
     // スケルトンデータを取得
     const Skeleton &skeleton = currentModelAnimation_->GetSkeletonData();
 
     // 各ジョイントを巡回して親子関係の線を生成
-    for (const auto &joint : skeleton.joints) {
+    for (size_t jointIndex = 0; jointIndex < skeleton.parents.size(); ++jointIndex) {
         // 親がいない場合、このジョイントはルートなのでスキップ
-        if (!joint.parent.has_value()) {
+        const int32_t parentIndex = skeleton.parents[jointIndex];
+        if (parentIndex < 0) {
             continue;
         }
 
-        // 親ジョイントを取得
-        const auto &parentJoint = skeleton.joints[*joint.parent];
-
         // 親と子のスケルトン空間座標を取得
-        Vector3 parentPosition = ExtractTranslation(parentJoint.skeletonSpaceMatrix);
-        Vector3 childPosition = ExtractTranslation(joint.skeletonSpaceMatrix);
+        Vector3 parentPosition = ExtractTranslation(skeleton.modelMatrices[parentIndex]);
+        Vector3 childPosition = ExtractTranslation(skeleton.modelMatrices[jointIndex]);
 
         // 線の色を設定（デフォルトで白色）
         Vector4 lineColor = {1.0f, 1.0f, 1.0f, 1.0f};
@@ -307,6 +386,7 @@ void Object3d::SetModel(const std::string &filePath) {
         model->SetAnimator(currentModelAnimation_->GetAnimator());
         model->SetBone(currentModelAnimation_->GetBone());
         model->SetSkin(currentModelAnimation_->GetSkin());
+        InitializeAnimationBlender();
     }
 }
 
@@ -45,6 +45,11 @@ class Object3d {
     Model *model = nullptr;
     std::shared_ptr<ModelAnimation> currentModelAnimation_ = nullptr;
     std::map<std::string, std::shared_ptr<ModelAnimation>> modelAnimations_;
+    // クリップの切り替え・レイヤーのブレンド(モデルのスケルトンは共通なのでアニメーション間で共有する)
+    std::unique_ptr<AnimationBlender> animationBlender_;
+    float crossfadeTime_ = 0.2f; // SetAnimationでのクロスフェードの時間(0なら即座に切り替える)
+    bool isAnimationLoop_ = true; // 直近のAnimationUpdateのループ指定(フェードアウトするクリップにも使う)
+    AnimationLod animationLod_;   // 画面上の大きさによる間引き(スキンのあるモデルのみ使う)
     ModelCommon *modelCommon = nullptr;
     LightGroup *lightGroup = nullptr;
 
@@ -76,6 +81,8 @@ class Object3d {
 
     /// <summary>
     /// アニメーションの更新
+    /// BaseObjectManager::Updateの中から呼ばれた場合は、全オブジェクトの更新後にワーカースレッドで並列に更新される
+    /// LODの段階が選ばれていれば、それに応じて間引く
     /// </summary>
     void AnimationUpdate(bool roop);
 
@@ -89,13 +96,49 @@ class Object3d {
     /// アニメーションのセット
     /// </summary>
     /// <param name="fileName"></param>
-    void SetAnimation(const std::string &fileName);
+    /// <param name="clipName">AddAnimationで指定したクリップ名(空ならファイルの最初のクリップ)</param>
+    void SetAnimation(const std::string &fileName, const std::string &clipName = "");
 
     /// <summary>
     /// アニメーション追加
     /// </summary>
     /// <param name="fileName"></param>
-    void AddAnimation(const std::string &fileName);
+    /// <param name="clipName">ファイル内のクリップ名(空ならファイルの最初のクリップ)</param>
+    void AddAnimation(const std::string &fileName, const std::string &clipName = "");
+
+    /// <summary>
+    /// SetAnimationでのクロスフェードの時間
+    /// </summary>
+    void SetCrossfadeTime(float crossfadeTime) { crossfadeTime_ = crossfadeTime; }
+
+    /// <summary>
+    /// アニメーションのレイヤー追加(rootJointName以下のJointだけに重ねる。空なら全身)
+    /// </summary>
+    /// <returns>レイヤー番号(スキンの無いモデルでは無効な値)</returns>
+    uint32_t AddAnimationLayer(const std::string &rootJointName = "");
+
+    /// <summary>
+    /// レイヤーで再生するクリップと重みの設定(fadeTime秒かけて重みを変える)
+    /// </summary>
+    void SetAnimationLayer(uint32_t layer, const std::string &fileName, const std::string &clipName, float weight, float fadeTime = 0.0f,
+                           bool isLoop = true);
+
+    /// <summary>
+    /// レイヤーの重みだけ変える
+    /// </summary>
+    void SetAnimationLayerWeight(uint32_t layer, float weight, float fadeTime = 0.0f);
+
+    /// <summary>
+    /// アニメーションのLODの設定
+    /// </summary>
+    void SetAnimationLodSettings(const AnimationLodSettings &settings) { animationLod_.SetSettings(settings); }
+    const AnimationLodSettings &GetAnimationLodSettings() const { return animationLod_.GetSettings(); }
+
+    /// <summary>
+    /// カメラから見た大きさでアニメーションのLODの段階を選ぶ(次に行われるアニメーションの更新から使う)
+    /// </summary>
+    void SelectAnimationLod(const WorldTransform &worldTransform, const ViewProjection &viewProjection);
+    const AnimationLod &GetAnimationLod() const { return animationLod_; }
 
     void DrawWireframe(const WorldTransform &worldTransform, const ViewProjection &viewProjection);
 
@@ -122,6 +165,8 @@ class Object3d {
         return materials_[index]->GetMaterialDataGPU()->textureFilePath;
     }
     const bool &GetHaveAnimation() const { return HaveAnimation; }
+    // 再生中のアニメーションのスケルトン(アニメーションが無ければnullptr)
+    const Skeleton *GetSkeleton() const;
     bool IsFinish() { return currentModelAnimation_->IsFinish(); }
 
     // マルチマテリアル用のgetter
@@ -170,6 +215,11 @@ class Object3d {
     /// </summary>
     void InitializeMaterials();
 
+    /// <summary>
+    /// アニメーションのブレンド・LODの初期化(スキンのあるモデルのみ)
+    /// </summary>
+    void InitializeAnimationBlender();
+
     /// <summary>
     /// マテリアルインデックス検証
     /// </summary>
@@ -0,0 +1,53 @@
+#include "InstancePageAllocator.h"
+#include <algorithm>
+#include <cassert>
+
+InstancePageAllocator::InstancePageAllocator(uint32_t instancesPerPage)
+    : instancesPerPage_(std::max(instancesPerPage, 1u)) {
+}
+
+uint32_t InstancePageAllocator::Acquire() {
+    if (!freePages_.empty()) {
+        uint32_t page = freePages_.back();
+        freePages_.pop_back();
+        return page;
+    }
+    return pageCount_++;
+}
+
+void InstancePageAllocator::Release(uint32_t page) {
+    assert(page < pageCount_);
+    freePages_.push_back(page);
+}
+
+void InstancePageTable::Resize(InstancePageAllocator &allocator, uint32_t instanceCount) {
+    const uint32_t required = allocator.PagesFor(instanceCount);
+    if (required > pages_.size()) {
+        while (pages_.size() < required) {
+            pages_.push_back(allocator.Acquire());
+        }
+        shrinkFrames_ = 0;
+        return;
+    }
+    if (required == pages_.size()) {
+        shrinkFrames_ = 0;
+        return;
+    }
+    // 一時的な減少で借り直さないよう、しばらく続いてから返す
+    if (++shrinkFrames_ < kTrimDelayFrames) {
+        return;
+    }
+    while (pages_.size() > required) {
+        allocator.Release(pages_.back());
+        pages_.pop_back();
+    }
+    shrinkFrames_ = 0;
+}
+
+void InstancePageTable::ReleaseAll(InstancePageAllocator &allocator) {
+    for (uint32_t page : pages_) {
+        allocator.Release(page);
+    }
+    pages_.clear();
+    shrinkFrames_ = 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// インスタンスデータのページ番号の管理(GPUには触れない)
+/// 返却されたページは次の取得で使い回し、空きが無いときだけ新しい番号を払い出す
+/// </summary>
+class InstancePageAllocator {
+  public:
+    explicit InstancePageAllocator(uint32_t instancesPerPage);
+
+    /// <summary>
+    /// ページの取得(空きが無ければ新しい番号 = 取得前のGetPageCount())
+    /// </summary>
+    uint32_t Acquire();
+
+    /// <summary>
+    /// ページの返却
+    /// </summary>
+    void Release(uint32_t page);
+
+    /// <summary>
+    /// instanceCount個を入れるのに必要なページ数
+    /// </summary>
+    uint32_t PagesFor(uint32_t instanceCount) const { return (instanceCount + instancesPerPage_ - 1) / instancesPerPage_; }
+
+    uint32_t GetInstancesPerPage() const { return instancesPerPage_; }
+    // これまでに払い出した番号の数(実体を作る必要があるページ数)
+    uint32_t GetPageCount() const { return pageCount_; }
+    uint32_t GetFreePageCount() const { return static_cast<uint32_t>(freePages_.size()); }
+    uint32_t GetUsedPageCount() const { return pageCount_ - GetFreePageCount(); }
+
+  private:
+    uint32_t instancesPerPage_;
+    uint32_t pageCount_ = 0;
+    std::vector<uint32_t> freePages_;
+};
+
+/// <summary>
+/// 1グループが借りているページの一覧
+/// 必要数が増えたらすぐ借り、減った状態がkTrimDelayFrames続いたら余りを返す(0なら全部返す)
+/// </summary>
+class InstancePageTable {
+  public:
+    static constexpr uint32_t kTrimDelayFrames = 120;
+
+  public:
+    /// <summary>
+    /// instanceCount個を書き込めるようページをそろえる(毎フレーム呼ぶ)
+    /// </summary>
+    void Resize(InstancePageAllocator &allocator, uint32_t instanceCount);
+
+    /// <summary>
+    /// 借りているページを全部返す
+    /// </summary>
+    void ReleaseAll(InstancePageAllocator &allocator);
+
+    const std::vector<uint32_t> &GetPages() const { return pages_; }
+    uint32_t GetPageCount() const { return static_cast<uint32_t>(pages_.size()); }
+
+  private:
+    std::vector<uint32_t> pages_;
+    uint32_t shrinkFrames_ = 0; // 必要数が借りている数を下回っているフレーム数
+};
@@ -0,0 +1,253 @@
+#include "MeshSurfaceSampler.h"
+#include "Model/ModelManager.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <myMath.h>
+
+std::unordered_map<std::string, std::unique_ptr<MeshSurfaceSampler>> MeshSurfaceSampler::cache_;
+
+const MeshSurfaceSampler *MeshSurfaceSampler::Load(const std::string &filePath) {
+    const std::string prefix = kPrimitivePrefix;
+    if (filePath.rfind(prefix, 0) == 0) {
+        const std::string name = filePath.substr(prefix.size());
+        for (size_t i = 0; i < std::size(kPrimitiveNames); ++i) {
+            if (name == kPrimitiveNames[i]) {
+                // PrimitiveTypeはNoneの次から同じ順に並んでいる
+                return LoadPrimitive(static_cast<PrimitiveType>(i + 1));
+            }
+        }
+        return nullptr;
+    }
+    auto it = cache_.find(filePath);
+    if (it != cache_.end()) {
+        return it->second.get();
+    }
+    ModelManager::GetInstance()->LoadModel(filePath);
+    Model *model = ModelManager::GetInstance()->FindModel(filePath);
+    if (!model) {
+        return nullptr;
+    }
+    auto sampler = std::make_unique<MeshSurfaceSampler>();
+    sampler->Build(model->GetModelData());
+    return cache_.emplace(filePath, std::move(sampler)).first->second.get();
+}
+
+const MeshSurfaceSampler *MeshSurfaceSampler::LoadPrimitive(PrimitiveType type) {
+    std::string key = "Primitive_" + std::to_string(static_cast<int>(type));
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        return it->second.get();
+    }
+    Model *model = ModelManager::GetInstance()->FindModel(ModelManager::GetInstance()->CreatePrimitiveModel(type));
+    if (!model) {
+        return nullptr;
+    }
+    auto sampler = std::make_unique<MeshSurfaceSampler>();
+    sampler->Build(model->GetModelData());
+    return cache_.emplace(key, std::move(sampler)).first->second.get();
+}
+
+std::string MeshSurfaceSampler::GetPrimitivePath(PrimitiveType type) {
+    const size_t index = static_cast<size_t>(type) - 1;
+    if (type == PrimitiveType::None || index >= std::size(kPrimitiveNames)) {
+        return std::string();
+    }
+    return std::string(kPrimitivePrefix) + kPrimitiveNames[index];
+}
+
+void MeshSurfaceSampler::ClearCache() {
+    cache_.clear();
+}
+
+void MeshSurfaceSampler::Build(const ModelData &modelData) {
+    positions_.clear();
+    normals_.clear();
+    triangles_.clear();
+    influences_.clear();
+    inverseBindPoseMatrices_.clear();
+
+    // 全メッシュの頂点を通し番号にまとめる
+    std::vector<uint32_t> meshVertexOffsets;
+    for (const MeshData &mesh : modelData.meshes) {
+        uint32_t offset = static_cast<uint32_t>(positions_.size());
+        meshVertexOffsets.push_back(offset);
+        for (const VertexData &vertex : mesh.vertices) {
+            positions_.push_back({vertex.position.x, vertex.position.y, vertex.position.z});
+            normals_.push_back(vertex.normal);
+        }
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            triangles_.push_back({{offset + mesh.indices[i], offset + mesh.indices[i + 1], offset + mesh.indices[i + 2]}});
+        }
+    }
+
+    // 面積を重みにする(つぶれた三角形は選ばれない)
+    std::vector<float> areas(triangles_.size());
+    totalArea_ = 0.0f;
+    for (size_t i = 0; i < triangles_.size(); ++i) {
+        const Vector3 &p0 = positions_[triangles_[i].index[0]];
+        const Vector3 &p1 = positions_[triangles_[i].index[1]];
+        const Vector3 &p2 = positions_[triangles_[i].index[2]];
+        areas[i] = (p1 - p0).Cross(p2 - p0).Length() * 0.5f;
+        totalArea_ += areas[i];
+    }
+    BuildAliasTable(areas);
+
+    if (modelData.skinClusterData.empty()) {
+        return;
+    }
+
+    // ジョイント番号はBone::CreateJointと同じ前順で振られる
+    std::unordered_map<std::string, int32_t> jointMap;
+    std::function<void(const Node &)> collectJoints = [&](const Node &node) {
+        jointMap.emplace(node.name, static_cast<int32_t>(jointMap.size()));
+        for (const Node &child : node.children) {
+            collectJoints(child);
+        }
+    };
+    collectJoints(modelData.rootNode);
+
+    influences_.assign(positions_.size(), VertexInfluence{});
+    inverseBindPoseMatrices_.assign(jointMap.size(), MakeIdentity4x4());
+    for (const auto &[jointName, jointWeight] : modelData.skinClusterData) {
+        auto it = jointMap.find(jointName);
+        if (it == jointMap.end()) {
+            continue;
+        }
+        inverseBindPoseMatrices_[it->second] = jointWeight.inverseBindPoseMatrix;
+        for (const VertexWeightData &vertexWeight : jointWeight.vertexWeights) {
+            if (vertexWeight.meshIndex >= meshVertexOffsets.size()) {
+                continue;
+            }
+            size_t vertex = meshVertexOffsets[vertexWeight.meshIndex] + vertexWeight.vertexIndex;
+            if (vertex >= influences_.size()) {
+                continue;
+            }
+            VertexInfluence &influence = influences_[vertex];
+            for (uint32_t index = 0; index < kNumMaxInfluence; ++index) {
+                if (influence.weights[index] == 0.0f) {
+                    influence.weights[index] = vertexWeight.weight;
+                    influence.jointIndices[index] = it->second;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void MeshSurfaceSampler::BuildAliasTable(const std::vector<float> &areas) {
+    size_t count = areas.size();
+    probabilities_.assign(count, 1.0f);
+    aliases_.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        aliases_[i] = i;
+    }
+    if (count == 0 || totalArea_ <= 0.0f) {
+        return;
+    }
+
+    // Voseの方法: 平均より小さい列を大きい列で埋める
+    std::vector<float> scaled(count);
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (uint32_t i = 0; i < count; ++i) {
+        scaled[i] = areas[i] * static_cast<float>(count) / totalArea_;
+        (scaled[i] < 1.0f ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        uint32_t less = small.back();
+        small.pop_back();
+        uint32_t more = large.back();
+        probabilities_[less] = scaled[less];
+        aliases_[less] = more;
+        scaled[more] -= 1.0f - scaled[less];
+        if (scaled[more] < 1.0f) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // 誤差で残った列は確率1
+    for (uint32_t i : small) {
+        probabilities_[i] = 1.0f;
+    }
+    for (uint32_t i : large) {
+        probabilities_[i] = 1.0f;
+    }
+}
+
+MeshSurfaceSampler::Sample MeshSurfaceSampler::SampleSurface(const std::array<float, 3> &random, const std::vector<Matrix4x4> *palette) const {
+    Sample sample{{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+    if (triangles_.empty()) {
+        return sample;
+    }
+
+    // 列の選択と、列内の確率で本体かエイリアスかを決める
+    float column = random[0] * static_cast<float>(triangles_.size());
+    uint32_t index = std::min(static_cast<uint32_t>(column), static_cast<uint32_t>(triangles_.size() - 1));
+    if (column - static_cast<float>(index) >= probabilities_[index]) {
+        index = aliases_[index];
+    }
+    const Triangle &triangle = triangles_[index];
+
+    // 三角形内で一様な重心座標
+    float root = std::sqrt(random[1]);
+    float b0 = 1.0f - root;
+    float b1 = root * (1.0f - random[2]);
+    float b2 = root * random[2];
+
+    bool isSkinned = palette && !influences_.empty() && !palette->empty();
+    Vector3 p[3];
+    Vector3 n[3];
+    for (int i = 0; i < 3; ++i) {
+        uint32_t vertex = triangle.index[i];
+        p[i] = isSkinned ? SkinPosition(vertex, *palette) : positions_[vertex];
+        n[i] = isSkinned ? SkinNormal(vertex, *palette) : normals_[vertex];
+    }
+    sample.position = p[0] * b0 + p[1] * b1 + p[2] * b2;
+    Vector3 normal = n[0] * b0 + n[1] * b1 + n[2] * b2;
+    if (normal.LengthSq() > 0.0f) {
+        sample.normal = normal.Normalize();
+    }
+    return sample;
+}
+
+void MeshSurfaceSampler::ComputePalette(const Skeleton &skeleton, std::vector<Matrix4x4> &palette) const {
+    size_t count = std::min(skeleton.modelMatrices.size(), inverseBindPoseMatrices_.size());
+    palette.resize(count);
+    for (size_t jointIndex = 0; jointIndex < count; ++jointIndex) {
+        palette[jointIndex] = inverseBindPoseMatrices_[jointIndex] * skeleton.modelMatrices[jointIndex];
+    }
+}
+
+Vector3 MeshSurfaceSampler::SkinPosition(uint32_t vertex, const std::vector<Matrix4x4> &palette) const {
+    const VertexInfluence &influence = influences_[vertex];
+    Vector3 result = {0.0f, 0.0f, 0.0f};
+    float totalWeight = 0.0f;
+    for (uint32_t i = 0; i < kNumMaxInfluence; ++i) {
+        int32_t joint = influence.jointIndices[i];
+        if (influence.weights[i] == 0.0f || joint < 0 || static_cast<size_t>(joint) >= palette.size()) {
+            continue;
+        }
+        result += Transformation(positions_[vertex], palette[joint]) * influence.weights[i];
+        totalWeight += influence.weights[i];
+    }
+    // ウェイトの無い頂点はそのまま
+    return totalWeight > 0.0f ? result : positions_[vertex];
+}
+
+Vector3 MeshSurfaceSampler::SkinNormal(uint32_t vertex, const std::vector<Matrix4x4> &palette) const {
+    const VertexInfluence &influence = influences_[vertex];
+    Vector3 result = {0.0f, 0.0f, 0.0f};
+    float totalWeight = 0.0f;
+    for (uint32_t i = 0; i < kNumMaxInfluence; ++i) {
+        int32_t joint = influence.jointIndices[i];
+        if (influence.weights[i] == 0.0f || joint < 0 || static_cast<size_t>(joint) >= palette.size()) {
+            continue;
+        }
+        // 非一様スケールは想定しないので回転部分だけで変換する
+        result += TransformNormal(normals_[vertex], palette[joint]) * influence.weights[i];
+        totalWeight += influence.weights[i];
+    }
+    return totalWeight > 0.0f ? result : normals_[vertex];
+}
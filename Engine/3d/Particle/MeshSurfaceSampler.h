@@ -0,0 +1,95 @@
+#pragma once
+#include "ModelStructs.h"
+#include "Primitive/PrimitiveModel.h"
+#include "type/Matrix4x4.h"
+#include "type/Vector3.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// メッシュ表面の一様サンプリング
+/// 三角形の面積でエイリアステーブルを作っておき、1回のサンプルをO(1)で行う
+/// テーブルはモデルごとに1回だけ作って共有する
+/// </summary>
+class MeshSurfaceSampler {
+  public:
+    // サンプル結果(モデル空間)
+    struct Sample {
+        Vector3 position;
+        Vector3 normal;
+    };
+
+  public:
+    // "primitive:Sphere" のように書くとプリミティブ形状を使う
+    static constexpr const char *kPrimitivePrefix = "primitive:";
+    static constexpr const char *kPrimitiveNames[] = {"Plane", "Sphere", "Cube", "Cylinder", "Ring", "Triangle", "Cone", "Pyramid"};
+
+    /// <summary>
+    /// モデルファイルからの取得(初回だけテーブルを作る、kPrimitivePrefixで始まればプリミティブ形状)
+    /// </summary>
+    static const MeshSurfaceSampler *Load(const std::string &filePath);
+
+    /// <summary>
+    /// プリミティブ形状からの取得
+    /// </summary>
+    static const MeshSurfaceSampler *LoadPrimitive(PrimitiveType type);
+
+    /// <summary>
+    /// プリミティブ形状のパス("primitive:名前")
+    /// </summary>
+    static std::string GetPrimitivePath(PrimitiveType type);
+
+    /// <summary>
+    /// キャッシュの破棄
+    /// </summary>
+    static void ClearCache();
+
+    /// <summary>
+    /// ModelDataから作る(キャッシュを通さない)
+    /// </summary>
+    void Build(const ModelData &modelData);
+
+    /// <summary>
+    /// 表面上の点を1つ取り出す
+    /// </summary>
+    /// <param name="random">[0,1)の乱数3つ(三角形の選択・重心座標)</param>
+    /// <param name="palette">スキニング行列(nullptrならバインドポーズ)</param>
+    Sample SampleSurface(const std::array<float, 3> &random, const std::vector<Matrix4x4> *palette = nullptr) const;
+
+    /// <summary>
+    /// 現在のポーズからスキニング行列を求める(Skin::Updateと同じ行列)
+    /// </summary>
+    void ComputePalette(const Skeleton &skeleton, std::vector<Matrix4x4> &palette) const;
+
+    bool IsEmpty() const { return triangles_.empty(); }
+    bool IsSkinned() const { return !influences_.empty(); }
+    float GetTotalArea() const { return totalArea_; }
+
+  private:
+    // 三角形の頂点番号(全メッシュ通し)
+    struct Triangle {
+        uint32_t index[3];
+    };
+
+    void BuildAliasTable(const std::vector<float> &areas);
+    Vector3 SkinPosition(uint32_t vertex, const std::vector<Matrix4x4> &palette) const;
+    Vector3 SkinNormal(uint32_t vertex, const std::vector<Matrix4x4> &palette) const;
+
+  private:
+    static std::unordered_map<std::string, std::unique_ptr<MeshSurfaceSampler>> cache_;
+
+    std::vector<Vector3> positions_;
+    std::vector<Vector3> normals_;
+    std::vector<Triangle> triangles_;
+    // エイリアステーブル(三角形ごと)
+    std::vector<float> probabilities_;
+    std::vector<uint32_t> aliases_;
+    float totalArea_ = 0.0f;
+
+    // スキニング情報(スキンが無ければ空)
+    std::vector<VertexInfluence> influences_;
+    std::vector<Matrix4x4> inverseBindPoseMatrices_;
+};
@@ -0,0 +1,172 @@
+#define NOMINMAX
+#include "ParticleBenchmark.h"
+#include "Log/Logger.h"
+#include "String/CommandLine.h"
+#include "ParticleEffectLibrary.h"
+#include "ParticleForceField.h"
+#include "ParticleGroup.h"
+#include "ParticleInstancePool.h"
+#include "ParticleManager.h"
+#include "Thread/ThreadPool.h"
+#include "ViewProjection/ViewProjection.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace Logger;
+namespace fs = std::filesystem;
+
+const std::string ParticleBenchmark::kPresetDirectoryPath = "resources/jsons/Particle";
+const std::string ParticleBenchmark::kOutputDirectoryPath = "resources/jsons/ParticleBenchmark/";
+
+bool ParticleBenchmark::IsRequested(const std::string &commandLine) {
+    return commandLine.find("--particle-bench") != std::string::npos;
+}
+
+int ParticleBenchmark::RunFromCommandLine(const std::string &commandLine) {
+    Options options;
+    std::string value;
+    if (CommandLine::FindOption(commandLine, "presets", value)) {
+        options.presets = CommandLine::Split(value);
+    }
+    if (CommandLine::FindOption(commandLine, "counts", value)) {
+        options.counts = CommandLine::SplitNumbers(value);
+    }
+    if (CommandLine::FindOption(commandLine, "frames", value)) {
+        options.frames = static_cast<uint32_t>(std::stoul(value));
+    }
+    if (CommandLine::FindOption(commandLine, "seed", value)) {
+        options.seed = static_cast<uint32_t>(std::stoul(value));
+    }
+
+    // 近傍計算などが使うのでワーカーだけは立てる
+    ThreadPool::GetInstance()->Initialize();
+    std::vector<Result> results = Run(options);
+    ParticleForceFieldManager::GetInstance()->Finalize();
+    ParticleEffectLibrary::GetInstance()->Finalize();
+    ParticleInstancePool::GetInstance()->Finalize();
+    ThreadPool::GetInstance()->Finalize();
+    return results.empty() ? 1 : 0;
+}
+
+std::vector<ParticleBenchmark::Result> ParticleBenchmark::Run(const Options &options) {
+    std::vector<std::string> presets = options.presets;
+    if (presets.empty() && fs::is_directory(kPresetDirectoryPath)) {
+        for (const auto &entry : fs::directory_iterator(kPresetDirectoryPath)) {
+            if (entry.path().extension() == ".json") {
+                presets.push_back(entry.path().stem().string());
+            }
+        }
+        std::sort(presets.begin(), presets.end());
+    }
+
+    std::vector<Result> results;
+    for (const std::string &preset : presets) {
+        const ParticleEffectTemplate *effect = ParticleEffectLibrary::GetInstance()->Load(preset);
+        if (effect->groupNames.empty()) {
+            Log("ParticleBenchmark: no groups in " + preset + "\n");
+            continue;
+        }
+        for (uint32_t count : options.counts) {
+            results.push_back(RunPreset(*effect, count, options));
+        }
+    }
+    WriteCsv(results);
+    return results;
+}
+
+ParticleBenchmark::Result ParticleBenchmark::RunPreset(const ParticleEffectTemplate &effect, uint32_t count, const Options &options) {
+    Result result;
+    result.preset = effect.name;
+    result.requestedCount = count;
+
+    ParticleManager manager;
+    manager.Initialize(nullptr);
+    manager.SetSeed(options.seed);
+
+    // 計測中に寿命で数が減らないよう、寿命を計測時間より長くする
+    const float duration = options.deltaTime * static_cast<float>(options.frames) + 1.0f;
+    std::vector<std::unique_ptr<ParticleGroup>> groups;
+    for (size_t i = 0; i < effect.groupNames.size(); ++i) {
+        auto group = std::make_unique<ParticleGroup>();
+        group->CreateHeadlessParticleGroup(effect.groupNames[i]);
+        manager.AddParticleGroup(group.get());
+
+        ParticleSetting setting = effect.settings[i];
+        setting.lifeTimeMin = std::max(setting.lifeTimeMin, duration);
+        setting.lifeTimeMax = std::max(setting.lifeTimeMax, duration);
+        manager.SetParticleSetting(effect.groupNames[i], setting);
+        if (!effect.forceFields[i].empty()) {
+            manager.SetForceField(effect.groupNames[i], ParticleForceFieldManager::GetInstance()->Load(effect.forceFields[i]));
+        }
+        groups.push_back(std::move(group));
+    }
+    manager.SetEmitTransform(effect.translation, effect.rotation, effect.scale);
+
+    // 発生のコスト
+    auto emitStart = std::chrono::steady_clock::now();
+    while (manager.GetParticleCount() < count) {
+        size_t before = manager.GetParticleCount();
+        manager.Emit();
+        if (manager.GetParticleCount() == before) {
+            break;
+        }
+    }
+    auto emitEnd = std::chrono::steady_clock::now();
+    result.particleCount = manager.GetParticleCount();
+    if (result.particleCount > 0) {
+        result.emitNanosecondsPerParticle =
+            std::chrono::duration<double, std::nano>(emitEnd - emitStart).count() / static_cast<double>(result.particleCount);
+    }
+
+    // シミュレーションとCPUのインスタンス配列への書き込み
+    ViewProjection viewProjection;
+    viewProjection.UpdateViewMatrix();
+    viewProjection.UpdateProjectionMatrix();
+
+    double simulateMicroseconds = 0.0;
+    double writeMicroseconds = 0.0;
+    double particleSteps = 0.0;
+    for (uint32_t frame = 0; frame < options.frames; ++frame) {
+        particleSteps += static_cast<double>(manager.GetParticleCount());
+        auto start = std::chrono::steady_clock::now();
+        manager.Simulate(options.deltaTime);
+        auto simulated = std::chrono::steady_clock::now();
+        manager.WriteInstances(viewProjection, 1.0f);
+        auto end = std::chrono::steady_clock::now();
+        simulateMicroseconds += std::chrono::duration<double, std::micro>(simulated - start).count();
+        writeMicroseconds += std::chrono::duration<double, std::micro>(end - simulated).count();
+    }
+    if (options.frames > 0) {
+        result.simulateMicroseconds = simulateMicroseconds / options.frames;
+        result.writeMicroseconds = writeMicroseconds / options.frames;
+    }
+    double totalSeconds = (simulateMicroseconds + writeMicroseconds) * 1.0e-6;
+    if (totalSeconds > 0.0) {
+        result.particlesPerSecond = particleSteps / totalSeconds;
+    }
+    // std::listのノードは前後のポインタを持つ
+    result.bytesPerParticle = sizeof(Particle) + sizeof(void *) * 2 + sizeof(ParticleForGPU);
+
+    Log("ParticleBenchmark: " + result.preset + " count=" + std::to_string(result.particleCount) +
+        " emit=" + std::to_string(result.emitNanosecondsPerParticle) + "ns/particle simulate=" +
+        std::to_string(result.simulateMicroseconds) + "us write=" + std::to_string(result.writeMicroseconds) +
+        "us throughput=" + std::to_string(result.particlesPerSecond) + "particles/s bytes=" + std::to_string(result.bytesPerParticle) + "\n");
+    return result;
+}
+
+void ParticleBenchmark::WriteCsv(const std::vector<Result> &results) {
+    fs::create_directories(kOutputDirectoryPath);
+    std::ofstream csv(kOutputDirectoryPath + "benchmark.csv");
+    if (!csv) {
+        Log("ParticleBenchmark: failed to write csv\n");
+        return;
+    }
+    csv << "preset,requestedCount,particleCount,emitNanosecondsPerParticle,simulateMicroseconds,writeMicroseconds,particlesPerSecond,bytesPerParticle\n";
+    for (const Result &result : results) {
+        csv << result.preset << "," << result.requestedCount << "," << result.particleCount << ","
+            << result.emitNanosecondsPerParticle << "," << result.simulateMicroseconds << "," << result.writeMicroseconds << ","
+            << result.particlesPerSecond << "," << result.bytesPerParticle << "\n";
+    }
+}
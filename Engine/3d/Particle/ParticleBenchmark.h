@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ParticleEffectTemplate;
+
+/// <summary>
+/// D3D12デバイスを作らずにパーティクルのシミュレーションを計測する
+/// resources/jsons/Particle のプリセットをヘッドレスのグループで動かし、
+/// 結果を resources/jsons/ParticleBenchmark/benchmark.csv に書き出す
+/// </summary>
+class ParticleBenchmark {
+  public:
+    // 計測条件
+    struct Options {
+        std::vector<std::string> presets;                // 空なら全プリセット
+        std::vector<uint32_t> counts = {1000, 10000, 100000}; // 発生させるパーティクル数
+        uint32_t frames = 300;                           // 計測するステップ数
+        float deltaTime = 1.0f / 60.0f;
+        uint32_t seed = 0;
+    };
+
+    // 1プリセット・1個数あたりの結果
+    struct Result {
+        std::string preset;
+        uint32_t requestedCount = 0;
+        size_t particleCount = 0;           // 実際に発生した数
+        double emitNanosecondsPerParticle = 0.0;
+        double simulateMicroseconds = 0.0;  // 1ステップの平均
+        double writeMicroseconds = 0.0;     // インスタンスデータ書き込みの1ステップの平均
+        double particlesPerSecond = 0.0;    // シミュレーション+書き込みのスループット
+        size_t bytesPerParticle = 0;        // パーティクル本体+リストのノード+インスタンスデータ
+    };
+
+  public:
+    /// <summary>
+    /// コマンドラインに --particle-bench が含まれるか
+    /// </summary>
+    static bool IsRequested(const std::string &commandLine);
+
+    /// <summary>
+    /// コマンドラインを解釈して実行する(戻り値はプロセスの終了コード)
+    /// --particle-bench [--presets=a,b] [--counts=1000,10000] [--frames=300] [--seed=0]
+    /// </summary>
+    static int RunFromCommandLine(const std::string &commandLine);
+
+    /// <summary>
+    /// 計測の実行
+    /// </summary>
+    static std::vector<Result> Run(const Options &options);
+
+  private:
+    static Result RunPreset(const ParticleEffectTemplate &effect, uint32_t count, const Options &options);
+    static void WriteCsv(const std::vector<Result> &results);
+
+    static const std::string kPresetDirectoryPath;
+    static const std::string kOutputDirectoryPath;
+};
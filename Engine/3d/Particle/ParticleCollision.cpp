@@ -0,0 +1,167 @@
+#include "ParticleCollision.h"
+#include "CollisionManager.h"
+#include "ModelStructs.h"
+#include <algorithm>
+
+void to_json(nlohmann::json &j, const ParticleCollisionSetting &setting) {
+    j = nlohmann::json{
+        {"response", static_cast<int32_t>(setting.response)},
+        {"isCollideScene", setting.isCollideScene},
+        {"radius", setting.radius},
+        {"restitution", setting.restitution},
+        {"friction", setting.friction},
+        {"planes", nlohmann::json::array()},
+    };
+    for (uint32_t i = 0; i < setting.planeCount; ++i) {
+        j["planes"].push_back({{"normal", setting.planes[i].normal}, {"distance", setting.planes[i].distance}});
+    }
+}
+
+void from_json(const nlohmann::json &j, ParticleCollisionSetting &setting) {
+    ParticleCollisionSetting defaults;
+    setting.response = static_cast<ParticleCollisionResponse>(j.value("response", static_cast<int32_t>(defaults.response)));
+    setting.isCollideScene = j.value("isCollideScene", defaults.isCollideScene);
+    setting.radius = j.value("radius", defaults.radius);
+    setting.restitution = j.value("restitution", defaults.restitution);
+    setting.friction = j.value("friction", defaults.friction);
+    setting.planeCount = 0;
+    if (j.contains("planes")) {
+        for (const auto &plane : j.at("planes")) {
+            if (setting.planeCount >= ParticleCollisionSetting::kMaxPlanes) {
+                break;
+            }
+            setting.planes[setting.planeCount++] = {plane.at("normal").get<Vector3>().Normalize(), plane.at("distance").get<float>()};
+        }
+    }
+}
+
+void ParticleCollider::Prepare(const ParticleCollisionSetting &setting, const Vector3 &boundsMin, const Vector3 &boundsMax) {
+    shapes_.clear();
+    if (setting.response == ParticleCollisionResponse::None || !setting.isCollideScene) {
+        return;
+    }
+    Vector3 margin = {setting.radius, setting.radius, setting.radius};
+    CollisionManager::QueryShapes(AABB{boundsMin - margin, boundsMax + margin}, shapes_);
+}
+
+ParticleCollider::Result ParticleCollider::Resolve(const ParticleCollisionSetting &setting, Particle &particle) const {
+    if (setting.response == ParticleCollisionResponse::None || particle.isStuck) {
+        return Result::None;
+    }
+    Vector3 &position = particle.transform.translation_;
+    const float radius = setting.radius;
+
+    // 一番深くめり込んでいるものだけに応答する
+    bool isHit = false;
+    float deepest = 0.0f;
+    Vector3 hitPosition;
+    Vector3 hitNormal;
+
+    for (uint32_t i = 0; i < setting.planeCount; ++i) {
+        const ParticleCollisionSetting::Plane &plane = setting.planes[i];
+        float depth = plane.distance + radius - plane.normal.Dot(position);
+        if (depth > deepest) {
+            deepest = depth;
+            hitPosition = position + plane.normal * depth;
+            hitNormal = plane.normal;
+            isHit = true;
+        }
+    }
+    for (const ColliderShape &shape : shapes_) {
+        // 囲むAABBで先にふるい落とす
+        if (position.x < shape.bounds.min.x - radius || position.x > shape.bounds.max.x + radius ||
+            position.y < shape.bounds.min.y - radius || position.y > shape.bounds.max.y + radius ||
+            position.z < shape.bounds.min.z - radius || position.z > shape.bounds.max.z + radius) {
+            continue;
+        }
+        Vector3 pushed;
+        Vector3 normal;
+        if (Penetrate(shape, position, radius, pushed, normal)) {
+            float depth = (pushed - position).Length();
+            if (!isHit || depth > deepest) {
+                deepest = depth;
+                hitPosition = pushed;
+                hitNormal = normal;
+                isHit = true;
+            }
+        }
+    }
+    if (!isHit) {
+        return Result::None;
+    }
+
+    switch (setting.response) {
+    case ParticleCollisionResponse::Kill:
+        return Result::Kill;
+    case ParticleCollisionResponse::Stick:
+        position = hitPosition;
+        particle.velocity = {0.0f, 0.0f, 0.0f};
+        particle.isStuck = true;
+        break;
+    case ParticleCollisionResponse::Bounce: {
+        position = hitPosition;
+        float normalSpeed = particle.velocity.Dot(hitNormal);
+        if (normalSpeed < 0.0f) {
+            Vector3 normalVelocity = hitNormal * normalSpeed;
+            Vector3 tangentVelocity = particle.velocity - normalVelocity;
+            particle.velocity = tangentVelocity * (1.0f - setting.friction) - normalVelocity * setting.restitution;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return Result::Hit;
+}
+
+bool ParticleCollider::Penetrate(const ColliderShape &shape, const Vector3 &position, float radius, Vector3 &pushed, Vector3 &normal) {
+    switch (shape.type) {
+    case ColliderShape::Type::Sphere: {
+        Vector3 offset = position - shape.sphere.center;
+        float reach = shape.sphere.radius + radius;
+        float distanceSquared = offset.LengthSq();
+        if (distanceSquared >= reach * reach) {
+            return false;
+        }
+        float distance = std::sqrt(distanceSquared);
+        normal = distance > 0.0f ? offset / distance : Vector3{0.0f, 1.0f, 0.0f};
+        pushed = shape.sphere.center + normal * reach;
+        return true;
+    }
+    case ColliderShape::Type::AABB:
+    case ColliderShape::Type::OBB: {
+        // AABBは軸がワールドの軸のOBBとして扱う
+        const bool isOBB = shape.type == ColliderShape::Type::OBB;
+        const Vector3 center = isOBB ? shape.center : (shape.aabb.min + shape.aabb.max) * 0.5f;
+        const Vector3 half = isOBB ? shape.size : (shape.aabb.max - shape.aabb.min) * 0.5f;
+        const Vector3 axes[3] = {
+            isOBB ? shape.axes[0] : Vector3{1.0f, 0.0f, 0.0f},
+            isOBB ? shape.axes[1] : Vector3{0.0f, 1.0f, 0.0f},
+            isOBB ? shape.axes[2] : Vector3{0.0f, 0.0f, 1.0f},
+        };
+        const float halfSize[3] = {half.x + radius, half.y + radius, half.z + radius};
+
+        Vector3 offset = position - center;
+        // 一番浅い面から押し出す
+        int pushAxis = -1;
+        float pushDepth = 0.0f;
+        float pushSign = 1.0f;
+        for (int i = 0; i < 3; ++i) {
+            float local = offset.Dot(axes[i]);
+            float depth = halfSize[i] - std::abs(local);
+            if (depth <= 0.0f) {
+                return false;
+            }
+            if (pushAxis < 0 || depth < pushDepth) {
+                pushAxis = i;
+                pushDepth = depth;
+                pushSign = local >= 0.0f ? 1.0f : -1.0f;
+            }
+        }
+        normal = axes[pushAxis] * pushSign;
+        pushed = position + normal * pushDepth;
+        return true;
+    }
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "externals/nlohmann/json.hpp"
+#include "myMath.h"
+#include "type/Vector3.h"
+#include <cstdint>
+#include <vector>
+
+struct Particle;
+
+// 当たったときの応答
+enum class ParticleCollisionResponse : int32_t {
+    None,   // 当たり判定なし
+    Bounce, // 反射(反発係数と摩擦)
+    Stick,  // その場で止まる
+    Kill,   // 消える
+};
+
+// グループごとの当たり判定の設定
+struct ParticleCollisionSetting {
+    static constexpr uint32_t kMaxPlanes = 4;
+
+    // 無限平面(dot(normal, p) = distance)
+    struct Plane {
+        Vector3 normal;
+        float distance;
+    };
+
+    ParticleCollisionResponse response = ParticleCollisionResponse::None;
+    bool isCollideScene = true; // CollisionManagerのコライダーとも当てる
+    float radius = 0.05f;       // パーティクルの半径
+    float restitution = 0.5f;   // 反発係数
+    float friction = 0.2f;      // 接線方向の減衰
+    uint32_t planeCount = 0;
+    Plane planes[kMaxPlanes];
+};
+
+void to_json(nlohmann::json &j, const ParticleCollisionSetting &setting);
+void from_json(const nlohmann::json &j, ParticleCollisionSetting &setting);
+
+/// <summary>
+/// パーティクルとシーンの当たり判定
+/// グループのAABBでCollisionManagerへ1回だけ問い合わせ、候補の形状に対して各パーティクルを判定する
+/// </summary>
+class ParticleCollider {
+  public:
+    // 判定結果
+    enum class Result {
+        None, // 当たっていない
+        Hit,  // 当たって応答を適用した
+        Kill, // 当たって消すべき
+    };
+
+  public:
+    /// <summary>
+    /// グループ全体のAABB(パーティクルの半径は含めなくてよい)で候補の形状を集める
+    /// </summary>
+    void Prepare(const ParticleCollisionSetting &setting, const Vector3 &boundsMin, const Vector3 &boundsMax);
+
+    /// <summary>
+    /// 平面と候補の形状に対して判定し、当たっていれば押し出して応答を適用する
+    /// </summary>
+    Result Resolve(const ParticleCollisionSetting &setting, Particle &particle) const;
+
+    size_t GetCandidateCount() const { return shapes_.size(); }
+
+  private:
+    // 点が形状にめり込んでいれば押し出し先と法線を返す
+    static bool Penetrate(const ColliderShape &shape, const Vector3 &position, float radius, Vector3 &pushed, Vector3 &normal);
+
+  private:
+    std::vector<ColliderShape> shapes_;
+};
@@ -0,0 +1,80 @@
+#include "ParticleCurve.h"
+#include "Data/DataHandler.h"
+#include <algorithm>
+
+void ParticleCurve::Reset(const Vector4 &start, const Vector4 &end) {
+    keyCount = 2;
+    keys[0] = {0.0f, start};
+    keys[1] = {1.0f, end};
+    Bake();
+}
+
+bool ParticleCurve::AddKey(float time, const Vector4 &value) {
+    if (keyCount >= kMaxKeys) {
+        return false;
+    }
+    keys[keyCount++] = {std::clamp(time, 0.0f, 1.0f), value};
+    Bake();
+    return true;
+}
+
+void ParticleCurve::RemoveKey(uint32_t index) {
+    if (index >= keyCount) {
+        return;
+    }
+    for (uint32_t i = index; i + 1 < keyCount; ++i) {
+        keys[i] = keys[i + 1];
+    }
+    --keyCount;
+    Bake();
+}
+
+void ParticleCurve::Bake() {
+    keyCount = std::min(keyCount, kMaxKeys);
+    std::sort(keys, keys + keyCount, [](const Key &a, const Key &b) { return a.time < b.time; });
+
+    if (keyCount == 0) {
+        std::fill(lut, lut + kLutSize, Vector4{1.0f, 1.0f, 1.0f, 1.0f});
+        return;
+    }
+    // キー間は線形、範囲外は端のキーの値
+    uint32_t key = 0;
+    for (uint32_t i = 0; i < kLutSize; ++i) {
+        float t = static_cast<float>(i) / static_cast<float>(kLutSize - 1);
+        while (key + 1 < keyCount && keys[key + 1].time < t) {
+            ++key;
+        }
+        if (t <= keys[0].time) {
+            lut[i] = keys[0].value;
+        } else if (key + 1 >= keyCount) {
+            lut[i] = keys[keyCount - 1].value;
+        } else {
+            const Key &start = keys[key];
+            const Key &end = keys[key + 1];
+            float span = end.time - start.time;
+            float rate = span > 0.0f ? (t - start.time) / span : 1.0f;
+            lut[i] = start.value + (end.value - start.value) * rate;
+        }
+    }
+}
+
+void to_json(nlohmann::json &j, const ParticleCurve &curve) {
+    j = nlohmann::json{{"enabled", curve.isEnabled}, {"keys", nlohmann::json::array()}};
+    for (uint32_t i = 0; i < curve.keyCount; ++i) {
+        j["keys"].push_back({{"time", curve.keys[i].time}, {"value", curve.keys[i].value}});
+    }
+}
+
+void from_json(const nlohmann::json &j, ParticleCurve &curve) {
+    curve.isEnabled = j.value("enabled", false);
+    curve.keyCount = 0;
+    if (j.contains("keys")) {
+        for (const auto &key : j.at("keys")) {
+            if (curve.keyCount >= ParticleCurve::kMaxKeys) {
+                break;
+            }
+            curve.keys[curve.keyCount++] = {key.at("time").get<float>(), key.at("value").get<Vector4>()};
+        }
+    }
+    curve.Bake();
+}
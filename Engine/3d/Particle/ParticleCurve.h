@@ -0,0 +1,60 @@
+#pragma once
+#include "externals/nlohmann/json.hpp"
+#include "type/Vector4.h"
+#include <cstdint>
+
+/// <summary>
+/// 寿命に対するカーブ(キーは固定長、LUTに焼き込んで使う)
+/// 更新時はSampleで1回の線形補間だけになる
+/// </summary>
+struct ParticleCurve {
+    static constexpr uint32_t kMaxKeys = 8;  // キーの最大数
+    static constexpr uint32_t kLutSize = 64; // 焼き込みテーブルの要素数
+
+    struct Key {
+        float time;   // 0～1(寿命の割合)
+        Vector4 value;
+    };
+
+    bool isEnabled = false;
+    uint32_t keyCount = 0;
+    Key keys[kMaxKeys];
+    Vector4 lut[kLutSize];
+
+    /// <summary>
+    /// 始点と終点の2キーで初期化
+    /// </summary>
+    void Reset(const Vector4 &start, const Vector4 &end);
+
+    /// <summary>
+    /// キーの追加(満杯なら何もしない)
+    /// </summary>
+    bool AddKey(float time, const Vector4 &value);
+
+    /// <summary>
+    /// キーの削除
+    /// </summary>
+    void RemoveKey(uint32_t index);
+
+    /// <summary>
+    /// キーを時間順に並べてLUTに焼き込む(キー編集後に呼ぶ)
+    /// </summary>
+    void Bake();
+
+    /// <summary>
+    /// t(0～1)での値
+    /// </summary>
+    Vector4 Sample(float t) const {
+        float position = (t <= 0.0f ? 0.0f : (t >= 1.0f ? 1.0f : t)) * static_cast<float>(kLutSize - 1);
+        uint32_t index = static_cast<uint32_t>(position);
+        if (index >= kLutSize - 1) {
+            return lut[kLutSize - 1];
+        }
+        float fraction = position - static_cast<float>(index);
+        return lut[index] + (lut[index + 1] - lut[index]) * fraction;
+    }
+};
+
+// JSON変換(キーだけを保存し、LUTは読み込み時に焼き直す)
+void to_json(nlohmann::json &j, const ParticleCurve &curve);
+void from_json(const nlohmann::json &j, ParticleCurve &curve);
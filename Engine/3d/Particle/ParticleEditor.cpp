@@ -1,6 +1,7 @@
 #include "ParticleEditor.h"
 #include "ImGui/ImGuiManager.h"
 #include"ShowFolder/ShowFolder.h"
+#include "ParticleInstancePool.h"
 
 ParticleEditor *ParticleEditor::instance = nullptr;
 
@@ -86,10 +87,10 @@ void ParticleEditor::EditorWindow() {
     ImGui::End();
 }
 
-void ParticleEditor::DrawAll(const ViewProjection &vp_) {
+void ParticleEditor::DrawAll() {
     for (auto &[name, emitter] : emitters_) {
         if (emitter) {
-            emitter->Draw(vp_);
+            emitter->Draw();
         }
     }
 }
@@ -308,12 +309,112 @@ void ParticleEditor::ShowImGuiEditor() {
                 ShowFileSelector();
             }
 
+            // 固定ステップ・間引き更新・記録と再生
+            if (ColoredCollapsingHeader("シミュレーション設定", 3)) {
+                ShowRecorder();
+            }
+
+            // 力場(ベクトル場)
+            if (ColoredCollapsingHeader("力場", 4)) {
+                ShowForceFields();
+            }
+
             ImGui::EndTabItem();
         }
         ImGui::EndTabBar();
     }
 }
 
+void ParticleEditor::ShowRecorder() {
+    ParticleEmitterManager *emitterManager = ParticleEmitterManager::GetInstance();
+    ParticleRecorder &recorder = emitterManager->GetRecorder();
+
+    bool isFixedStep = emitterManager->IsFixedStep();
+    float fixedDeltaTime = emitterManager->GetFixedDeltaTime();
+    bool changed = ImGui::Checkbox("固定ステップ", &isFixedStep);
+    changed |= ImGui::DragFloat("ステップ間隔", &fixedDeltaTime, 0.0001f, 1.0f / 240.0f, 1.0f / 15.0f, "%.4f");
+    if (changed) {
+        emitterManager->SetFixedStep(isFixedStep, fixedDeltaTime);
+    }
+
+    // 視野外の間引き更新
+    bool isReducedRate = emitterManager->IsReducedRateEnabled();
+    float reducedDistance = emitterManager->GetReducedRateDistance();
+    int reducedInterval = static_cast<int>(emitterManager->GetReducedRateInterval());
+    changed = ImGui::Checkbox("視野外を間引き更新", &isReducedRate);
+    changed |= ImGui::DragFloat("間引き距離", &reducedDistance, 0.5f, 0.0f, 1000.0f);
+    changed |= ImGui::SliderInt("間引き間隔(フレーム)", &reducedInterval, 1, 16);
+    if (changed) {
+        emitterManager->SetReducedRate(isReducedRate, reducedDistance, static_cast<uint32_t>(reducedInterval));
+    }
+    ImGui::Text("間引き中: %u / %zu", emitterManager->GetReducedEmitterCount(), emitterManager->GetEmitters().size());
+
+    // インスタンスデータのページの使用状況
+    ParticleInstancePool *instancePool = ParticleInstancePool::GetInstance();
+    const InstancePageAllocator &pageAllocator = instancePool->GetAllocator(false);
+    ImGui::Text("インスタンスページ: 使用 %u / 作成 %u (%.1f MB)", pageAllocator.GetUsedPageCount(), pageAllocator.GetPageCount(),
+                static_cast<float>(instancePool->GetGpuBytes()) / (1024.0f * 1024.0f));
+    ImGui::Separator();
+
+    char nameBuffer[256];
+    strcpy_s(nameBuffer, sizeof(nameBuffer), localRecordName_.c_str());
+    if (ImGui::InputText("記録名", nameBuffer, sizeof(nameBuffer))) {
+        localRecordName_ = std::string(nameBuffer);
+    }
+    ImGui::InputInt("シード", &localRecordSeed_);
+
+    if (localRecordName_.empty()) {
+        return;
+    }
+    if (!recorder.IsRecording()) {
+        if (ImGui::Button("記録開始")) {
+            recorder.Start(localRecordName_, static_cast<uint32_t>(localRecordSeed_));
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("再生ベンチマーク")) {
+            ParticleRecorder::Replay(localRecordName_, lastReplayResult_);
+        }
+    } else if (ImGui::Button("記録終了")) {
+        recorder.Stop();
+    }
+    if (lastReplayResult_.frameCount > 0) {
+        ImGui::Text("frames:%u avg:%.1fus max:%.1fus particles:%zu", lastReplayResult_.frameCount,
+                    lastReplayResult_.averageMicroseconds, lastReplayResult_.maxMicroseconds, lastReplayResult_.maxParticleCount);
+    }
+
+    // 空間ハッシュによる近傍計算のベンチマーク
+    ImGui::Separator();
+    if (ImGui::Button("近傍ベンチマーク(10k/50k/100k)")) {
+        neighborBenchmarkResults_.clear();
+        for (uint32_t count : {10000u, 50000u, 100000u}) {
+            neighborBenchmarkResults_.push_back(ParticleNeighborGrid::Benchmark(count));
+        }
+    }
+    for (const auto &result : neighborBenchmarkResults_) {
+        ImGui::Text("%u: build:%.1fus solve:%.1fus neighbors:%.1f", result.particleCount, result.buildMicroseconds,
+                    result.solveMicroseconds, result.averageNeighbors);
+    }
+}
+
+void ParticleEditor::ShowForceFields() {
+    ParticleForceFieldManager *fieldManager = ParticleForceFieldManager::GetInstance();
+
+    char nameBuffer[256];
+    strcpy_s(nameBuffer, sizeof(nameBuffer), localForceFieldName_.c_str());
+    if (ImGui::InputText("力場名", nameBuffer, sizeof(nameBuffer))) {
+        localForceFieldName_ = std::string(nameBuffer);
+    }
+    if (!localForceFieldName_.empty() && ImGui::Button("読み込み/作成")) {
+        fieldManager->Load(localForceFieldName_);
+    }
+    for (const auto &[name, field] : fieldManager->GetFields()) {
+        if (ImGui::TreeNode(name.c_str())) {
+            field->Debug();
+            ImGui::TreePop();
+        }
+    }
+}
+
 void ParticleEditor::ShowFileSelector() {
     static int selectedIndex = -1;
     std::vector<std::string> jsonFiles = GetJsonFiles();
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ParticleEmitter.h"
+#include "ParticleEmitterManager.h"
+#include "ParticleForceField.h"
 #include "ParticleGroup.h"
 #include "ParticleGroupManager.h"
 #include "ViewProjection/ViewProjection.h"
@@ -32,6 +34,11 @@ class ParticleEditor {
     std::string localTexturePath_;                  // テクスチャパス
     std::string localEmitterName_;                  // エミッター名
     PrimitiveType localType_ = PrimitiveType::None; // プリミティブタイプ
+    std::string localRecordName_;                   // 記録名
+    std::string localForceFieldName_;               // 力場名
+    int localRecordSeed_ = 0;                       // 記録時のシード
+    ParticleRecorder::ReplayResult lastReplayResult_;
+    std::vector<ParticleNeighborGrid::BenchmarkResult> neighborBenchmarkResults_; // 近傍ベンチマーク
 
     // CollapsingHeaderの色を定義
     ImVec4 headerColors_[6];
@@ -51,6 +58,12 @@ class ParticleEditor {
     // ファイルセレクタ表示関数
     void ShowFileSelector();
 
+    // 固定ステップ・間引き更新・記録/再生の表示関数
+    void ShowRecorder();
+
+    // 力場の配置・焼き込みの表示関数
+    void ShowForceFields();
+
     // JSONファイル一覧取得関数
     std::vector<std::string> GetJsonFiles();
 
@@ -74,7 +87,7 @@ class ParticleEditor {
     // ImGuiエディターの表示
     void EditorWindow();
     // すべてのエミッターを描画
-    void DrawAll(const ViewProjection &vp_);
+    void DrawAll();
     // すべてのエミッターのデバッグ情報を表示
     void DebugAll();
     // ImGuiエディターの表示処理
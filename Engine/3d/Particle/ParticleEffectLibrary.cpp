@@ -0,0 +1,181 @@
+#define NOMINMAX
+#include "ParticleEffectLibrary.h"
+#include "ParticleGroupManager.h"
+#include "ParticlePresetBinary.h"
+#include <algorithm>
+#include <filesystem>
+
+ParticleEffectLibrary *ParticleEffectLibrary::instance = nullptr;
+
+namespace {
+// キーが無い・型が違う場合は既定値
+template <typename T>
+T Read(const json &data, const std::string &key, const T &defaultValue) {
+    auto it = data.find(key);
+    if (it == data.end()) {
+        return defaultValue;
+    }
+    try {
+        return it->get<T>();
+    } catch (const json::exception &e) {
+        std::cerr << "JSON Load Error: " << e.what() << " (Key: " << key << ")" << std::endl;
+    }
+    return defaultValue;
+}
+} // namespace
+
+ParticleEffectLibrary *ParticleEffectLibrary::GetInstance() {
+    if (instance == nullptr) {
+        instance = new ParticleEffectLibrary();
+    }
+    return instance;
+}
+
+void ParticleEffectLibrary::Finalize() {
+    delete instance;
+    instance = nullptr;
+}
+
+const ParticleEffectTemplate *ParticleEffectLibrary::Load(const std::string &name) {
+    auto it = templates_.find(name);
+    if (it != templates_.end()) {
+        // 読み込み時に未生成だったグループだけ引き直す
+        ResolveGroups(*it->second);
+        return it->second.get();
+    }
+    auto effect = std::make_unique<ParticleEffectTemplate>();
+    LoadTemplate(name, *effect);
+    return templates_.emplace(name, std::move(effect)).first->second.get();
+}
+
+const ParticleEffectTemplate *ParticleEffectLibrary::Reload(const std::string &name) {
+    auto it = templates_.find(name);
+    if (it == templates_.end()) {
+        return Load(name);
+    }
+    // 参照中のポインタを無効にしないよう中身だけ差し替える
+    *it->second = ParticleEffectTemplate{};
+    LoadTemplate(name, *it->second);
+    return it->second.get();
+}
+
+void ParticleEffectLibrary::LoadTemplate(const std::string &name, ParticleEffectTemplate &effect) {
+    // コンパイル済みのバイナリがJSONより新しければそちらを使う
+    if (ParticlePresetBinary::IsUpToDate(name) && ParticlePresetBinary::Read(name, effect)) {
+        effect.groups.assign(effect.groupNames.size(), nullptr);
+        ResolveGroups(effect);
+        return;
+    }
+    effect = ParticleEffectTemplate{};
+
+    // 元のJSONが無いものは空のテンプレートになるので、バイナリに残さない
+    const bool hasSource = std::filesystem::exists(ParticlePresetBinary::kSourceDirectoryPath + name + ".json");
+    json data = DataHandler("Particle", name).LoadAll();
+
+    effect.name = name;
+    effect.translation = Read<Vector3>(data, "emitterTranslation", {0, 0, 0});
+    effect.rotation = Read<Vector3>(data, "emitterRotation", {0, 0, 0});
+    effect.scale = Read<Vector3>(data, "emitterScale", {1, 1, 1});
+    effect.groupNames = Read<std::vector<std::string>>(data, "GroupNames", {});
+    effect.emitFrequency = Read<float>(data, "emitFrequency", 0.1f);
+    effect.isVisible = Read<bool>(data, "isVisible", true);
+    effect.isActive = Read<bool>(data, "isActive", false);
+    effect.isAuto = Read<bool>(data, "isAuto", false);
+    effect.prewarmTime = Read<float>(data, "prewarmTime", 0.0f);
+
+    effect.settings.clear();
+    effect.emitModels.clear();
+    effect.forceFields.clear();
+    effect.maxLifeTime = 0.0f;
+    for (const auto &groupName : effect.groupNames) {
+        ParticleSetting setting = LoadSetting(data, groupName);
+        float lifeTime = std::max(setting.lifeTimeMin, setting.lifeTimeMax);
+        if (setting.enableTrail) {
+            lifeTime += lifeTime * setting.trailLifeScale;
+        }
+        effect.maxLifeTime = std::max(effect.maxLifeTime, lifeTime);
+        effect.settings.push_back(setting);
+        effect.emitModels.push_back(Read<std::string>(data, groupName + "_emitModel", ""));
+        effect.forceFields.push_back(Read<std::string>(data, groupName + "_forceField", ""));
+    }
+    effect.groups.assign(effect.groupNames.size(), nullptr);
+    ResolveGroups(effect);
+
+    // 次回からは1回の読み込みで済むようバイナリを生成しておく
+    if (hasSource) {
+        ParticlePresetBinary::Write(effect);
+    }
+}
+
+void ParticleEffectLibrary::ResolveGroups(ParticleEffectTemplate &effect) {
+    for (size_t i = 0; i < effect.groupNames.size(); ++i) {
+        if (!effect.groups[i]) {
+            effect.groups[i] = ParticleGroupManager::GetInstance()->GetParticleGroup(effect.groupNames[i]);
+        }
+    }
+}
+
+ParticleSetting ParticleEffectLibrary::LoadSetting(const json &data, const std::string &groupName) {
+    ParticleSetting setting;
+    setting.translate = Read<Vector3>(data, groupName + "_translate", {0, 0, 0});
+    setting.rotation = Read<Vector3>(data, groupName + "_rotation", {0, 0, 0});
+    setting.scale = Read<Vector3>(data, groupName + "_scale", {1, 1, 1});
+    setting.count = Read<uint32_t>(data, groupName + "_count", 1);
+    setting.lifeTimeMin = Read<float>(data, groupName + "_lifeTimeMin", 1.0f);
+    setting.lifeTimeMax = Read<float>(data, groupName + "_lifeTimeMax", 3.0f);
+    setting.alphaMin = Read<float>(data, groupName + "_alphaMin", 1.0f);
+    setting.alphaMax = Read<float>(data, groupName + "_alphaMax", 1.0f);
+    setting.scaleMin = Read<float>(data, groupName + "_scaleMin", 1.0f);
+    setting.scaleMax = Read<float>(data, groupName + "_scaleMax", 1.0f);
+    setting.velocityMin = Read<Vector3>(data, groupName + "_velocityMin", {-1, -1, -1});
+    setting.velocityMax = Read<Vector3>(data, groupName + "_velocityMax", {1, 1, 1});
+    setting.particleStartScale = Read<Vector3>(data, groupName + "_startScale", {1, 1, 1});
+    setting.particleEndScale = Read<Vector3>(data, groupName + "_endScale", {0, 0, 0});
+    setting.startAcce = Read<Vector3>(data, groupName + "_startAcce", {1, 1, 1});
+    setting.endAcce = Read<Vector3>(data, groupName + "_endAcce", {1, 1, 1});
+    setting.startRote = Read<Vector3>(data, groupName + "_startRote", {0, 0, 0});
+    setting.endRote = Read<Vector3>(data, groupName + "_endRote", {0, 0, 0});
+    setting.rotateStartMax = Read<Vector3>(data, groupName + "_rotateStartMax", {0, 0, 0});
+    setting.rotateStartMin = Read<Vector3>(data, groupName + "_rotateStartMin", {0, 0, 0});
+    setting.rotateVelocityMin = Read<Vector3>(data, groupName + "_rotateVelocityMin", {-0.07f, -0.07f, -0.07f});
+    setting.rotateVelocityMax = Read<Vector3>(data, groupName + "_rotateVelocityMax", {0.07f, 0.07f, 0.07f});
+    setting.allScaleMin = Read<Vector3>(data, groupName + "_allScaleMin", {0, 0, 0});
+    setting.allScaleMax = Read<Vector3>(data, groupName + "_allScaleMax", {1, 1, 1});
+    setting.isRandomSize = Read<bool>(data, groupName + "_isRandomScale", false);
+    setting.isRandomAllSize = Read<bool>(data, groupName + "_isAllRamdomScale", false);
+    setting.isRandomColor = Read<bool>(data, groupName + "_isRandomColor", false);
+    setting.isRandomRotate = Read<bool>(data, groupName + "_isRandomRotate", false);
+    setting.isBillboard = Read<bool>(data, groupName + "_isBillboard", false);
+    setting.isAcceMultiply = Read<bool>(data, groupName + "_isAcceMultiply", false);
+    setting.isSinMove = Read<bool>(data, groupName + "_isSinMove", false);
+    setting.isFaceDirection = Read<bool>(data, groupName + "_isFaceDirection", false);
+    setting.isEndScale = Read<bool>(data, groupName + "_isEndScale", false);
+    setting.isEmitOnEdge = Read<bool>(data, groupName + "_isEmitOnEdge", false);
+    setting.emitShape = static_cast<EmitShape>(Read<int>(data, groupName + "_emitShape", static_cast<int>(EmitShape::Box)));
+    setting.isEmitOnShell = Read<bool>(data, groupName + "_isEmitOnShell", false);
+    setting.coneAngle = Read<float>(data, groupName + "_coneAngle", 0.5f);
+    setting.ringInnerRatio = Read<float>(data, groupName + "_ringInnerRatio", 0.8f);
+    setting.shapeNormalSpeed = Read<float>(data, groupName + "_shapeNormalSpeed", 0.0f);
+    setting.forceFieldScale = Read<float>(data, groupName + "_forceFieldScale", 1.0f);
+    setting.neighbor = Read<ParticleNeighborSetting>(data, groupName + "_neighbor", ParticleNeighborSetting{});
+    setting.collision = Read<ParticleCollisionSetting>(data, groupName + "_collision", ParticleCollisionSetting{});
+    setting.isGatherMode = Read<bool>(data, groupName + "_isGatherMode", false);
+    setting.gatherStartRatio = Read<float>(data, groupName + "_gatherStartRatio", 0.0f);
+    setting.gatherStrength = Read<float>(data, groupName + "_gatherStrength", 0.0f);
+    setting.gravity = Read<float>(data, groupName + "_gravity", 0.0f);
+    setting.enableTrail = Read<bool>(data, groupName + "_enableTrail", false);
+    setting.trailSpawnInterval = Read<float>(data, groupName + "_trailSpawnInterval", 0.05f);
+    setting.maxTrailParticles = Read<int>(data, groupName + "_maxTrailParticles", 20);
+    setting.trailLifeScale = Read<float>(data, groupName + "_trailLifeScale", 0.5f);
+    setting.trailScaleMultiplier = Read<Vector3>(data, groupName + "_trailScaleMultiplier", {0.8f, 0.8f, 0.8f});
+    setting.trailColorMultiplier = Read<Vector4>(data, groupName + "_trailColorMultiplier", {1.0f, 1.0f, 1.0f, 0.7f});
+    setting.trailInheritVelocity = Read<bool>(data, groupName + "_trailInheritVelocity", true);
+    setting.trailVelocityScale = Read<float>(data, groupName + "_trailVelocityScale", 0.3f);
+    setting.startColor = Read<Vector4>(data, groupName + "_startColor", {1.0f, 1.0f, 1.0f, 1.0f});
+    setting.endColor = Read<Vector4>(data, groupName + "_endColor", {1.0f, 1.0f, 1.0f, 1.0f});
+    setting.colorCurve = Read<ParticleCurve>(data, groupName + "_colorCurve", setting.colorCurve);
+    setting.scaleCurve = Read<ParticleCurve>(data, groupName + "_scaleCurve", setting.scaleCurve);
+    setting.acceCurve = Read<ParticleCurve>(data, groupName + "_acceCurve", setting.acceCurve);
+    setting.BakeCurves();
+    return setting;
+}
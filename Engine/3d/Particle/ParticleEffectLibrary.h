@@ -0,0 +1,75 @@
+#pragma once
+#include "Data/DataHandler.h"
+#include "ParticleManager.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// 読み込み済みのエフェクト定義(共有・変更しない)
+/// </summary>
+struct ParticleEffectTemplate {
+    std::string name;
+    Vector3 translation = {0.0f, 0.0f, 0.0f};
+    Vector3 rotation = {0.0f, 0.0f, 0.0f};
+    Vector3 scale = {1.0f, 1.0f, 1.0f};
+    float emitFrequency = 0.1f;
+    bool isVisible = true;
+    bool isActive = false;
+    bool isAuto = false;
+    float prewarmTime = 0.0f;
+
+    std::vector<std::string> groupNames;
+    std::vector<ParticleSetting> settings; // groupNamesと同じ並び
+    std::vector<std::string> emitModels;  // MeshSurface形状のモデルパス(groupNamesと同じ並び)
+    std::vector<std::string> forceFields; // 力場の名前(groupNamesと同じ並び)
+    std::vector<ParticleGroup *> groups;   // 解決済みのグループ(未生成ならnullptr)
+    float maxLifeTime = 0.0f;              // 1回の発生が消えきるまでの時間(軌跡込み)
+};
+
+/// <summary>
+/// エフェクト定義のキャッシュ
+/// JSONは名前ごとに1回だけ読み込み、以降はテンプレートを共有する
+/// </summary>
+class ParticleEffectLibrary {
+  private:
+    static ParticleEffectLibrary *instance;
+    ParticleEffectLibrary() = default;
+    ~ParticleEffectLibrary() = default;
+    ParticleEffectLibrary(ParticleEffectLibrary &) = delete;
+    ParticleEffectLibrary &operator=(ParticleEffectLibrary &) = delete;
+
+  public:
+    /// <summary>
+    /// シングルトンインスタンスの取得
+    /// </summary>
+    static ParticleEffectLibrary *GetInstance();
+
+    /// <summary>
+    /// 終了
+    /// </summary>
+    void Finalize();
+
+    /// <summary>
+    /// テンプレートの取得(未読み込みならここで1回だけ読む)
+    /// </summary>
+    const ParticleEffectTemplate *Load(const std::string &name);
+
+    /// <summary>
+    /// JSONを読み直してテンプレートを上書きする(エディタで保存したとき用)
+    /// </summary>
+    const ParticleEffectTemplate *Reload(const std::string &name);
+
+    /// <summary>
+    /// グループごとの設定をJSONから読む(キーが無ければ既定値)
+    /// </summary>
+    static ParticleSetting LoadSetting(const json &data, const std::string &groupName);
+
+  private:
+    static void LoadTemplate(const std::string &name, ParticleEffectTemplate &effect);
+    static void ResolveGroups(ParticleEffectTemplate &effect);
+
+  private:
+    std::unordered_map<std::string, std::unique_ptr<ParticleEffectTemplate>> templates_;
+};
@@ -0,0 +1,154 @@
+#include "ParticleEffectPool.h"
+#include "MeshSurfaceSampler.h"
+#include "ParticleForceField.h"
+#include "ParticleEmitterManager.h"
+
+ParticleEffectPool::~ParticleEffectPool() {
+    if (manager_) {
+        ParticleEmitterManager::GetInstance()->UnregisterPool(this);
+    }
+}
+
+void ParticleEffectPool::Initialize(const std::string &name, uint32_t capacity) {
+    template_ = ParticleEffectLibrary::GetInstance()->Load(name);
+
+    manager_ = std::make_unique<ParticleManager>();
+    manager_->Initialize(SrvManager::GetInstance());
+    groups_.clear();
+    for (size_t i = 0; i < template_->groups.size(); ++i) {
+        if (!template_->groups[i]) {
+            continue;
+        }
+        // エミッターと同じグループに入れると互いのパーティクルを上書きするので複製を使う
+        groups_.push_back(template_->groups[i]->Duplicate());
+        manager_->AddParticleGroup(groups_.back().get());
+        manager_->SetParticleSetting(template_->groupNames[i], template_->settings[i]);
+        if (!template_->emitModels[i].empty()) {
+            manager_->SetEmitMesh(template_->groupNames[i], MeshSurfaceSampler::Load(template_->emitModels[i]));
+        }
+        if (!template_->forceFields[i].empty()) {
+            manager_->SetForceField(template_->groupNames[i], ParticleForceFieldManager::GetInstance()->Load(template_->forceFields[i]));
+        }
+    }
+
+    instances_.assign(capacity, Instance{});
+    freeList_.clear();
+    freeList_.reserve(capacity);
+    // 若い番号から取り出せるよう逆順に積む
+    for (uint32_t i = capacity; i > 0; --i) {
+        freeList_.push_back(i - 1);
+    }
+
+    ParticleEmitterManager::GetInstance()->RegisterPool(this);
+}
+
+ParticleEffectPool::Handle ParticleEffectPool::Spawn(const Vector3 &position, float duration) {
+    return Spawn(position, template_ ? template_->rotation : Vector3{0.0f, 0.0f, 0.0f}, duration);
+}
+
+ParticleEffectPool::Handle ParticleEffectPool::Spawn(const Vector3 &position, const Vector3 &rotation, float duration) {
+    if (freeList_.empty()) {
+        return Handle{};
+    }
+    uint32_t index = freeList_.back();
+    freeList_.pop_back();
+
+    Instance &instance = instances_[index];
+    uint32_t generation = instance.generation + 1;
+    instance = Instance{};
+    instance.translation = position;
+    instance.rotation = rotation;
+    instance.duration = duration;
+    instance.generation = generation;
+    instance.inUse = true;
+    instance.isBurstPending = !template_->isAuto;
+    return Handle{index, generation};
+}
+
+void ParticleEffectPool::Stop(Handle handle) {
+    if (Find(handle)) {
+        Release(handle.index);
+    }
+}
+
+void ParticleEffectPool::SetTranslation(Handle handle, const Vector3 &translation) {
+    if (Instance *instance = Find(handle)) {
+        instance->translation = translation;
+    }
+}
+
+bool ParticleEffectPool::IsAlive(Handle handle) const {
+    return handle.index < instances_.size() && instances_[handle.index].inUse &&
+           instances_[handle.index].generation == handle.generation;
+}
+
+ParticleEffectPool::Instance *ParticleEffectPool::Find(Handle handle) {
+    return IsAlive(handle) ? &instances_[handle.index] : nullptr;
+}
+
+void ParticleEffectPool::Step(float deltaTime) {
+    if (!manager_) {
+        return;
+    }
+    for (uint32_t index = 0; index < instances_.size(); ++index) {
+        Instance &instance = instances_[index];
+        if (!instance.inUse) {
+            continue;
+        }
+        // 単発は1回出したら返す(パーティクルはグループ側で寿命まで残る)
+        if (instance.isBurstPending) {
+            Emit(instance);
+            Release(index);
+            continue;
+        }
+        instance.age += deltaTime;
+        instance.elapsedTime += deltaTime;
+        if (template_->emitFrequency > 0.0f) {
+            while (instance.elapsedTime >= template_->emitFrequency) {
+                Emit(instance);
+                instance.elapsedTime -= template_->emitFrequency;
+            }
+        }
+        if (instance.duration > 0.0f && instance.age >= instance.duration) {
+            Release(index);
+        }
+    }
+    manager_->Simulate(deltaTime);
+}
+
+void ParticleEffectPool::Emit(const Instance &instance) {
+    manager_->SetEmitTransform(instance.translation, instance.rotation, template_->scale);
+    manager_->Emit();
+}
+
+void ParticleEffectPool::Release(uint32_t index) {
+    instances_[index].inUse = false;
+    freeList_.push_back(index);
+}
+
+void ParticleEffectPool::WriteInstances(const ViewProjection &viewProjection, float interpolation) {
+    if (manager_) {
+        manager_->WriteInstances(viewProjection, interpolation);
+    }
+}
+
+void ParticleEffectPool::Draw() {
+    if (manager_) {
+        manager_->Draw();
+    }
+}
+
+void ParticleEffectPool::Clear() {
+    for (uint32_t index = 0; index < instances_.size(); ++index) {
+        if (instances_[index].inUse) {
+            Release(index);
+        }
+    }
+    if (manager_) {
+        manager_->Clear();
+    }
+}
+
+size_t ParticleEffectPool::GetParticleCount() const {
+    return manager_ ? manager_->GetParticleCount() : 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "ParticleEffectLibrary.h"
+#include "ParticleManager.h"
+#include "ViewProjection/ViewProjection.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// 同じテンプレートのエフェクトを使い回すプール
+/// インスタンスは事前確保し、発生は空きリストからの取り出しだけで行う
+/// パーティクルは名前で共有されるグループではなく、プール専用に複製したグループに入れる
+/// </summary>
+class ParticleEffectPool {
+  public:
+    // 発生させたインスタンスの識別子(再利用後の古いハンドルは無効になる)
+    struct Handle {
+        uint32_t index = kInvalidIndex;
+        uint32_t generation = 0;
+        bool IsValid() const { return index != kInvalidIndex; }
+    };
+
+    static const uint32_t kInvalidIndex = UINT32_MAX;
+
+  public:
+    ParticleEffectPool() = default;
+    ~ParticleEffectPool();
+
+    /// <summary>
+    /// 初期化(テンプレートの読み込みとインスタンスの確保はここだけ)
+    /// </summary>
+    void Initialize(const std::string &name, uint32_t capacity);
+
+    /// <summary>
+    /// エフェクトの発生
+    /// </summary>
+    /// <param name="duration">自動発生の継続秒数(0ならStopまで)。単発のテンプレートでは無視</param>
+    /// <returns>空きが無ければ無効なハンドル</returns>
+    Handle Spawn(const Vector3 &position, float duration = 0.0f);
+    Handle Spawn(const Vector3 &position, const Vector3 &rotation, float duration = 0.0f);
+
+    /// <summary>
+    /// 発生を止めてプールに返す(出たパーティクルは寿命まで残る)
+    /// </summary>
+    void Stop(Handle handle);
+
+    // 発生中のインスタンスを動かす(追従させる場合)
+    void SetTranslation(Handle handle, const Vector3 &translation);
+    bool IsAlive(Handle handle) const;
+
+    /// <summary>
+    /// 発生とシミュレーションを1ステップ進める
+    /// </summary>
+    void Step(float deltaTime);
+
+    /// <summary>
+    /// インスタンスデータの書き込み
+    /// </summary>
+    void WriteInstances(const ViewProjection &viewProjection, float interpolation);
+
+    /// <summary>
+    /// 描画
+    /// </summary>
+    void Draw();
+
+    // 全インスタンスとパーティクルを破棄
+    void Clear();
+
+    const ParticleEffectTemplate *GetTemplate() const { return template_; }
+    uint32_t GetCapacity() const { return static_cast<uint32_t>(instances_.size()); }
+    uint32_t GetActiveCount() const { return static_cast<uint32_t>(instances_.size() - freeList_.size()); }
+    size_t GetParticleCount() const;
+
+  private:
+    // 発生中のエフェクト1つ分の状態
+    struct Instance {
+        Vector3 translation;
+        Vector3 rotation;
+        float elapsedTime = 0.0f; // 発生間隔のタイマー
+        float age = 0.0f;
+        float duration = 0.0f;
+        uint32_t generation = 0;
+        bool inUse = false;
+        bool isBurstPending = false; // 単発のテンプレートで、次のステップで発生させる
+    };
+
+    Instance *Find(Handle handle);
+    void Emit(const Instance &instance);
+    void Release(uint32_t index);
+
+  private:
+    const ParticleEffectTemplate *template_ = nullptr;
+    std::vector<std::unique_ptr<ParticleGroup>> groups_; // manager_より先に宣言して後に破棄する
+    std::unique_ptr<ParticleManager> manager_;
+    std::vector<Instance> instances_;
+    std::vector<uint32_t> freeList_;
+};
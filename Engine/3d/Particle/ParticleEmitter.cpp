@@ -3,28 +3,56 @@
 #include "Engine/Frame/Frame.h"
 #include "line/DrawLine3D.h"
 
+#include "MeshSurfaceSampler.h"
+#include "Object/Object3d.h"
+#include "ParticleForceField.h"
+#include "ParticleEffectLibrary.h"
+#include "ParticleEmitterManager.h"
 #include "ParticleGroupManager.h"
+#include "Thread/ThreadPool.h"
 #include <set>
 // コンストラクタ
 ParticleEmitter::ParticleEmitter() {}
 
+ParticleEmitter::~ParticleEmitter() {
+    if (prewarmTask_.valid()) {
+        prewarmTask_.wait();
+    }
+    if (Manager_) {
+        ParticleEmitterManager::GetInstance()->Unregister(this);
+    }
+}
+
 void ParticleEmitter::Initialize(std::string name) {
     transform_.Initialize();
     if (!name.empty()) {
         name_ = name;
-        datas_ = std::make_unique<DataHandler>("Particle", name_);
-        LoadFromJson();
+        // JSONはライブラリで1回だけ読み、以降は共有テンプレートから設定する
+        const ParticleEffectTemplate *effect = ParticleEffectLibrary::GetInstance()->Load(name_);
+        LoadFromTemplate(*effect);
         Manager_ = std::make_unique<ParticleManager>();
         Manager_->Initialize(SrvManager::GetInstance());
-        LoadParticleGroup();
+        LoadParticleGroup(*effect);
         datas_ = std::make_unique<DataHandler>("Particle", name_);
+        ParticleEmitterManager::GetInstance()->Register(this);
+        if (prewarmTime_ > 0.0f) {
+            PrewarmAsync(prewarmTime_);
+        }
     }
 }
 
 // Update関数
 void ParticleEmitter::Update() {
+    FinishPrewarm(false);
+    if (isPrewarming_) {
+        return;
+    }
+    UpdateEmission(Frame::DeltaTime());
+}
+
+void ParticleEmitter::UpdateEmission(float deltaTime) {
     // 経過時間を進める
-    elapsedTime_ += Frame::DeltaTime();
+    elapsedTime_ += deltaTime;
 
     // 発生頻度に基づいてパーティクルを発生させる
     while (elapsedTime_ >= emitFrequency_) {
@@ -34,6 +62,7 @@ void ParticleEmitter::Update() {
 }
 
 void ParticleEmitter::UpdateOnce() {
+    ParticleEmitterManager::GetInstance()->GetRecorder().RecordBurst(*this);
     isActive_ = false;
     if (!isActive_) {
         Emit(); // パーティクルを発生させる
@@ -41,14 +70,135 @@ void ParticleEmitter::UpdateOnce() {
     }
 }
 
-void ParticleEmitter::Draw(const ViewProjection &vp_) {
+void ParticleEmitter::Tick(const ViewProjection &vp_) {
+    Step(Frame::DeltaTime());
+    WriteInstances(vp_, 1.0f);
+}
+
+void ParticleEmitter::Step(float deltaTime) {
+    FinishPrewarm(false);
+    if (isPrewarming_) {
+        return;
+    }
     if (isAuto_) {
-        Update();
+        UpdateEmission(deltaTime);
+    }
+    if (Manager_) {
+        Manager_->Simulate(deltaTime);
     }
+}
 
+void ParticleEmitter::WriteInstances(const ViewProjection &vp_, float interpolation) {
+    FinishPrewarm(false);
+    if (isPrewarming_) {
+        return;
+    }
     transform_.UpdateMatrix();
     if (Manager_) {
-        Manager_->Update(vp_);
+        Manager_->WriteInstances(vp_, interpolation);
+    }
+}
+
+void ParticleEmitter::Reset() {
+    FinishPrewarm(true);
+    elapsedTime_ = 0.0f;
+    if (Manager_) {
+        Manager_->Clear();
+    }
+}
+
+void ParticleEmitter::SetSeed(uint32_t seed) {
+    FinishPrewarm(true);
+    if (Manager_) {
+        Manager_->SetSeed(seed);
+    }
+}
+
+void ParticleEmitter::Prewarm(float seconds) {
+    FinishPrewarm(true);
+    if (!Manager_ || seconds <= 0.0f || emitFrequency_ <= 0.0f) {
+        return;
+    }
+    ApplyTransformToSettings();
+    elapsedTime_ = AdvancePrewarm(seconds, emitFrequency_, elapsedTime_);
+}
+
+float ParticleEmitter::AdvancePrewarm(float seconds, float frequency, float elapsedTime) {
+    // ワーカースレッドからも呼ぶので、触ってよいのはManager_だけ
+    if (Manager_->CanPrewarmAnalytically()) {
+        // 生き残るのは最後の寿命分の発生だけなので、その区間だけを発生させる
+        float windowStart = std::max(0.0f, seconds - Manager_->GetMaxLifeTime());
+        uint32_t first = std::max(1u, static_cast<uint32_t>(std::ceil(windowStart / frequency)));
+        uint32_t last = static_cast<uint32_t>(std::floor(seconds / frequency));
+        for (uint32_t index = first; index <= last; ++index) {
+            Manager_->EmitAdvanced(seconds - frequency * static_cast<float>(index));
+        }
+        return std::fmod(seconds, frequency);
+    }
+    // 解析できない動きは粗いステップで進める
+    const float kCoarseDeltaTime = 1.0f / 20.0f;
+    float remaining = seconds;
+    while (remaining > 0.0f) {
+        float deltaTime = std::min(kCoarseDeltaTime, remaining);
+        elapsedTime += deltaTime;
+        while (elapsedTime >= frequency) {
+            Manager_->Emit();
+            elapsedTime -= frequency;
+        }
+        Manager_->Simulate(deltaTime);
+        remaining -= deltaTime;
+    }
+    return elapsedTime;
+}
+
+void ParticleEmitter::PrewarmAsync(float seconds) {
+    FinishPrewarm(true);
+    if (!Manager_ || seconds <= 0.0f || emitFrequency_ <= 0.0f) {
+        return;
+    }
+    // 発生位置はここで確定させ、ワーカーは共有のグループやtransform_に触らない
+    ApplyTransformToSettings();
+    Manager_->BeginStaging();
+    isPrewarming_ = true;
+    float frequency = emitFrequency_;
+    float elapsedTime = elapsedTime_;
+    prewarmTask_ = ThreadPool::GetInstance()->Submit([this, seconds, frequency, elapsedTime]() {
+        prewarmElapsedTime_ = AdvancePrewarm(seconds, frequency, elapsedTime);
+    });
+}
+
+void ParticleEmitter::FinishPrewarm(bool isWait) {
+    if (!prewarmTask_.valid()) {
+        return;
+    }
+    if (!isWait && prewarmTask_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    prewarmTask_.get();
+    Manager_->CommitStaging();
+    elapsedTime_ = prewarmElapsedTime_;
+    isPrewarming_ = false;
+}
+
+void ParticleEmitter::GetBoundingSphere(Vector3 &center, float &radius) const {
+    Vector3 min;
+    Vector3 max;
+    if (Manager_ && !isPrewarming_ && Manager_->GetBounds(min, max)) {
+        // パーティクル自体の大きさ分として1.0の余裕を持たせる
+        center = (min + max) * 0.5f;
+        radius = (max - min).Length() * 0.5f + 1.0f;
+        return;
+    }
+    center = transform_.translation_;
+    radius = transform_.scale_.Length();
+}
+
+size_t ParticleEmitter::GetParticleCount() const {
+    return Manager_ ? Manager_->GetParticleCount() : 0;
+}
+
+void ParticleEmitter::Draw() {
+    if (Manager_) {
         Manager_->Draw();
     }
     DrawEmitter();
@@ -83,18 +233,29 @@ void ParticleEmitter::DrawEmitter() {
 
 // Emit関数
 void ParticleEmitter::Emit() {
+    FinishPrewarm(true);
     if (Manager_) {
-        for (auto &[groupName, setting] : particleSettings_) {
-            // ここでtransform_の値をParticleSettingに反映
-            setting.translate = transform_.translation_;
-            setting.rotation = transform_.rotation_;
-            setting.scale = transform_.scale_;
-            Manager_->SetParticleSetting(groupName, setting);
+        ApplyTransformToSettings();
+        // スキンメッシュは追従するオブジェクトの現在のポーズから発生させる
+        for (const auto &[groupName, object] : emitMeshSources_) {
+            if (const Skeleton *skeleton = object->GetSkeleton()) {
+                Manager_->SetEmitMeshPose(groupName, *skeleton);
+            }
         }
         Manager_->Emit();
     }
 }
 
+void ParticleEmitter::ApplyTransformToSettings() {
+    for (auto &[groupName, setting] : particleSettings_) {
+        // ここでtransform_の値をParticleSettingに反映
+        setting.translate = transform_.translation_;
+        setting.rotation = transform_.rotation_;
+        setting.scale = transform_.scale_;
+        Manager_->SetParticleSetting(groupName, setting);
+    }
+}
+
 #pragma region ImGui関連
 
 void ParticleEmitter::SaveToJson() {
@@ -106,6 +267,7 @@ void ParticleEmitter::SaveToJson() {
     datas_->Save("isVisible", isVisible_);
     datas_->Save("isActive", isActive_);
     datas_->Save("isAuto", isAuto_);
+    datas_->Save("prewarmTime", prewarmTime_);
     for (const auto &[groupName, setting] : particleSettings_) {
         datas_->Save(groupName + "_translate", setting.translate);
         datas_->Save(groupName + "_rotation", setting.rotation);
@@ -141,6 +303,18 @@ void ParticleEmitter::SaveToJson() {
         datas_->Save(groupName + "_isFaceDirection", setting.isFaceDirection);
         datas_->Save(groupName + "_isEndScale", setting.isEndScale);
         datas_->Save(groupName + "_isEmitOnEdge", setting.isEmitOnEdge);
+        datas_->Save(groupName + "_emitShape", static_cast<int>(setting.emitShape));
+        datas_->Save(groupName + "_isEmitOnShell", setting.isEmitOnShell);
+        datas_->Save(groupName + "_coneAngle", setting.coneAngle);
+        datas_->Save(groupName + "_ringInnerRatio", setting.ringInnerRatio);
+        datas_->Save(groupName + "_shapeNormalSpeed", setting.shapeNormalSpeed);
+        auto modelIt = emitModelPaths_.find(groupName);
+        datas_->Save(groupName + "_emitModel", modelIt != emitModelPaths_.end() ? modelIt->second : std::string());
+        auto fieldIt = forceFieldNames_.find(groupName);
+        datas_->Save(groupName + "_forceField", fieldIt != forceFieldNames_.end() ? fieldIt->second : std::string());
+        datas_->Save(groupName + "_forceFieldScale", setting.forceFieldScale);
+        datas_->Save(groupName + "_neighbor", setting.neighbor);
+        datas_->Save(groupName + "_collision", setting.collision);
         datas_->Save(groupName + "_isGatherMode", setting.isGatherMode);
         datas_->Save(groupName + "_gatherStartRatio", setting.gatherStartRatio);
         datas_->Save(groupName + "_gatherStrength", setting.gatherStrength);
@@ -156,79 +330,78 @@ void ParticleEmitter::SaveToJson() {
         datas_->Save(groupName + "_trailVelocityScale", setting.trailVelocityScale);
         datas_->Save(groupName + "_startColor", setting.startColor);
         datas_->Save(groupName + "_endColor", setting.endColor);
+        datas_->Save(groupName + "_colorCurve", setting.colorCurve);
+        datas_->Save(groupName + "_scaleCurve", setting.scaleCurve);
+        datas_->Save(groupName + "_acceCurve", setting.acceCurve);
         Manager_->SetParticleSetting(groupName, setting);
     }
+    // 共有テンプレートにも反映する
+    ParticleEffectLibrary::GetInstance()->Reload(name_);
 }
 
-void ParticleEmitter::LoadFromJson() {
-    transform_.translation_ = datas_->Load<Vector3>("emitterTranslation", {0, 0, 0});
-    transform_.rotation_ = datas_->Load<Vector3>("emitterRotation", {0, 0, 0});
-    transform_.scale_ = datas_->Load<Vector3>("emitterScale", {1, 1, 1});
-    particleGroupNames_ = datas_->Load<std::vector<std::string>>("GroupNames", {});
-    emitFrequency_ = datas_->Load<float>("emitFrequency", 0.1f);
-    isVisible_ = datas_->Load<bool>("isVisible", true);
-    isActive_ = datas_->Load<bool>("isActive", false);
-    isAuto_ = datas_->Load<bool>("isAuto", false);
-
-    for (const auto &groupName : particleGroupNames_) {
-        ParticleSetting setting;
-        setting.translate = datas_->Load<Vector3>(groupName + "_translate", {0, 0, 0});
-        setting.rotation = datas_->Load<Vector3>(groupName + "_rotation", {0, 0, 0});
-        setting.scale = datas_->Load<Vector3>(groupName + "_scale", {1, 1, 1});
-        setting.count = datas_->Load<uint32_t>(groupName + "_count", 1);
-        setting.lifeTimeMin = datas_->Load<float>(groupName + "_lifeTimeMin", 1.0f);
-        setting.lifeTimeMax = datas_->Load<float>(groupName + "_lifeTimeMax", 3.0f);
-        setting.alphaMin = datas_->Load<float>(groupName + "_alphaMin", 1.0f);
-        setting.alphaMax = datas_->Load<float>(groupName + "_alphaMax", 1.0f);
-        setting.scaleMin = datas_->Load<float>(groupName + "_scaleMin", 1.0f);
-        setting.scaleMax = datas_->Load<float>(groupName + "_scaleMax", 1.0f);
-        setting.velocityMin = datas_->Load<Vector3>(groupName + "_velocityMin", {-1, -1, -1});
-        setting.velocityMax = datas_->Load<Vector3>(groupName + "_velocityMax", {1, 1, 1});
-        setting.particleStartScale = datas_->Load<Vector3>(groupName + "_startScale", {1, 1, 1});
-        setting.particleEndScale = datas_->Load<Vector3>(groupName + "_endScale", {0, 0, 0});
-        setting.startAcce = datas_->Load<Vector3>(groupName + "_startAcce", {1, 1, 1});
-        setting.endAcce = datas_->Load<Vector3>(groupName + "_endAcce", {1, 1, 1});
-        setting.startRote = datas_->Load<Vector3>(groupName + "_startRote", {0, 0, 0});
-        setting.endRote = datas_->Load<Vector3>(groupName + "_endRote", {0, 0, 0});
-        setting.rotateStartMax = datas_->Load<Vector3>(groupName + "_rotateStartMax", {0, 0, 0});
-        setting.rotateStartMin = datas_->Load<Vector3>(groupName + "_rotateStartMin", {0, 0, 0});
-        setting.rotateVelocityMin = datas_->Load<Vector3>(groupName + "_rotateVelocityMin", {-0.07f, -0.07f, -0.07f});
-        setting.rotateVelocityMax = datas_->Load<Vector3>(groupName + "_rotateVelocityMax", {0.07f, 0.07f, 0.07f});
-        setting.allScaleMin = datas_->Load<Vector3>(groupName + "_allScaleMin", {0, 0, 0});
-        setting.allScaleMax = datas_->Load<Vector3>(groupName + "_allScaleMax", {1, 1, 1});
-        setting.isRandomSize = datas_->Load<bool>(groupName + "_isRandomScale", false);
-        setting.isRandomAllSize = datas_->Load<bool>(groupName + "_isAllRamdomScale", false);
-        setting.isRandomColor = datas_->Load<bool>(groupName + "_isRandomColor", false);
-        setting.isRandomRotate = datas_->Load<bool>(groupName + "_isRandomRotate", false);
-        setting.isBillboard = datas_->Load<bool>(groupName + "_isBillboard", false);
-        setting.isAcceMultiply = datas_->Load<bool>(groupName + "_isAcceMultiply", false);
-        setting.isSinMove = datas_->Load<bool>(groupName + "_isSinMove", false);
-        setting.isFaceDirection = datas_->Load<bool>(groupName + "_isFaceDirection", false);
-        setting.isEndScale = datas_->Load<bool>(groupName + "_isEndScale", false);
-        setting.isEmitOnEdge = datas_->Load<bool>(groupName + "_isEmitOnEdge", false);
-        setting.isGatherMode = datas_->Load<bool>(groupName + "_isGatherMode", false);
-        setting.gatherStartRatio = datas_->Load<float>(groupName + "_gatherStartRatio", 0.0f);
-        setting.gatherStrength = datas_->Load<float>(groupName + "_gatherStrength", 0.0f);
-        setting.gravity = datas_->Load<float>(groupName + "_gravity", 0.0f);
-        setting.isBillboard = datas_->Load<float>(groupName + "_isBillboard", false);
-        setting.enableTrail = datas_->Load<bool>(groupName + "_enableTrail", false);
-        setting.trailSpawnInterval = datas_->Load<float>(groupName + "_trailSpawnInterval", 0.05f);
-        setting.maxTrailParticles = datas_->Load<int>(groupName + "_maxTrailParticles", 20);
-        setting.trailLifeScale = datas_->Load<float>(groupName + "_trailLifeScale", 0.5f);
-        setting.trailScaleMultiplier = datas_->Load<Vector3>(groupName + "_trailScaleMultiplier", {0.8f, 0.8f, 0.8f});
-        setting.trailColorMultiplier = datas_->Load<Vector4>(groupName + "_trailColorMultiplier", {1.0f, 1.0f, 1.0f, 0.7f});
-        setting.trailInheritVelocity = datas_->Load<bool>(groupName + "_trailInheritVelocity", true);
-        setting.trailVelocityScale = datas_->Load<float>(groupName + "_trailVelocityScale", 0.3f);
-        setting.startColor = datas_->Load<Vector4>(groupName + "_startColor", {1.0f, 1.0f, 1.0f, 1.0f});
-        setting.endColor = datas_->Load<Vector4>(groupName + "_endColor", {1.0f, 1.0f, 1.0f, 1.0f});
-
-        particleSettings_[groupName] = setting;
-    }
-}
-
-void ParticleEmitter::LoadParticleGroup() {
-    for (auto &particleGroupname : particleGroupNames_) {
-        AddParticleGroup(ParticleGroupManager::GetInstance()->GetParticleGroup(particleGroupname));
+void ParticleEmitter::LoadFromTemplate(const ParticleEffectTemplate &effect) {
+    transform_.translation_ = effect.translation;
+    transform_.rotation_ = effect.rotation;
+    transform_.scale_ = effect.scale;
+    particleGroupNames_ = effect.groupNames;
+    emitFrequency_ = effect.emitFrequency;
+    isVisible_ = effect.isVisible;
+    isActive_ = effect.isActive;
+    isAuto_ = effect.isAuto;
+    prewarmTime_ = effect.prewarmTime;
+
+    for (size_t i = 0; i < effect.groupNames.size(); ++i) {
+        particleSettings_[effect.groupNames[i]] = effect.settings[i];
+        if (!effect.emitModels[i].empty()) {
+            emitModelPaths_[effect.groupNames[i]] = effect.emitModels[i];
+        }
+        if (!effect.forceFields[i].empty()) {
+            forceFieldNames_[effect.groupNames[i]] = effect.forceFields[i];
+        }
+    }
+}
+
+void ParticleEmitter::LoadParticleGroup(const ParticleEffectTemplate &effect) {
+    for (ParticleGroup *group : effect.groups) {
+        AddParticleGroup(group);
+    }
+    for (const auto &[groupName, modelPath] : emitModelPaths_) {
+        Manager_->SetEmitMesh(groupName, MeshSurfaceSampler::Load(modelPath));
+    }
+    for (const auto &[groupName, fieldName] : forceFieldNames_) {
+        Manager_->SetForceField(groupName, ParticleForceFieldManager::GetInstance()->Load(fieldName));
+    }
+}
+
+void ParticleEmitter::SetForceField(const std::string &groupName, const std::string &fieldName) {
+    if (fieldName.empty()) {
+        forceFieldNames_.erase(groupName);
+    } else {
+        forceFieldNames_[groupName] = fieldName;
+    }
+    FinishPrewarm(true);
+    if (Manager_) {
+        Manager_->SetForceField(groupName, fieldName.empty() ? nullptr : ParticleForceFieldManager::GetInstance()->Load(fieldName));
+    }
+}
+
+void ParticleEmitter::SetEmitMesh(const std::string &groupName, const std::string &modelPath) {
+    if (modelPath.empty()) {
+        emitModelPaths_.erase(groupName);
+    } else {
+        emitModelPaths_[groupName] = modelPath;
+    }
+    FinishPrewarm(true);
+    if (Manager_) {
+        Manager_->SetEmitMesh(groupName, modelPath.empty() ? nullptr : MeshSurfaceSampler::Load(modelPath));
+    }
+}
+
+void ParticleEmitter::SetEmitMeshSource(const std::string &groupName, const Object3d *object) {
+    if (object) {
+        emitMeshSources_[groupName] = object;
+    } else {
+        emitMeshSources_.erase(groupName);
     }
 }
 
@@ -361,7 +534,49 @@ void ParticleEmitter::DebugParticleData() {
                             ImGui::DragFloat("強さ", &setting.gatherStrength, 0.1f);
                             ImGui::DragFloat("始まるタイミング", &setting.gatherStartRatio, 0.1f);
                         }
-                        ImGui::Checkbox("外周", &setting.isEmitOnEdge);
+                        const char *shapeNames[] = {"箱", "箱の辺", "球", "円錐", "リング", "モデル表面"};
+                        int shape = static_cast<int>(setting.emitShape);
+                        if (ImGui::Combo("発生形状", &shape, shapeNames, IM_ARRAYSIZE(shapeNames))) {
+                            setting.emitShape = static_cast<EmitShape>(shape);
+                            setting.isEmitOnEdge = false;
+                        }
+                        switch (setting.emitShape) {
+                        case EmitShape::Sphere:
+                            ImGui::Checkbox("表面のみ", &setting.isEmitOnShell);
+                            break;
+                        case EmitShape::Cone:
+                            ImGui::SliderAngle("開き角", &setting.coneAngle, 0.0f, 90.0f);
+                            break;
+                        case EmitShape::Ring:
+                            ImGui::SliderFloat("内径の比率", &setting.ringInnerRatio, 0.0f, 1.0f);
+                            break;
+                        case EmitShape::MeshSurface: {
+                            char modelPath[128] = {};
+                            auto modelIt = emitModelPaths_.find(selectedGroup);
+                            if (modelIt != emitModelPaths_.end()) {
+                                strcpy_s(modelPath, sizeof(modelPath), modelIt->second.c_str());
+                            }
+                            if (ImGui::InputText("モデル", modelPath, sizeof(modelPath), ImGuiInputTextFlags_EnterReturnsTrue)) {
+                                SetEmitMesh(selectedGroup, modelPath);
+                            }
+                            // プリミティブ形状はモデル欄に "primitive:名前" を入れる
+                            int primitive = 0;
+                            const char *primitiveNames[std::size(MeshSurfaceSampler::kPrimitiveNames) + 1] = {"(モデルファイル)"};
+                            for (size_t i = 0; i < std::size(MeshSurfaceSampler::kPrimitiveNames); ++i) {
+                                primitiveNames[i + 1] = MeshSurfaceSampler::kPrimitiveNames[i];
+                                if (MeshSurfaceSampler::GetPrimitivePath(static_cast<PrimitiveType>(i + 1)) == modelPath) {
+                                    primitive = static_cast<int>(i + 1);
+                                }
+                            }
+                            if (ImGui::Combo("プリミティブ", &primitive, primitiveNames, IM_ARRAYSIZE(primitiveNames)) && primitive > 0) {
+                                SetEmitMesh(selectedGroup, MeshSurfaceSampler::GetPrimitivePath(static_cast<PrimitiveType>(primitive)));
+                            }
+                            break;
+                        }
+                        default:
+                            break;
+                        }
+                        ImGui::DragFloat("法線方向の初速", &setting.shapeNormalSpeed, 0.01f);
                         ImGui::TreePop();
                     }
 
@@ -383,6 +598,89 @@ void ParticleEmitter::DebugParticleData() {
                         ImGui::DragFloat3("最後", &setting.endAcce.x, 0.001f);
                         ImGui::Checkbox("乗算", &setting.isAcceMultiply);
                         ImGui::DragFloat("重力", &setting.gravity, 0.01f, -FLT_MAX, FLT_MAX);
+                        DebugCurve("加速度カーブ", setting.acceCurve, false);
+                        char fieldName[64] = {};
+                        auto fieldIt = forceFieldNames_.find(selectedGroup);
+                        if (fieldIt != forceFieldNames_.end()) {
+                            strcpy_s(fieldName, sizeof(fieldName), fieldIt->second.c_str());
+                        }
+                        if (ImGui::InputText("力場", fieldName, sizeof(fieldName), ImGuiInputTextFlags_EnterReturnsTrue)) {
+                            SetForceField(selectedGroup, fieldName);
+                        }
+                        ImGui::DragFloat("力場の倍率", &setting.forceFieldScale, 0.01f);
+                        ImGui::TreePop();
+                    }
+
+                    ImGui::Separator();
+
+                    // 近傍の振る舞い
+                    if (ImGui::TreeNode("近傍の振る舞い")) {
+                        ParticleNeighborSetting &neighbor = setting.neighbor;
+                        const char *modeNames[] = {"なし", "分離", "群れ", "簡易流体"};
+                        int mode = static_cast<int>(neighbor.mode);
+                        if (ImGui::Combo("モード", &mode, modeNames, IM_ARRAYSIZE(modeNames))) {
+                            neighbor.mode = static_cast<NeighborMode>(mode);
+                        }
+                        if (neighbor.mode != NeighborMode::None) {
+                            ImGui::DragFloat("近傍の半径", &neighbor.radius, 0.01f, 0.01f, 100.0f);
+                            int maxNeighbors = static_cast<int>(neighbor.maxNeighbors);
+                            if (ImGui::SliderInt("近傍の上限", &maxNeighbors, 1, 128)) {
+                                neighbor.maxNeighbors = static_cast<uint32_t>(maxNeighbors);
+                            }
+                        }
+                        if (neighbor.mode == NeighborMode::Separation || neighbor.mode == NeighborMode::Flock) {
+                            ImGui::DragFloat("分離", &neighbor.separationWeight, 0.01f, 0.0f, FLT_MAX);
+                        }
+                        if (neighbor.mode == NeighborMode::Flock) {
+                            ImGui::DragFloat("整列", &neighbor.alignmentWeight, 0.01f, 0.0f, FLT_MAX);
+                            ImGui::DragFloat("結合", &neighbor.cohesionWeight, 0.01f, 0.0f, FLT_MAX);
+                        }
+                        if (neighbor.mode == NeighborMode::Fluid) {
+                            ImGui::DragFloat("圧力", &neighbor.stiffness, 0.01f, 0.0f, FLT_MAX);
+                            ImGui::DragFloat("基準密度", &neighbor.restDensity, 0.01f, 0.0f, FLT_MAX);
+                            ImGui::DragFloat("粘性", &neighbor.viscosity, 0.01f, 0.0f, FLT_MAX);
+                        }
+                        ImGui::TreePop();
+                    }
+
+                    ImGui::Separator();
+
+                    // 当たり判定
+                    if (ImGui::TreeNode("当たり判定")) {
+                        ParticleCollisionSetting &collision = setting.collision;
+                        const char *responseNames[] = {"なし", "反射", "張り付く", "消える"};
+                        int response = static_cast<int>(collision.response);
+                        if (ImGui::Combo("応答", &response, responseNames, IM_ARRAYSIZE(responseNames))) {
+                            collision.response = static_cast<ParticleCollisionResponse>(response);
+                        }
+                        if (collision.response != ParticleCollisionResponse::None) {
+                            ImGui::Checkbox("シーンのコライダー", &collision.isCollideScene);
+                            ImGui::DragFloat("半径", &collision.radius, 0.01f, 0.0f, 100.0f);
+                            if (collision.response == ParticleCollisionResponse::Bounce) {
+                                ImGui::SliderFloat("反発係数", &collision.restitution, 0.0f, 1.0f);
+                                ImGui::SliderFloat("摩擦", &collision.friction, 0.0f, 1.0f);
+                            }
+                            for (uint32_t i = 0; i < collision.planeCount; ++i) {
+                                ImGui::PushID(static_cast<int>(i));
+                                ParticleCollisionSetting::Plane &plane = collision.planes[i];
+                                if (ImGui::DragFloat3("平面の法線", &plane.normal.x, 0.01f)) {
+                                    if (plane.normal.LengthSq() > 0.0f) {
+                                        plane.normal = plane.normal.Normalize();
+                                    }
+                                }
+                                ImGui::DragFloat("平面の距離", &plane.distance, 0.1f);
+                                if (ImGui::Button("平面を削除")) {
+                                    for (uint32_t j = i; j + 1 < collision.planeCount; ++j) {
+                                        collision.planes[j] = collision.planes[j + 1];
+                                    }
+                                    --collision.planeCount;
+                                }
+                                ImGui::PopID();
+                            }
+                            if (collision.planeCount < ParticleCollisionSetting::kMaxPlanes && ImGui::Button("平面を追加")) {
+                                collision.planes[collision.planeCount++] = {{0.0f, 1.0f, 0.0f}, 0.0f};
+                            }
+                        }
                         ImGui::TreePop();
                     }
 
@@ -418,6 +716,9 @@ void ParticleEmitter::DebugParticleData() {
                         ImGui::Checkbox("均等にランダムな大きさ", &setting.isRandomSize);
                         ImGui::Checkbox("ばらばらにランダムな大きさ", &setting.isRandomAllSize);
                         ImGui::Checkbox("sin波の動き", &setting.isSinMove);
+                        if (!setting.isSinMove) {
+                            DebugCurve("大きさカーブ(最初の大きさへの倍率)", setting.scaleCurve, false);
+                        }
                         ImGui::TreePop();
                     }
 
@@ -495,7 +796,7 @@ void ParticleEmitter::DebugParticleData() {
                             if (ImGui::DragFloat("トレイル生成間隔", &setting.trailSpawnInterval, 0.001f, 0.001f, 1.0f)) {
                                 SetTrailInterval(selectedGroup, setting.trailSpawnInterval);
                             }
-                            if (ImGui::DragInt("最大トレイルパーティクル数", &setting.maxTrailParticles, 1, 1, 100)) {
+                            if (ImGui::DragInt("トレイル最大点数", &setting.maxTrailParticles, 1, 2, 100)) {
                                 SetMaxTrailParticles(selectedGroup, setting.maxTrailParticles);
                             }
                             if (ImGui::DragFloat("トレイル生存時間スケール", &setting.trailLifeScale, 0.01f, 0.1f, 2.0f)) {
@@ -526,6 +827,7 @@ void ParticleEmitter::DebugParticleData() {
                          if (ImGui::TreeNode("色")) {
                             ImGui::ColorEdit4("開始色", &setting.startColor.x);
                             ImGui::ColorEdit4("終了色", &setting.endColor.x);
+                            DebugCurve("色カーブ(aは透明度の倍率)", setting.colorCurve, true);
                             ImGui::TreePop();
                         }
 
@@ -707,6 +1009,11 @@ void ParticleEmitter::DebugParticleData() {
             }
 
             ImGui::Checkbox("自動生成", &isAuto_);
+            ImGui::DragFloat("プリウォーム秒数", &prewarmTime_, 0.1f, 0.0f, 60.0f);
+            if (!isPrewarming_ && ImGui::Button("プリウォーム")) {
+                Reset();
+                PrewarmAsync(prewarmTime_);
+            }
 
             if (ImGui::Button("生成")) {
                 UpdateOnce();
@@ -719,9 +1026,52 @@ void ParticleEmitter::DebugParticleData() {
 }
 
 // ImGuiで値を動かす関数
+void ParticleEmitter::DebugCurve(const char *label, ParticleCurve &curve, bool isColor) {
+    if (!ImGui::TreeNode(label)) {
+        return;
+    }
+    bool isChanged = ImGui::Checkbox("カーブを使う", &curve.isEnabled);
+    if (curve.isEnabled) {
+        for (uint32_t i = 0; i < curve.keyCount; ++i) {
+            ImGui::PushID(static_cast<int>(i));
+            ImGui::SetNextItemWidth(80.0f);
+            isChanged |= ImGui::SliderFloat("##time", &curve.keys[i].time, 0.0f, 1.0f);
+            ImGui::SameLine();
+            if (isColor) {
+                isChanged |= ImGui::ColorEdit4("##value", &curve.keys[i].value.x, ImGuiColorEditFlags_NoInputs);
+            } else {
+                ImGui::SetNextItemWidth(180.0f);
+                isChanged |= ImGui::DragFloat3("##value", &curve.keys[i].value.x, 0.01f);
+            }
+            ImGui::SameLine();
+            if (curve.keyCount > 1 && ImGui::Button("削除")) {
+                curve.RemoveKey(i);
+                ImGui::PopID();
+                break;
+            }
+            ImGui::PopID();
+        }
+        if (curve.keyCount < ParticleCurve::kMaxKeys && ImGui::Button("キー追加")) {
+            // 最後のキーと同じ値で中間に追加
+            curve.AddKey(0.5f, curve.keyCount > 0 ? curve.keys[curve.keyCount - 1].value : Vector4{1.0f, 1.0f, 1.0f, 1.0f});
+        }
+        // 焼き込み結果のプレビュー
+        float preview[ParticleCurve::kLutSize];
+        for (uint32_t i = 0; i < ParticleCurve::kLutSize; ++i) {
+            preview[i] = isColor ? curve.lut[i].w : curve.lut[i].x;
+        }
+        ImGui::PlotLines(isColor ? "透明度" : "X", preview, ParticleCurve::kLutSize, 0, nullptr, FLT_MAX, FLT_MAX, ImVec2(0.0f, 40.0f));
+    }
+    if (isChanged) {
+        curve.Bake();
+    }
+    ImGui::TreePop();
+}
+
 void ParticleEmitter::Debug() {
 #ifdef _DEBUG
     if (!name_.empty() && Manager_) {
+        FinishPrewarm(true);
         DebugParticleData();
     }
 #endif
@@ -739,6 +1089,7 @@ void ParticleEmitter::AddParticleGroup(ParticleGroup *particleGroup) {
         particleSettings_[groupName] = DefaultSetting();
     }
 
+    FinishPrewarm(true);
     Manager_->AddParticleGroup(particleGroup);
 }
 #pragma endregion
@@ -746,6 +1097,7 @@ void ParticleEmitter::AddParticleGroup(ParticleGroup *particleGroup) {
 void ParticleEmitter::SetTrailEnabled(const std::string &groupName, bool enabled) {
     if (particleSettings_.find(groupName) != particleSettings_.end()) {
         particleSettings_[groupName].enableTrail = enabled;
+        FinishPrewarm(true);
         if (Manager_) {
             Manager_->SetTrailEnabled(groupName, enabled);
         }
@@ -761,6 +1113,7 @@ void ParticleEmitter::SetTrailInterval(const std::string &groupName, float inter
 void ParticleEmitter::SetMaxTrailParticles(const std::string &groupName, int maxTrails) {
     if (particleSettings_.find(groupName) != particleSettings_.end()) {
         particleSettings_[groupName].maxTrailParticles = maxTrails;
+        FinishPrewarm(true);
         if (Manager_) {
             Manager_->SetTrailSettings(groupName,
                                        particleSettings_[groupName].trailSpawnInterval, maxTrails);
@@ -12,11 +12,16 @@
 #include "Data/DataHandler.h"
 #include <filesystem>
 #include <fstream>
+#include <future>
+
+struct ParticleEffectTemplate;
+class Object3d;
 
 class ParticleEmitter {
   public:
     // コンストラクタでメンバ変数を初期化
     ParticleEmitter();
+    ~ParticleEmitter();
 
     void Initialize(std::string name = {});
 
@@ -25,7 +30,29 @@ class ParticleEmitter {
 
     void UpdateOnce();
 
-    void Draw(const ViewProjection &vp_);
+    // 発生とシミュレーションを進め、インスタンスデータを書き込む(更新フェーズ)
+    void Tick(const ViewProjection &vp_);
+
+    // 発生とシミュレーションを1ステップ進める
+    void Step(float deltaTime);
+
+    // インスタンスデータの書き込み(interpolationは前ステップとの補間率)
+    void WriteInstances(const ViewProjection &vp_, float interpolation);
+
+    // パーティクルを破棄して発生タイマーを戻す
+    void Reset();
+
+    // 乱数シードの指定(再現用)
+    void SetSeed(uint32_t seed);
+
+    // seconds秒動かした後の定常状態まで一括で進める
+    void Prewarm(float seconds);
+    // ワーカースレッドで専用のリストにプリウォームし、完了後の最初の更新でグループに移す(それまでTick/WriteInstancesは止まる)
+    void PrewarmAsync(float seconds);
+    bool IsPrewarming() const { return isPrewarming_; }
+
+    // 書き込み済みのインスタンスデータを描画するだけ(何度呼んでもよい)
+    void Draw();
 
     void DrawEmitter();
 
@@ -33,6 +60,7 @@ class ParticleEmitter {
 
     void AddParticleGroup(ParticleGroup *particleGroup);
     void RemoveParticleGroup(const std::string &name) {
+        FinishPrewarm(true);
         Manager_->RemoveParticleGroup(name);
     }
 
@@ -49,6 +77,19 @@ class ParticleEmitter {
     void SetActive(bool isActive) { isActive_ = isActive; }
     void SetFrequency(float frequency) { emitFrequency_ = frequency; }
     void SetName(const std::string &name) { name_ = name; }
+    void SetTranslation(const Vector3 &translation) { transform_.translation_ = translation; }
+    const std::string &GetName() const { return name_; }
+    const Vector3 &GetTranslation() const { return transform_.translation_; }
+    size_t GetParticleCount() const;
+    // パーティクル全体を囲む球(パーティクルが無ければエミッターの箱)
+    void GetBoundingSphere(Vector3 &center, float &radius) const;
+    // MeshSurface形状で使うモデル(空文字で解除)
+    void SetEmitMesh(const std::string &groupName, const std::string &modelPath);
+    // スキンメッシュから発生させる場合に追従するオブジェクト(発生のたびに現在のポーズを使う、nullptrで解除)
+    // モデルはSetEmitMeshで同じファイルを指定しておく
+    void SetEmitMeshSource(const std::string &groupName, const Object3d *object);
+    // 力場(ParticleForceFieldManagerの名前、空文字で解除)
+    void SetForceField(const std::string &groupName, const std::string &fieldName);
     void SetTrailEnabled(const std::string &groupName, bool enabled);
     void SetTrailInterval(const std::string &groupName, float interval);
     void SetMaxTrailParticles(const std::string &groupName, int maxTrails);
@@ -66,21 +107,34 @@ class ParticleEmitter {
   private:
     // パーティクルを発生させるEmit関数
     void Emit();
+    void ApplyTransformToSettings();
+    void UpdateEmission(float deltaTime);
+    // 発生済みの設定のままseconds秒進める(戻り値は進めた後の発生タイマー)
+    float AdvancePrewarm(float seconds, float frequency, float elapsedTime);
+    // 裏のプリウォームが終わっていればグループに移す(isWaitなら終わるまで待つ)
+    void FinishPrewarm(bool isWait);
     void SaveToJson();
-    void LoadFromJson();
-    void LoadParticleGroup();
+    void LoadFromTemplate(const ParticleEffectTemplate &effect);
+    void LoadParticleGroup(const ParticleEffectTemplate &effect);
     ParticleSetting DefaultSetting();
 
     void DebugParticleData();
+    // カーブのキー編集(変更したらLUTを焼き直す)
+    void DebugCurve(const char *label, ParticleCurve &curve, bool isColor);
 
   private:
     using json = nlohmann::json;
-    float elapsedTime_;   // 経過時間
+    float elapsedTime_ = 0.0f; // 経過時間
     float emitFrequency_; // パーティクルの発生頻度
 
     bool isVisible_ = false;
     bool isActive_ = false;
     bool isAuto_ = false;
+    float prewarmTime_ = 0.0f; // ロード時のプリウォーム秒数(0なら無し)
+
+    bool isPrewarming_ = false;
+    std::future<void> prewarmTask_;
+    float prewarmElapsedTime_ = 0.0f; // ワーカーが書き、future越しに受け取る
 
     std::string name_;         // パーティクルの名前
     WorldTransform transform_; // 位置や回転などのトランスフォーム
@@ -90,4 +144,7 @@ class ParticleEmitter {
     std::unique_ptr<ParticleManager> Manager_;
     std::unique_ptr<DataHandler> datas_;
     std::vector<std::string> particleGroupNames_;
+    std::unordered_map<std::string, std::string> emitModelPaths_; // MeshSurface形状のモデル
+    std::unordered_map<std::string, const Object3d *> emitMeshSources_; // スキンメッシュのポーズを取るオブジェクト
+    std::unordered_map<std::string, std::string> forceFieldNames_; // 力場
 };
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "ParticleEmitterManager.h"
+#include "Engine/Frame/Frame.h"
+#include "ParticleEffectPool.h"
+#include "ParticleEmitter.h"
+#include <algorithm>
+
+ParticleEmitterManager *ParticleEmitterManager::instance = nullptr;
+
+ParticleEmitterManager *ParticleEmitterManager::GetInstance() {
+    if (instance == nullptr) {
+        instance = new ParticleEmitterManager();
+    }
+    return instance;
+}
+
+void ParticleEmitterManager::Finalize() {
+    delete instance;
+    instance = nullptr;
+}
+
+void ParticleEmitterManager::Update(const ViewProjection &viewProjection) {
+    float deltaTime = Frame::DeltaTime();
+    recorder_.RecordFrame(deltaTime, viewProjection);
+    float interpolation = Simulate(deltaTime, viewProjection);
+
+    for (size_t i = 0; i < emitters_.size(); ++i) {
+        // 間引くのは視野外だけなので、進めたフレームだけ書き込めば見た目は変わらない
+        if (!schedules_[i].isReduced) {
+            emitters_[i]->WriteInstances(viewProjection, interpolation);
+        } else if (schedules_[i].isSimulated) {
+            emitters_[i]->WriteInstances(viewProjection, 1.0f);
+        }
+    }
+    for (ParticleEffectPool *pool : pools_) {
+        pool->WriteInstances(viewProjection, interpolation);
+    }
+}
+
+float ParticleEmitterManager::Simulate(float deltaTime, const ViewProjection &viewProjection) {
+    UpdateSchedule(viewProjection);
+    float interpolation = Step(deltaTime);
+    UpdateReducedEmitters();
+    return interpolation;
+}
+
+float ParticleEmitterManager::Step(float deltaTime) {
+    // 間引き中のエミッターは時間を溜めるだけ
+    auto stepAll = [this](float stepDeltaTime) {
+        for (size_t i = 0; i < emitters_.size(); ++i) {
+            if (schedules_[i].isReduced) {
+                schedules_[i].pendingTime += stepDeltaTime;
+            } else {
+                emitters_[i]->Step(stepDeltaTime);
+            }
+        }
+        for (ParticleEffectPool *pool : pools_) {
+            pool->Step(stepDeltaTime);
+        }
+    };
+
+    if (!isFixedStep_) {
+        stepAll(deltaTime);
+        return 1.0f;
+    }
+
+    accumulator_ += deltaTime;
+    uint32_t subSteps = 0;
+    while (accumulator_ >= fixedDeltaTime_) {
+        // 処理落ちで追いつけない場合は余りを捨てる
+        if (subSteps >= kMaxSubSteps) {
+            accumulator_ = 0.0f;
+            break;
+        }
+        stepAll(fixedDeltaTime_);
+        accumulator_ -= fixedDeltaTime_;
+        ++subSteps;
+    }
+    return accumulator_ / fixedDeltaTime_;
+}
+
+void ParticleEmitterManager::UpdateSchedule(const ViewProjection &viewProjection) {
+    Matrix4x4 cameraMatrix = Inverse(viewProjection.matView_);
+    Vector3 cameraPosition = {cameraMatrix.m[3][0], cameraMatrix.m[3][1], cameraMatrix.m[3][2]};
+
+    for (size_t i = 0; i < emitters_.size(); ++i) {
+        Schedule &schedule = schedules_[i];
+        schedule.isSimulated = false;
+
+        bool isReduced = false;
+        if (isReducedRateEnabled_) {
+            Vector3 center;
+            float radius = 0.0f;
+            emitters_[i]->GetBoundingSphere(center, radius);
+            // 見えているものは遠くても毎フレーム進める(止まって見えるため)
+            float distance = (center - cameraPosition).Length() - radius;
+            isReduced = distance > reducedRateDistance_ && !IsSphereVisible(center, radius, viewProjection);
+        }
+
+        // 視野に戻ったら溜まった分を追いつかせる
+        if (schedule.isReduced && !isReduced) {
+            Flush(i);
+        }
+        schedule.isReduced = isReduced;
+    }
+}
+
+void ParticleEmitterManager::UpdateReducedEmitters() {
+    // 間引き中のエミッターを interval フレームに分散して進める
+    uint32_t slice = frameCount_ % reducedRateInterval_;
+    for (size_t i = 0; i < emitters_.size(); ++i) {
+        if (schedules_[i].isReduced && i % reducedRateInterval_ == slice) {
+            Flush(i);
+        }
+    }
+    ++frameCount_;
+}
+
+void ParticleEmitterManager::Flush(size_t index) {
+    Schedule &schedule = schedules_[index];
+    while (schedule.pendingTime > 0.0f) {
+        float deltaTime = std::min(schedule.pendingTime, kMaxFlushDeltaTime);
+        emitters_[index]->Step(deltaTime);
+        schedule.pendingTime -= deltaTime;
+    }
+    schedule.pendingTime = 0.0f;
+    schedule.isSimulated = true;
+}
+
+bool ParticleEmitterManager::IsSphereVisible(const Vector3 &center, float radius, const ViewProjection &viewProjection) {
+    Vector3 viewPosition = Transformation(center, viewProjection.matView_);
+
+    // 手前・奥
+    if (viewPosition.z + radius < viewProjection.nearZ || viewPosition.z - radius > viewProjection.farZ) {
+        return false;
+    }
+    // 上下・左右の面との距離
+    float halfY = viewProjection.fovAngleY * 0.5f;
+    float halfX = std::atan(std::tan(halfY) * viewProjection.aspectRatio);
+    if (std::abs(viewPosition.y) * std::cos(halfY) - viewPosition.z * std::sin(halfY) > radius) {
+        return false;
+    }
+    if (std::abs(viewPosition.x) * std::cos(halfX) - viewPosition.z * std::sin(halfX) > radius) {
+        return false;
+    }
+    return true;
+}
+
+void ParticleEmitterManager::Register(ParticleEmitter *emitter) {
+    if (std::find(emitters_.begin(), emitters_.end(), emitter) == emitters_.end()) {
+        emitters_.push_back(emitter);
+        schedules_.push_back(Schedule{});
+    }
+}
+
+void ParticleEmitterManager::DrawPools() {
+    for (ParticleEffectPool *pool : pools_) {
+        pool->Draw();
+    }
+}
+
+void ParticleEmitterManager::RegisterPool(ParticleEffectPool *pool) {
+    if (std::find(pools_.begin(), pools_.end(), pool) == pools_.end()) {
+        pools_.push_back(pool);
+    }
+}
+
+void ParticleEmitterManager::UnregisterPool(ParticleEffectPool *pool) {
+    auto it = std::find(pools_.begin(), pools_.end(), pool);
+    if (it != pools_.end()) {
+        pools_.erase(it);
+    }
+}
+
+ParticleEmitter *ParticleEmitterManager::FindEmitter(const std::string &name) {
+    for (ParticleEmitter *emitter : emitters_) {
+        if (emitter->GetName() == name) {
+            return emitter;
+        }
+    }
+    return nullptr;
+}
+
+void ParticleEmitterManager::SetFixedStep(bool isFixedStep, float fixedDeltaTime) {
+    isFixedStep_ = isFixedStep;
+    fixedDeltaTime_ = std::max(fixedDeltaTime, 1.0f / 1000.0f);
+    accumulator_ = 0.0f;
+}
+
+void ParticleEmitterManager::Unregister(ParticleEmitter *emitter) {
+    auto it = std::find(emitters_.begin(), emitters_.end(), emitter);
+    if (it != emitters_.end()) {
+        schedules_.erase(schedules_.begin() + (it - emitters_.begin()));
+        emitters_.erase(it);
+    }
+}
+
+void ParticleEmitterManager::ResetAccumulator() {
+    accumulator_ = 0.0f;
+    // 間引きの振り分けも記録開始時からそろえる
+    frameCount_ = 0;
+    // 全エミッターを通常更新に戻す
+    for (Schedule &schedule : schedules_) {
+        schedule = Schedule{};
+    }
+}
+
+void ParticleEmitterManager::SetReducedRate(bool isEnable, float distance, uint32_t interval) {
+    isReducedRateEnabled_ = isEnable;
+    reducedRateDistance_ = distance;
+    reducedRateInterval_ = std::max(1u, interval);
+}
+
+uint32_t ParticleEmitterManager::GetReducedEmitterCount() const {
+    return static_cast<uint32_t>(std::count_if(schedules_.begin(), schedules_.end(), [](const Schedule &schedule) { return schedule.isReduced; }));
+}
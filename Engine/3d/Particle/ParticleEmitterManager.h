@@ -0,0 +1,107 @@
+#pragma once
+#include "ParticleRecorder.h"
+#include "ViewProjection/ViewProjection.h"
+#include <string>
+#include <vector>
+
+class ParticleEmitter;
+class ParticleEffectPool;
+
+/// <summary>
+/// エミッターのシミュレーションを更新フェーズでまとめて進める
+/// </summary>
+class ParticleEmitterManager {
+  private:
+    static ParticleEmitterManager *instance;
+    ParticleEmitterManager() = default;
+    ~ParticleEmitterManager() = default;
+    ParticleEmitterManager(ParticleEmitterManager &) = delete;
+    ParticleEmitterManager &operator=(ParticleEmitterManager &) = delete;
+
+  public:
+    /// <summary>
+    /// シングルトンインスタンスの取得
+    /// </summary>
+    static ParticleEmitterManager *GetInstance();
+
+    /// <summary>
+    /// 終了
+    /// </summary>
+    void Finalize();
+
+    /// <summary>
+    /// 登録済みエミッターの発生とシミュレーションを進める(描画前に1回)
+    /// </summary>
+    void Update(const ViewProjection &viewProjection);
+
+    /// <summary>
+    /// 間引きの判定とシミュレーションを進める(インスタンスの書き込みはしない。記録の再生もこの経路を通す)
+    /// </summary>
+    /// <returns>描画補間率</returns>
+    float Simulate(float deltaTime, const ViewProjection &viewProjection);
+
+    /// <summary>
+    /// シミュレーションだけを進める(固定ステップ時はサブステップ分割)
+    /// </summary>
+    /// <returns>描画補間率</returns>
+    float Step(float deltaTime);
+
+    void Register(ParticleEmitter *emitter);
+    void Unregister(ParticleEmitter *emitter);
+    ParticleEmitter *FindEmitter(const std::string &name);
+    const std::vector<ParticleEmitter *> &GetEmitters() const { return emitters_; }
+
+    // エフェクトプール(間引きせず毎ステップ進める)
+    void RegisterPool(ParticleEffectPool *pool);
+    void UnregisterPool(ParticleEffectPool *pool);
+    const std::vector<ParticleEffectPool *> &GetPools() const { return pools_; }
+    // 登録中の全プールの描画(シーンのパーティクル描画の中で呼ぶ)
+    void DrawPools();
+
+    // 固定ステップ設定
+    void SetFixedStep(bool isFixedStep, float fixedDeltaTime = 1.0f / 60.0f);
+    bool IsFixedStep() const { return isFixedStep_; }
+    float GetFixedDeltaTime() const { return fixedDeltaTime_; }
+    void ResetAccumulator();
+
+    ParticleRecorder &GetRecorder() { return recorder_; }
+
+    // 視野外エミッターの間引き更新設定(distanceより近いものは視野外でも毎フレーム進める)
+    void SetReducedRate(bool isEnable, float distance, uint32_t interval);
+    bool IsReducedRateEnabled() const { return isReducedRateEnabled_; }
+    float GetReducedRateDistance() const { return reducedRateDistance_; }
+    uint32_t GetReducedRateInterval() const { return reducedRateInterval_; }
+    uint32_t GetReducedEmitterCount() const;
+
+  private:
+    // エミッターごとの更新スケジュール
+    struct Schedule {
+        bool isReduced = false;       // 間引き更新中か
+        bool isSimulated = false;     // このフレームに進めたか
+        float pendingTime = 0.0f;     // 間引き中に溜まった時間
+    };
+
+    void UpdateSchedule(const ViewProjection &viewProjection);
+    void UpdateReducedEmitters();
+    void Flush(size_t index);
+    static bool IsSphereVisible(const Vector3 &center, float radius, const ViewProjection &viewProjection);
+
+  private:
+    static const uint32_t kMaxSubSteps = 8; // 1フレームの最大サブステップ数
+    static constexpr float kMaxFlushDeltaTime = 1.0f / 15.0f; // 溜まった時間を進めるときの最大ステップ
+
+    std::vector<ParticleEmitter *> emitters_;
+    std::vector<Schedule> schedules_; // emitters_と同じ並び
+    std::vector<ParticleEffectPool *> pools_;
+
+    bool isReducedRateEnabled_ = false;
+    float reducedRateDistance_ = 10.0f;
+    uint32_t reducedRateInterval_ = 4;
+    uint32_t frameCount_ = 0;
+
+    bool isFixedStep_ = false;
+    float fixedDeltaTime_ = 1.0f / 60.0f;
+    float accumulator_ = 0.0f;
+
+    ParticleRecorder recorder_;
+};
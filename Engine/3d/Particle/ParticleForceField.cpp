@@ -0,0 +1,287 @@
+#define NOMINMAX
+#include "ParticleForceField.h"
+#include "Data/DataHandler.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <xmmintrin.h>
+#ifdef _DEBUG
+#include "imgui.h"
+#endif
+
+ParticleForceFieldManager *ParticleForceFieldManager::instance = nullptr;
+
+namespace {
+// 焼き込み用の3Dグラディエントノイズ(Perlin)
+class GradientNoise {
+  public:
+    explicit GradientNoise(uint32_t seed) {
+        std::iota(permutation_.begin(), permutation_.begin() + 256, 0);
+        std::mt19937 randomEngine(seed);
+        std::shuffle(permutation_.begin(), permutation_.begin() + 256, randomEngine);
+        std::copy(permutation_.begin(), permutation_.begin() + 256, permutation_.begin() + 256);
+    }
+
+    float Noise(float x, float y, float z) const {
+        int xi = static_cast<int>(std::floor(x)) & 255;
+        int yi = static_cast<int>(std::floor(y)) & 255;
+        int zi = static_cast<int>(std::floor(z)) & 255;
+        x -= std::floor(x);
+        y -= std::floor(y);
+        z -= std::floor(z);
+        float u = Fade(x);
+        float v = Fade(y);
+        float w = Fade(z);
+
+        const auto &p = permutation_;
+        int a = p[xi] + yi;
+        int aa = p[a] + zi;
+        int ab = p[a + 1] + zi;
+        int b = p[xi + 1] + yi;
+        int ba = p[b] + zi;
+        int bb = p[b + 1] + zi;
+
+        return Lerp(w,
+                    Lerp(v, Lerp(u, Grad(p[aa], x, y, z), Grad(p[ba], x - 1, y, z)),
+                         Lerp(u, Grad(p[ab], x, y - 1, z), Grad(p[bb], x - 1, y - 1, z))),
+                    Lerp(v, Lerp(u, Grad(p[aa + 1], x, y, z - 1), Grad(p[ba + 1], x - 1, y, z - 1)),
+                         Lerp(u, Grad(p[ab + 1], x, y - 1, z - 1), Grad(p[bb + 1], x - 1, y - 1, z - 1))));
+    }
+
+  private:
+    static float Fade(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+    static float Lerp(float t, float a, float b) { return a + t * (b - a); }
+    static float Grad(int hash, float x, float y, float z) {
+        int h = hash & 15;
+        float u = h < 8 ? x : y;
+        float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+        return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    }
+
+    std::array<int, 512> permutation_;
+};
+} // namespace
+
+void ParticleForceField::Initialize(const std::string &name) {
+    name_ = name;
+    transform_.Initialize();
+
+    json data = DataHandler("ForceField", name_).LoadAll();
+    transform_.translation_ = data.value("translation", Vector3{0.0f, 0.0f, 0.0f});
+    transform_.rotation_ = data.value("rotation", Vector3{0.0f, 0.0f, 0.0f});
+    transform_.scale_ = data.value("scale", Vector3{10.0f, 10.0f, 10.0f});
+    strength_ = data.value("strength", 1.0f);
+    frequency_ = data.value("frequency", 2.0f);
+    seed_ = data.value("seed", 0u);
+    uint32_t resolution = data.value("resolution", 16u);
+
+    source_ = static_cast<Source>(data.value("source", static_cast<int32_t>(Source::CurlNoise)));
+    if (source_ == Source::Authored && data.contains("vectors")) {
+        BakeAuthored(resolution, data["vectors"].get<std::vector<Vector3>>());
+    } else {
+        source_ = Source::CurlNoise;
+        BakeCurlNoise(resolution, frequency_, seed_);
+    }
+    UpdateMatrix();
+}
+
+void ParticleForceField::BakeCurlNoise(uint32_t resolution, float frequency, uint32_t seed) {
+    source_ = Source::CurlNoise;
+    resolution_ = std::clamp(resolution, kMinResolution, kMaxResolution);
+    frequency_ = frequency;
+    seed_ = seed;
+
+    // ベクトルポテンシャルを格子点で求める(成分ごとにずらした同じノイズ)
+    GradientNoise noise(seed);
+    const Vector3 offsets[3] = {{0.0f, 0.0f, 0.0f}, {31.4f, 47.2f, 12.9f}, {73.1f, 5.3f, 91.7f}};
+    size_t cellCount = static_cast<size_t>(resolution_) * resolution_ * resolution_;
+    std::vector<Vector3> potential(cellCount);
+    float step = frequency_ / static_cast<float>(resolution_ - 1);
+    for (uint32_t z = 0; z < resolution_; ++z) {
+        for (uint32_t y = 0; y < resolution_; ++y) {
+            for (uint32_t x = 0; x < resolution_; ++x) {
+                Vector3 p = {x * step, y * step, z * step};
+                potential[CellIndex(x, y, z)] = {
+                    noise.Noise(p.x + offsets[0].x, p.y + offsets[0].y, p.z + offsets[0].z),
+                    noise.Noise(p.x + offsets[1].x, p.y + offsets[1].y, p.z + offsets[1].z),
+                    noise.Noise(p.x + offsets[2].x, p.y + offsets[2].y, p.z + offsets[2].z)};
+            }
+        }
+    }
+
+    // 回転(curl)を差分で取る。端は片側差分
+    auto derivative = [&](uint32_t x, uint32_t y, uint32_t z, int axis) {
+        uint32_t coord[3] = {x, y, z};
+        uint32_t low[3] = {x, y, z};
+        uint32_t high[3] = {x, y, z};
+        low[axis] = coord[axis] > 0 ? coord[axis] - 1 : coord[axis];
+        high[axis] = coord[axis] + 1 < resolution_ ? coord[axis] + 1 : coord[axis];
+        float distance = static_cast<float>(high[axis] - low[axis]);
+        return (potential[CellIndex(high[0], high[1], high[2])] - potential[CellIndex(low[0], low[1], low[2])]) / distance;
+    };
+
+    cells_.assign(cellCount, Cell{0.0f, 0.0f, 0.0f, 0.0f});
+    float maxLength = 0.0f;
+    for (uint32_t z = 0; z < resolution_; ++z) {
+        for (uint32_t y = 0; y < resolution_; ++y) {
+            for (uint32_t x = 0; x < resolution_; ++x) {
+                Vector3 dx = derivative(x, y, z, 0);
+                Vector3 dy = derivative(x, y, z, 1);
+                Vector3 dz = derivative(x, y, z, 2);
+                Vector3 curl = {dy.z - dz.y, dz.x - dx.z, dx.y - dy.x};
+                cells_[CellIndex(x, y, z)] = {curl.x, curl.y, curl.z, 0.0f};
+                maxLength = std::max(maxLength, curl.Length());
+            }
+        }
+    }
+    // 最大の長さが1になるよう正規化(強さはstrength_で調整)
+    if (maxLength > 0.0f) {
+        for (Cell &cell : cells_) {
+            cell.x /= maxLength;
+            cell.y /= maxLength;
+            cell.z /= maxLength;
+        }
+    }
+}
+
+void ParticleForceField::BakeAuthored(uint32_t resolution, const std::vector<Vector3> &vectors) {
+    source_ = Source::Authored;
+    resolution_ = std::clamp(resolution, kMinResolution, kMaxResolution);
+    authoredVectors_ = vectors;
+    size_t cellCount = static_cast<size_t>(resolution_) * resolution_ * resolution_;
+    authoredVectors_.resize(cellCount, Vector3{0.0f, 0.0f, 0.0f});
+    cells_.resize(cellCount);
+    for (size_t i = 0; i < cellCount; ++i) {
+        cells_[i] = {authoredVectors_[i].x, authoredVectors_[i].y, authoredVectors_[i].z, 0.0f};
+    }
+}
+
+void ParticleForceField::UpdateMatrix() {
+    transform_.UpdateMatrix();
+    worldToLocal_ = Inverse(transform_.matWorld_);
+    // 向きだけを取り出す(各軸を正規化)
+    localToWorldRotation_ = MakeIdentity4x4();
+    for (int row = 0; row < 3; ++row) {
+        Vector3 axis = {transform_.matWorld_.m[row][0], transform_.matWorld_.m[row][1], transform_.matWorld_.m[row][2]};
+        if (axis.LengthSq() > 0.0f) {
+            axis = axis.Normalize();
+        }
+        localToWorldRotation_.m[row][0] = axis.x;
+        localToWorldRotation_.m[row][1] = axis.y;
+        localToWorldRotation_.m[row][2] = axis.z;
+    }
+}
+
+Vector3 ParticleForceField::Sample(const Vector3 &worldPosition) const {
+    if (cells_.empty()) {
+        return {0.0f, 0.0f, 0.0f};
+    }
+    Vector3 local = Transformation(worldPosition, worldToLocal_);
+    if (std::abs(local.x) > 1.0f || std::abs(local.y) > 1.0f || std::abs(local.z) > 1.0f) {
+        return {0.0f, 0.0f, 0.0f};
+    }
+
+    // [-1,1] → 格子座標
+    float scale = static_cast<float>(resolution_ - 1) * 0.5f;
+    float gridX = (local.x + 1.0f) * scale;
+    float gridY = (local.y + 1.0f) * scale;
+    float gridZ = (local.z + 1.0f) * scale;
+    uint32_t x = std::min(static_cast<uint32_t>(gridX), resolution_ - 2);
+    uint32_t y = std::min(static_cast<uint32_t>(gridY), resolution_ - 2);
+    uint32_t z = std::min(static_cast<uint32_t>(gridZ), resolution_ - 2);
+    __m128 fractionX = _mm_set1_ps(gridX - static_cast<float>(x));
+    __m128 fractionY = _mm_set1_ps(gridY - static_cast<float>(y));
+    __m128 fractionZ = _mm_set1_ps(gridZ - static_cast<float>(z));
+
+    // 8隅を1セル(4成分)ずつまとめて補間する
+    auto load = [this](uint32_t cx, uint32_t cy, uint32_t cz) {
+        return _mm_load_ps(&cells_[CellIndex(cx, cy, cz)].x);
+    };
+    auto lerp = [](__m128 a, __m128 b, __m128 t) {
+        return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+    };
+    __m128 c00 = lerp(load(x, y, z), load(x + 1, y, z), fractionX);
+    __m128 c10 = lerp(load(x, y + 1, z), load(x + 1, y + 1, z), fractionX);
+    __m128 c01 = lerp(load(x, y, z + 1), load(x + 1, y, z + 1), fractionX);
+    __m128 c11 = lerp(load(x, y + 1, z + 1), load(x + 1, y + 1, z + 1), fractionX);
+    __m128 c0 = lerp(c00, c10, fractionY);
+    __m128 c1 = lerp(c01, c11, fractionY);
+    __m128 result = _mm_mul_ps(lerp(c0, c1, fractionZ), _mm_set1_ps(strength_));
+
+    alignas(16) float value[4];
+    _mm_store_ps(value, result);
+    return TransformNormal(Vector3{value[0], value[1], value[2]}, localToWorldRotation_);
+}
+
+void ParticleForceField::SaveToJson() const {
+    DataHandler data("ForceField", name_);
+    data.Save("translation", transform_.translation_);
+    data.Save("rotation", transform_.rotation_);
+    data.Save("scale", transform_.scale_);
+    data.Save("strength", strength_);
+    data.Save("frequency", frequency_);
+    data.Save("seed", static_cast<int>(seed_));
+    data.Save("resolution", static_cast<int>(resolution_));
+    data.Save("source", static_cast<int>(source_));
+    if (source_ == Source::Authored) {
+        data.Save("vectors", authoredVectors_);
+    }
+}
+
+void ParticleForceField::Debug() {
+#ifdef _DEBUG
+    bool isMoved = ImGui::DragFloat3("位置", &transform_.translation_.x, 0.1f);
+    isMoved |= ImGui::SliderAngle("回転X", &transform_.rotation_.x);
+    isMoved |= ImGui::SliderAngle("回転Y", &transform_.rotation_.y);
+    isMoved |= ImGui::SliderAngle("回転Z", &transform_.rotation_.z);
+    isMoved |= ImGui::DragFloat3("範囲(半分の大きさ)", &transform_.scale_.x, 0.1f, 0.01f, 1000.0f);
+    if (isMoved) {
+        UpdateMatrix();
+    }
+    ImGui::DragFloat("強さ", &strength_, 0.01f);
+
+    if (source_ == Source::CurlNoise) {
+        int resolution = static_cast<int>(resolution_);
+        int seed = static_cast<int>(seed_);
+        bool isChanged = ImGui::SliderInt("解像度", &resolution, kMinResolution, kMaxResolution);
+        isChanged |= ImGui::DragFloat("周波数", &frequency_, 0.01f, 0.01f, 32.0f);
+        isChanged |= ImGui::InputInt("シード", &seed);
+        if (isChanged) {
+            BakeCurlNoise(static_cast<uint32_t>(resolution), frequency_, static_cast<uint32_t>(std::max(seed, 0)));
+        }
+    } else {
+        ImGui::Text("解像度: %u (手付けデータ)", resolution_);
+    }
+    if (ImGui::Button("セーブ")) {
+        SaveToJson();
+    }
+#endif
+}
+
+ParticleForceFieldManager *ParticleForceFieldManager::GetInstance() {
+    if (instance == nullptr) {
+        instance = new ParticleForceFieldManager();
+    }
+    return instance;
+}
+
+void ParticleForceFieldManager::Finalize() {
+    delete instance;
+    instance = nullptr;
+}
+
+ParticleForceField *ParticleForceFieldManager::Load(const std::string &name) {
+    if (ParticleForceField *field = Find(name)) {
+        return field;
+    }
+    auto field = std::make_unique<ParticleForceField>();
+    field->Initialize(name);
+    return fields_.emplace(name, std::move(field)).first->second.get();
+}
+
+ParticleForceField *ParticleForceFieldManager::Find(const std::string &name) {
+    auto it = fields_.find(name);
+    return it != fields_.end() ? it->second.get() : nullptr;
+}
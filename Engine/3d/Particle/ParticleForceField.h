@@ -0,0 +1,127 @@
+#pragma once
+#include "WorldTransform.h"
+#include "type/Matrix4x4.h"
+#include "type/Vector3.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// パーティクルに加える力の3Dグリッド(ベクトル場)
+/// ロード時にカールノイズなどから焼き込み、更新時はトライリニア補間で引くだけにする
+/// グリッドはWorldTransformで配置するローカルの[-1,1]の立方体を覆う
+/// </summary>
+class ParticleForceField {
+  public:
+    // 焼き込みの元データ
+    enum class Source : int32_t {
+        CurlNoise, // カールノイズ(発散0の渦)
+        Authored,  // JSONに書いたベクトル
+    };
+
+    static constexpr uint32_t kMinResolution = 2;
+    static constexpr uint32_t kMaxResolution = 64;
+
+  public:
+    /// <summary>
+    /// JSON(resources/jsons/ForceField)から読み込んで焼き込む
+    /// </summary>
+    void Initialize(const std::string &name);
+
+    /// <summary>
+    /// カールノイズで焼き込む
+    /// </summary>
+    void BakeCurlNoise(uint32_t resolution, float frequency, uint32_t seed);
+
+    /// <summary>
+    /// 用意したベクトルをそのまま使う(resolution^3個、x→y→zの順)
+    /// </summary>
+    void BakeAuthored(uint32_t resolution, const std::vector<Vector3> &vectors);
+
+    /// <summary>
+    /// 配置の反映(transformを書き換えたら呼ぶ)
+    /// </summary>
+    void UpdateMatrix();
+
+    /// <summary>
+    /// ワールド座標での力(範囲外は0)
+    /// </summary>
+    Vector3 Sample(const Vector3 &worldPosition) const;
+
+    /// <summary>
+    /// 設定の保存(焼き込み結果ではなく元データを保存する)
+    /// </summary>
+    void SaveToJson() const;
+
+    void Debug();
+
+    const std::string &GetName() const { return name_; }
+    uint32_t GetResolution() const { return resolution_; }
+    WorldTransform &GetTransform() { return transform_; }
+    void SetStrength(float strength) { strength_ = strength; }
+    float GetStrength() const { return strength_; }
+
+  private:
+    // SSEでまとめて読めるよう16バイトに揃える
+    struct alignas(16) Cell {
+        float x, y, z, w;
+    };
+
+    size_t CellIndex(uint32_t x, uint32_t y, uint32_t z) const {
+        return (static_cast<size_t>(z) * resolution_ + y) * resolution_ + x;
+    }
+
+  private:
+    std::string name_;
+    WorldTransform transform_;
+    Matrix4x4 worldToLocal_;
+    Matrix4x4 localToWorldRotation_;
+
+    Source source_ = Source::CurlNoise;
+    uint32_t resolution_ = 0;
+    float frequency_ = 2.0f;
+    uint32_t seed_ = 0;
+    float strength_ = 1.0f;
+    std::vector<Vector3> authoredVectors_;
+    std::vector<Cell> cells_;
+};
+
+/// <summary>
+/// 力場の共有(名前ごとに1つ焼き込み、複数のエミッターから参照する)
+/// </summary>
+class ParticleForceFieldManager {
+  private:
+    static ParticleForceFieldManager *instance;
+    ParticleForceFieldManager() = default;
+    ~ParticleForceFieldManager() = default;
+    ParticleForceFieldManager(ParticleForceFieldManager &) = delete;
+    ParticleForceFieldManager &operator=(ParticleForceFieldManager &) = delete;
+
+  public:
+    /// <summary>
+    /// シングルトンインスタンスの取得
+    /// </summary>
+    static ParticleForceFieldManager *GetInstance();
+
+    /// <summary>
+    /// 終了
+    /// </summary>
+    void Finalize();
+
+    /// <summary>
+    /// 取得(未読み込みならここで読み込んで焼き込む)
+    /// </summary>
+    ParticleForceField *Load(const std::string &name);
+
+    /// <summary>
+    /// 読み込み済みのものだけ取得
+    /// </summary>
+    ParticleForceField *Find(const std::string &name);
+
+    const std::unordered_map<std::string, std::unique_ptr<ParticleForceField>> &GetFields() const { return fields_; }
+
+  private:
+    std::unordered_map<std::string, std::unique_ptr<ParticleForceField>> fields_;
+};
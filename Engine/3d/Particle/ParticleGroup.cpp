@@ -1,11 +1,18 @@
 #include "ParticleGroup.h"
+#include "Log/Logger.h"
 #include "Model/ModelManager.h"
-#include "Srv/SrvManager.h"
+#include "ParticleInstancePool.h"
 #include "fstream"
 #include <Texture/TextureManager.h>
 
+using namespace Logger;
+
 std::unordered_map<std::string, ModelData> ParticleGroup::modelCache;
 
+ParticleGroup::~ParticleGroup() {
+    instancePages_.ReleaseAll(ParticleInstancePool::GetInstance()->GetAllocator(isHeadless_));
+}
+
 void ParticleGroup::Initialize() {
 }
 
@@ -14,6 +21,7 @@ void ParticleGroup::Update() {
 ParticleGroupData ParticleGroup::CreateParticleGroup(const std::string &groupName, const std::string &filename, const std::string &texturePath) {
     particleGroupData_.groupName = groupName;
     modelFilePath_ = filename;
+    texturePath_ = texturePath;
     ModelManager::GetInstance()->LoadModel(filename);
     model_ = ModelManager::GetInstance()->FindModel(filename);
     modelData = model_->GetModelData();
@@ -38,12 +46,7 @@ ParticleGroupData ParticleGroup::CreateParticleGroup(const std::string &groupNam
         TextureManager::GetInstance()->LoadTexture(mat.textureFilePath);
         mat.textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(mat.textureFilePath);
     }
-    particleGroupData_.instancingResource = ParticleCommon::GetInstance()->GetDxCommon()->CreateBufferResource(sizeof(ParticleForGPU) * kNumMaxInstance);
-    particleGroupData_.instancingSRVIndex = SrvManager::GetInstance()->Allocate() + 1;
-    particleGroupData_.instancingResource->Map(0, nullptr, reinterpret_cast<void **>(&particleGroupData_.instancingData));
-
-    SrvManager::GetInstance()->CreateSRVforStructuredBuffer(particleGroupData_.instancingSRVIndex, particleGroupData_.instancingResource.Get(), kNumMaxInstance, sizeof(ParticleForGPU));
-
+    // インスタンスデータのページは書き込み時に共有プールから借りる
     CreateMaterial();
     particleGroupData_.instanceCount = 0;
     return particleGroupData_;
@@ -52,6 +55,7 @@ ParticleGroupData ParticleGroup::CreateParticleGroup(const std::string &groupNam
 ParticleGroupData ParticleGroup::CreatePrimitiveParticleGroup(const std::string &groupName, PrimitiveType type, const std::string &texturePath) {
     particleGroupData_.groupName = groupName;
     type_ = type;
+    texturePath_ = texturePath;
     model_ = ModelManager::GetInstance()->FindModel(ModelManager::GetInstance()->CreatePrimitiveModel(type));
     TextureManager::GetInstance()->LoadTexture(texturePath);
     modelData = model_->GetModelData();
@@ -76,17 +80,64 @@ ParticleGroupData ParticleGroup::CreatePrimitiveParticleGroup(const std::string
         TextureManager::GetInstance()->LoadTexture(mat.textureFilePath);
         mat.textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(mat.textureFilePath);
     }
-    particleGroupData_.instancingResource = ParticleCommon::GetInstance()->GetDxCommon()->CreateBufferResource(sizeof(ParticleForGPU) * kNumMaxInstance);
-    particleGroupData_.instancingSRVIndex = SrvManager::GetInstance()->Allocate() + 1;
-    particleGroupData_.instancingResource->Map(0, nullptr, reinterpret_cast<void **>(&particleGroupData_.instancingData));
-
-    SrvManager::GetInstance()->CreateSRVforStructuredBuffer(particleGroupData_.instancingSRVIndex, particleGroupData_.instancingResource.Get(), kNumMaxInstance, sizeof(ParticleForGPU));
-
+    // インスタンスデータのページは書き込み時に共有プールから借りる
     CreateMaterial();
     particleGroupData_.instanceCount = 0;
     return particleGroupData_;
 }
 
+ParticleGroupData ParticleGroup::CreateHeadlessParticleGroup(const std::string &groupName) {
+    particleGroupData_.groupName = groupName;
+    isHeadless_ = true;
+    type_ = PrimitiveType::None;
+    model_ = nullptr;
+    particleGroupData_.materials.clear();
+    particleGroupData_.materials.push_back(MaterialData{});
+    particleGroupData_.instanceCount = 0;
+    return particleGroupData_;
+}
+
+std::unique_ptr<ParticleGroup> ParticleGroup::Duplicate() const {
+    auto group = std::make_unique<ParticleGroup>();
+    if (isHeadless_) {
+        group->CreateHeadlessParticleGroup(particleGroupData_.groupName);
+    } else if (!modelFilePath_.empty()) {
+        group->CreateParticleGroup(particleGroupData_.groupName, modelFilePath_, texturePath_);
+    } else {
+        group->CreatePrimitiveParticleGroup(particleGroupData_.groupName, type_, texturePath_);
+    }
+    return group;
+}
+
+uint32_t ParticleGroup::ReserveInstances(uint32_t instanceCount) {
+    if (instanceCount > kNumMaxInstance) {
+        if (!isTruncateLogged_) {
+            Log("ParticleGroup: " + particleGroupData_.groupName + " exceeds " + std::to_string(kNumMaxInstance) + " instances, truncated\n");
+            isTruncateLogged_ = true;
+        }
+        instanceCount = kNumMaxInstance;
+    }
+    ParticleInstancePool *pool = ParticleInstancePool::GetInstance();
+    instancePages_.Resize(pool->GetAllocator(isHeadless_), instanceCount);
+    pool->CreatePendingPages(isHeadless_);
+    return instanceCount;
+}
+
+ParticleForGPU *ParticleGroup::GetInstancePage(uint32_t index) {
+    return ParticleInstancePool::GetInstance()->GetPageData(isHeadless_, instancePages_.GetPages()[index]);
+}
+
+uint32_t ParticleGroup::GetInstancePageSrvIndex(uint32_t index) const {
+    return ParticleInstancePool::GetInstance()->GetPageSrvIndex(instancePages_.GetPages()[index]);
+}
+
+ParticleTrail *ParticleGroup::CreateTrail() {
+    if (!trail_) {
+        trail_ = std::make_unique<ParticleTrail>();
+        trail_->Initialize(isHeadless_);
+    }
+    return trail_.get();
+}
 
 void ParticleGroup::CreateVertexData() {
     // 複数メッシュ対応: 全メッシュの頂点を連結
@@ -1,10 +1,13 @@
 #pragma once
 #include "Model/Model.h"
 #include "Primitive/PrimitiveModel.h"
+#include <InstancePageAllocator.h>
 #include <ModelStructs.h>
 #include <ParticleCommon.h>
+#include <ParticleTrail.h>
 #include <WorldTransform.h>
 #include <list>
+#include <memory>
 class ParticleGroup {
   public:
     struct ParticleMaterial {
@@ -13,17 +16,38 @@ class ParticleGroup {
         float padding[3];
     };
   public:
+    ParticleGroup() = default;
+    ~ParticleGroup();
+    ParticleGroup(const ParticleGroup &) = delete;
+    ParticleGroup &operator=(const ParticleGroup &) = delete;
+
     void Initialize();
 
     void Update();
 
     ParticleGroupData CreateParticleGroup(const std::string &groupName, const std::string &filename, const std::string &texturePath = {});
     ParticleGroupData CreatePrimitiveParticleGroup(const std::string &groupName, PrimitiveType type, const std::string &texturePath = {});
+    // GPUリソースを作らず、インスタンスデータをCPUの配列に書き込むだけのグループ(ベンチマーク・ツール用、描画しない)
+    ParticleGroupData CreateHeadlessParticleGroup(const std::string &groupName);
+    // 同じ名前・モデル・テクスチャで、パーティクルと軌跡を別に持つグループを作る(共有したくない利用者用)
+    std::unique_ptr<ParticleGroup> Duplicate() const;
+
+    bool IsHeadless() const { return isHeadless_; }
 
     const std::string GetGroupName() { return particleGroupData_.groupName; }
 
     uint32_t GetMaxInstance() { return kNumMaxInstance; }
 
+    /// <summary>
+    /// instanceCount個を書き込めるようページを借りる(上限を超えた分は切り捨て、書き込める数を返す)
+    /// </summary>
+    uint32_t ReserveInstances(uint32_t instanceCount);
+
+    // 借りているページ(ParticleInstancePool::kInstancesPerPage個ずつ)
+    uint32_t GetInstancePageCount() const { return instancePages_.GetPageCount(); }
+    ParticleForGPU *GetInstancePage(uint32_t index);
+    uint32_t GetInstancePageSrvIndex(uint32_t index) const;
+
     ParticleGroupData &GetParticleGroupData() { return particleGroupData_; }
 
     std::string &GetTexturePath(uint32_t index) { return particleGroupData_.materials[index].textureFilePath; }
@@ -41,6 +65,10 @@ class ParticleGroup {
     Microsoft::WRL::ComPtr<ID3D12Resource> GetVertexResource() { return vertexResource; }
     Microsoft::WRL::ComPtr<ID3D12Resource> GetmaterialResource() { return materialResource; }
 
+    // 軌跡(未使用なら生成しない)
+    ParticleTrail *GetTrail() { return trail_.get(); }
+    ParticleTrail *CreateTrail();
+
   private:
     void CreateVertexData();
     void CreateMaterial();
@@ -48,7 +76,7 @@ class ParticleGroup {
 
   private:
     static std::unordered_map<std::string, ModelData> modelCache;
-    static const uint32_t kNumMaxInstance = 10000; // 最大インスタンス数の制限
+    static const uint32_t kNumMaxInstance = 2048 * 128; // 最大インスタンス数の制限(ページは必要な分だけ借りる)
 
     // バッファリソース
     Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource = nullptr;
@@ -72,4 +100,11 @@ class ParticleGroup {
     ParticleGroupData particleGroupData_;
     PrimitiveType type_;
     std::string modelFilePath_;
+    std::string texturePath_; // 作成時に指定したテクスチャ(空ならモデルのマテリアル)
+    std::unique_ptr<ParticleTrail> trail_;
+
+    // インスタンスデータのページ(ヘッドレス時はCPUのページ)
+    bool isHeadless_ = false;
+    InstancePageTable instancePages_;
+    bool isTruncateLogged_ = false;
 };
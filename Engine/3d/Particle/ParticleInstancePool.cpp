@@ -0,0 +1,36 @@
+#include "ParticleInstancePool.h"
+#include "ParticleCommon.h"
+#include "Srv/SrvManager.h"
+
+ParticleInstancePool *ParticleInstancePool::instance = nullptr;
+
+ParticleInstancePool *ParticleInstancePool::GetInstance() {
+    if (instance == nullptr) {
+        instance = new ParticleInstancePool();
+    }
+    return instance;
+}
+
+void ParticleInstancePool::Finalize() {
+    delete instance;
+    instance = nullptr;
+}
+
+void ParticleInstancePool::CreatePendingPages(bool isHeadless) {
+    if (isHeadless) {
+        while (cpuPages_.size() < cpuAllocator_.GetPageCount()) {
+            Page page;
+            page.cpu.resize(kInstancesPerPage);
+            cpuPages_.push_back(std::move(page));
+        }
+        return;
+    }
+    while (gpuPages_.size() < gpuAllocator_.GetPageCount()) {
+        Page page;
+        page.resource = ParticleCommon::GetInstance()->GetDxCommon()->CreateBufferResource(sizeof(ParticleForGPU) * kInstancesPerPage);
+        page.srvIndex = SrvManager::GetInstance()->Allocate() + 1;
+        page.resource->Map(0, nullptr, reinterpret_cast<void **>(&page.data));
+        SrvManager::GetInstance()->CreateSRVforStructuredBuffer(page.srvIndex, page.resource.Get(), kInstancesPerPage, sizeof(ParticleForGPU));
+        gpuPages_.push_back(std::move(page));
+    }
+}
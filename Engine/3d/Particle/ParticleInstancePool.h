@@ -0,0 +1,70 @@
+#pragma once
+#include "InstancePageAllocator.h"
+#include "ModelStructs.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// パーティクルのインスタンスデータのページの共有プール
+/// ページはkInstancesPerPage個分のアップロードバッファ(+SRV)で、必要になったときに作り、
+/// グループから返されたものは破棄せずに次に借りるグループへ回す
+/// ヘッドレスのグループ用にCPUの配列だけのページも別に持つ
+/// </summary>
+class ParticleInstancePool {
+  private:
+    static ParticleInstancePool *instance;
+    ParticleInstancePool() = default;
+    ~ParticleInstancePool() = default;
+    ParticleInstancePool(ParticleInstancePool &) = delete;
+    ParticleInstancePool &operator=(ParticleInstancePool &) = delete;
+
+  public:
+    static constexpr uint32_t kInstancesPerPage = 2048; // 1ページのインスタンス数(約290KB)
+
+  public:
+    /// <summary>
+    /// シングルトンインスタンスの取得
+    /// </summary>
+    static ParticleInstancePool *GetInstance();
+
+    /// <summary>
+    /// 終了(ページを借りているグループを先に破棄しておくこと)
+    /// </summary>
+    void Finalize();
+
+    /// <summary>
+    /// ページ番号の管理
+    /// </summary>
+    InstancePageAllocator &GetAllocator(bool isHeadless) { return isHeadless ? cpuAllocator_ : gpuAllocator_; }
+
+    /// <summary>
+    /// 払い出された番号のうち、まだ実体の無いページを作る
+    /// </summary>
+    void CreatePendingPages(bool isHeadless);
+
+    /// <summary>
+    /// ページの書き込み先
+    /// </summary>
+    ParticleForGPU *GetPageData(bool isHeadless, uint32_t page) { return isHeadless ? cpuPages_[page].cpu.data() : gpuPages_[page].data; }
+
+    /// <summary>
+    /// ページのSRV(GPUのページのみ)
+    /// </summary>
+    uint32_t GetPageSrvIndex(uint32_t page) const { return gpuPages_[page].srvIndex; }
+
+    // 作成済みのGPUページの総バイト数
+    size_t GetGpuBytes() const { return gpuPages_.size() * sizeof(ParticleForGPU) * kInstancesPerPage; }
+
+  private:
+    struct Page {
+        Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+        ParticleForGPU *data = nullptr;
+        uint32_t srvIndex = 0;
+        std::vector<ParticleForGPU> cpu; // ヘッドレスのページのみ
+    };
+
+    InstancePageAllocator gpuAllocator_{kInstancesPerPage};
+    InstancePageAllocator cpuAllocator_{kInstancesPerPage};
+    std::vector<Page> gpuPages_;
+    std::vector<Page> cpuPages_;
+};
@@ -1,9 +1,46 @@
 #include "ParticleManager.h"
+#include "MeshSurfaceSampler.h"
+#include "ParticleForceField.h"
+#include "ParticleInstancePool.h"
 #include "Engine/Frame/Frame.h"
 #include "Texture/TextureManager.h"
+#include <cmath>
 #include <fstream>
 #include <random>
 
+namespace {
+// 加速度・回転速度の設定値は60fpsの1フレームあたりの量(ステップの長さで換算する)
+constexpr float kReferenceFrameRate = 60.0f;
+
+// 1フレームあたりの倍率をframes分に換算する(負の倍率は指数で換算できないのでそのまま)
+float ScaleFactor(float factor, float frames) {
+    return factor > 0.0f ? std::pow(factor, frames) : factor;
+}
+
+// isSinMoveの波(寿命中に9周)。1周分を焼き込んだLUTを周期で折り返して引く
+constexpr uint32_t kSinWaveLutSize = 64;
+constexpr float kSinWaveCycles = 9.0f;
+
+struct SinWaveLut {
+    float values[kSinWaveLutSize + 1]; // 末尾は先頭と同じ値(補間で折り返さずに済む)
+    SinWaveLut() {
+        for (uint32_t i = 0; i <= kSinWaveLutSize; ++i) {
+            float phase = static_cast<float>(i) / static_cast<float>(kSinWaveLutSize);
+            values[i] = 0.5f * (std::sin(phase * DirectX::XM_PI * 2.0f) + 1.0f);
+        }
+    }
+};
+
+float SampleSinWave(float t) {
+    static const SinWaveLut lut;
+    float cycle = t * kSinWaveCycles;
+    float position = (cycle - std::floor(cycle)) * static_cast<float>(kSinWaveLutSize);
+    uint32_t index = std::min(static_cast<uint32_t>(position), kSinWaveLutSize - 1);
+    float fraction = position - static_cast<float>(index);
+    return lut.values[index] + (lut.values[index + 1] - lut.values[index]) * fraction;
+}
+} // namespace
+
 void ParticleManager::Initialize(SrvManager *srvManager) {
     particleCommon = ParticleCommon::GetInstance();
     srvManager_ = srvManager;
@@ -11,67 +48,133 @@ void ParticleManager::Initialize(SrvManager *srvManager) {
 }
 
 void ParticleManager::Update(const ViewProjection &viewProjection) {
-    Matrix4x4 viewProjectionMatrix = viewProjection.matView_ * viewProjection.matProjection_;
-    Matrix4x4 billboardMatrix = viewProjection.matView_;
-    billboardMatrix.m[3][0] = 0.0f;
-    billboardMatrix.m[3][1] = 0.0f;
-    billboardMatrix.m[3][2] = 0.0f;
-    billboardMatrix.m[3][3] = 1.0f;
-    billboardMatrix = Inverse(billboardMatrix);
+    Simulate(Frame::DeltaTime());
+    WriteInstances(viewProjection, 1.0f);
+}
 
+void ParticleManager::Simulate(float deltaTime) {
+    if (!isStaging_) {
+        hasBounds_ = false;
+    }
     for (auto &[groupName, particleGroup] : particleGroups_) {
-        uint32_t numInstance = 0;
         ParticleSetting &particleSetting = particleSettings_[groupName];
 
-        auto &particles = particleGroup->GetParticleGroupData().particles;
-        std::list<Particle> aliveParticles;
-        for (auto &particle : particles) {
+        auto &particles = GetParticles(groupName, particleGroup);
+
+        // 軌跡のプール(設定変更時のみ確保し直す、ステージング中はグループ共有のプールに触らない)
+        ParticleTrail *trail = nullptr;
+        if (!isStaging_) {
+            if (particleSetting.enableTrail) {
+                trail = particleGroup->CreateTrail();
+                if (trail->Reserve(static_cast<uint32_t>(std::max(particleSetting.maxTrailParticles, 0)))) {
+                    for (auto &particle : particles) {
+                        particle.trailSlot = ParticleTrail::kInvalidSlot;
+                    }
+                }
+            } else if (particleGroup->GetTrail()) {
+                particleGroup->GetTrail()->Clear();
+            }
+        }
+
+        // 力場はグループ単位で1回だけ引く
+        const ParticleForceField *forceField = nullptr;
+        if (auto fieldIt = forceFields_.find(groupName); fieldIt != forceFields_.end() && particleSetting.forceFieldScale != 0.0f) {
+            forceField = fieldIt->second;
+        }
+
+        // 近傍の力は移動前の位置でまとめて求めておく(並びはparticlesと同じ)
+        NeighborWork *neighborWork = nullptr;
+        if (particleSetting.neighbor.mode != NeighborMode::None && !particles.empty()) {
+            neighborWork = &neighborWorks_[groupName];
+            neighborWork->positions.clear();
+            neighborWork->velocities.clear();
+            for (const Particle &particle : particles) {
+                neighborWork->positions.push_back(particle.transform.translation_);
+                neighborWork->velocities.push_back(particle.velocity);
+            }
+            neighborWork->grid.Solve(particleSetting.neighbor, neighborWork->positions, neighborWork->velocities, neighborWork->forces);
+        } else {
+            neighborWorks_.erase(groupName);
+        }
+
+        // 1フレームあたりの設定値に掛ける、このステップのフレーム数
+        const float frames = deltaTime * kReferenceFrameRate;
+
+        // このグループのAABB(当たり判定の問い合わせに使う)
+        Vector3 groupMin;
+        Vector3 groupMax;
+        bool hasGroupBounds = false;
+
+        size_t particleIndex = 0;
+        for (auto it = particles.begin(); it != particles.end();) {
+            Particle &particle = *it;
+            const size_t index = particleIndex++;
             if (particle.lifeTime <= particle.currentTime) {
+                if (trail) {
+                    trail->Release(particle.trailSlot);
+                }
+                it = particles.erase(it);
                 continue;
             }
+            // 補間用に前ステップの位置を保持
+            particle.prevTranslation = particle.transform.translation_;
 
-            // 軌跡パーティクル生成処理
-            if (particleSetting.enableTrail && !particle.isChild) {
-                particle.trailSpawnTimer += Frame::DeltaTime();
+            // 軌跡点の生成処理
+            if (trail) {
+                if (particle.trailSlot == ParticleTrail::kInvalidSlot) {
+                    particle.trailSlot = trail->Acquire();
+                }
+                particle.trailSpawnTimer += deltaTime;
                 if (particle.trailSpawnTimer >= particleSetting.trailSpawnInterval) {
-                    CreateTrailParticle(particle, particleSetting);
+                    CreateTrailPoint(*trail, particle, particleSetting);
                     particle.trailSpawnTimer = 0.0f;
                 }
+            } else {
+                particle.trailSlot = ParticleTrail::kInvalidSlot;
             }
 
             float t = particle.currentTime / particle.lifeTime;
             t = std::clamp(t, 0.0f, 1.0f);
 
             // --- 色補間処理を追加 ---
-            if (!particle.isChild) {
-                // 通常パーティクルのみ補間
+            float alphaRate = 1.0f - t;
+            if (particleSetting.colorCurve.isEnabled) {
+                // wはinitialAlphaに掛ける倍率
+                Vector4 curveColor = particleSetting.colorCurve.Sample(t);
+                particle.color.x = curveColor.x;
+                particle.color.y = curveColor.y;
+                particle.color.z = curveColor.z;
+                alphaRate = curveColor.w;
+            } else {
                 const Vector4 &startColor = particleSetting.startColor;
                 const Vector4 &endColor = particleSetting.endColor;
                 particle.color.x = (1.0f - t) * startColor.x + t * endColor.x;
                 particle.color.y = (1.0f - t) * startColor.y + t * endColor.y;
                 particle.color.z = (1.0f - t) * startColor.z + t * endColor.z;
-                // アルファは既存ロジック
             }
 
             if (particleSetting.isSinMove) {
-                float waveScale = 0.5f * (sin(t * DirectX::XM_PI * 18.0f) + 1.0f);
-                float maxScale = (1.0f - t);
-                particle.transform.scale_ =
-                    particle.startScale * waveScale * maxScale;
+                float waveScale = SampleSinWave(t);
+                particle.transform.scale_ = particle.startScale * (waveScale * (1.0f - t));
             } else {
-                particle.transform.scale_ =
-                    (1.0f - t) * particle.startScale + t * particle.endScale;
+                if (particleSetting.scaleCurve.isEnabled) {
+                    Vector4 curveScale = particleSetting.scaleCurve.Sample(t);
+                    particle.transform.scale_ = particle.startScale * Vector3{curveScale.x, curveScale.y, curveScale.z};
+                } else {
+                    particle.transform.scale_ =
+                        (1.0f - t) * particle.startScale + t * particle.endScale;
+                }
                 if (!(particleSetting.isGatherMode && t >= particleSetting.gatherStartRatio)) {
-                    particle.color.w = particle.initialAlpha - (particle.currentTime / particle.lifeTime);
+                    if (particleSetting.colorCurve.isEnabled) {
+                        particle.color.w = particle.initialAlpha * alphaRate;
+                    } else {
+                        particle.color.w = particle.initialAlpha - t;
+                    }
                 }
             }
 
             bool isGathering = false;
-            // トレイルパーティクルで速度継承がオフの場合はギャザリングしない
             bool shouldGather = particleSetting.isGatherMode && t >= particleSetting.gatherStartRatio;
-            if (particle.isChild && !particleSetting.trailInheritVelocity) {
-                shouldGather = false;
-            }
 
             if (shouldGather) {
                 isGathering = true;
@@ -82,19 +185,27 @@ void ParticleManager::Update(const ViewProjection &viewProjection) {
                 float distanceBasedAlpha = distance / (distance + 0.5f);
                 particle.color.w = particle.initialAlpha * (1.0f - gatherFactor) * distanceBasedAlpha;
                 if (distance < 0.05f) {
-                    particle.currentTime = particle.lifeTime;
+                    if (trail) {
+                        trail->Release(particle.trailSlot);
+                    }
+                    it = particles.erase(it);
                     continue;
                 }
                 float distanceFactor = std::min(1.0f, distance);
                 toEmitter = toEmitter.Normalize();
                 float gatherSpeed = particleSetting.gatherStrength * gatherFactor * distanceFactor * 3.0f;
-                Vector3 gatherVelocity = toEmitter * gatherSpeed * Frame::DeltaTime();
+                Vector3 gatherVelocity = toEmitter * gatherSpeed * deltaTime;
                 particle.velocity = gatherVelocity;
                 particle.transform.translation_ += particle.velocity;
             }
 
             if (!isGathering) {
-                particle.Acce = (1.0f - t) * particle.startAcce + t * particle.endAcce;
+                if (particleSetting.acceCurve.isEnabled) {
+                    Vector4 curveAcce = particleSetting.acceCurve.Sample(t);
+                    particle.Acce = {curveAcce.x, curveAcce.y, curveAcce.z};
+                } else {
+                    particle.Acce = (1.0f - t) * particle.startAcce + t * particle.endAcce;
+                }
 
                 if (particleSetting.isFaceDirection) {
                     Vector3 forward = particle.fixedDirection;
@@ -106,95 +217,262 @@ void ParticleManager::Update(const ViewProjection &viewProjection) {
                     particle.transform.rotation_.y = rotationAxis.y * angle;
                     particle.transform.rotation_.z = rotationAxis.z * angle;
                 } else if (particleSetting.isRandomRotate) {
-                    particle.transform.rotation_ += particle.rotateVelocity;
+                    particle.transform.rotation_ += particle.rotateVelocity * frames;
                 } else {
                     particle.transform.rotation_ =
                         (1.0f - t) * particle.startRote + t * particle.endRote;
                 }
 
-                if (particleSetting.isAcceMultiply) {
-                    particle.velocity *= particle.Acce;
-                } else {
-                    particle.velocity += particle.Acce;
+                // 張り付いたものは動かさない
+                if (!particle.isStuck) {
+                    if (particleSetting.isAcceMultiply) {
+                        particle.velocity *= Vector3{ScaleFactor(particle.Acce.x, frames), ScaleFactor(particle.Acce.y, frames),
+                                                     ScaleFactor(particle.Acce.z, frames)};
+                    } else {
+                        particle.velocity += particle.Acce * frames;
+                    }
+                    if (forceField) {
+                        particle.velocity += forceField->Sample(particle.transform.translation_) * (particleSetting.forceFieldScale * deltaTime);
+                    }
+                    if (neighborWork) {
+                        particle.velocity += neighborWork->forces[index] * deltaTime;
+                    }
+                    particle.transform.translation_ +=
+                        particle.velocity * deltaTime;
+                }
+            }
+
+            if (!particle.isStuck) {
+                particle.velocity.y -= particleSetting.gravity * deltaTime;
+            }
+            particle.currentTime += deltaTime;
+
+            const Vector3 &position = particle.transform.translation_;
+            if (!hasGroupBounds) {
+                groupMin = position;
+                groupMax = position;
+                hasGroupBounds = true;
+            } else {
+                groupMin = {std::min(groupMin.x, position.x), std::min(groupMin.y, position.y), std::min(groupMin.z, position.z)};
+                groupMax = {std::max(groupMax.x, position.x), std::max(groupMax.y, position.y), std::max(groupMax.z, position.z)};
+            }
+            if (trail) {
+                trail->SetHead(particle.trailSlot, particle.transform.translation_,
+                               particle.transform.scale_.x * particleSetting.trailScaleMultiplier.x,
+                               particle.color * particleSetting.trailColorMultiplier);
+            }
+            ++it;
+        }
+
+        // 当たり判定(グループのAABBで候補の形状をまとめて集めてから各パーティクルを判定する)
+        if (particleSetting.collision.response != ParticleCollisionResponse::None && hasGroupBounds) {
+            collider_.Prepare(particleSetting.collision, groupMin, groupMax);
+            for (auto it = particles.begin(); it != particles.end();) {
+                if (collider_.Resolve(particleSetting.collision, *it) == ParticleCollider::Result::Kill) {
+                    if (trail) {
+                        trail->Release(it->trailSlot);
+                    }
+                    it = particles.erase(it);
+                    continue;
                 }
-                particle.transform.translation_ +=
-                    particle.velocity * Frame::DeltaTime();
+                ++it;
             }
+        }
 
-            particle.velocity.y -= particleSetting.gravity * Frame::DeltaTime();
-            particle.currentTime += Frame::DeltaTime();
+        if (hasGroupBounds && !isStaging_) {
+            if (!hasBounds_) {
+                boundsMin_ = groupMin;
+                boundsMax_ = groupMax;
+                hasBounds_ = true;
+            } else {
+                boundsMin_ = {std::min(boundsMin_.x, groupMin.x), std::min(boundsMin_.y, groupMin.y), std::min(boundsMin_.z, groupMin.z)};
+                boundsMax_ = {std::max(boundsMax_.x, groupMax.x), std::max(boundsMax_.y, groupMax.y), std::max(boundsMax_.z, groupMax.z)};
+            }
+        }
+        if (trail) {
+            trail->Update(deltaTime);
+        }
+    }
+}
+
+void ParticleManager::WriteInstances(const ViewProjection &viewProjection, float interpolation) {
+    Matrix4x4 viewProjectionMatrix = viewProjection.matView_ * viewProjection.matProjection_;
+    Matrix4x4 billboardMatrix = viewProjection.matView_;
+    billboardMatrix.m[3][0] = 0.0f;
+    billboardMatrix.m[3][1] = 0.0f;
+    billboardMatrix.m[3][2] = 0.0f;
+    billboardMatrix.m[3][3] = 1.0f;
+    billboardMatrix = Inverse(billboardMatrix);
+
+    for (auto &[groupName, particleGroup] : particleGroups_) {
+        uint32_t numInstance = 0;
+        const ParticleSetting &particleSetting = particleSettings_[groupName];
+        ParticleGroupData &groupData = particleGroup->GetParticleGroupData();
+
+        // 必要な数だけページを借り、ページの境目で書き込み先を切り替える
+        const uint32_t maxInstance = particleGroup->ReserveInstances(static_cast<uint32_t>(groupData.particles.size()));
+        ParticleForGPU *instancingData = nullptr;
+        for (const Particle &particle : groupData.particles) {
+            if (numInstance >= maxInstance) {
+                break;
+            }
+            const uint32_t pageOffset = numInstance % ParticleInstancePool::kInstancesPerPage;
+            if (pageOffset == 0) {
+                instancingData = particleGroup->GetInstancePage(numInstance / ParticleInstancePool::kInstancesPerPage);
+            }
+            // 固定ステップ時は前ステップとの間を補間して描画
+            Vector3 translate = Lerp(particle.prevTranslation, particle.transform.translation_, interpolation);
             Matrix4x4 worldMatrix{};
             if (particleSetting.isBillboard) {
                 worldMatrix = MakeScaleMatrix(particle.transform.scale_) * billboardMatrix *
-                              MakeTranslateMatrix(particle.transform.translation_);
+                              MakeTranslateMatrix(translate);
             } else {
                 worldMatrix = MakeAffineMatrix(particle.transform.scale_,
                                                particle.transform.rotation_,
-                                               particle.transform.translation_);
+                                               translate);
             }
-            Matrix4x4 worldViewProjectionMatrix = worldMatrix * viewProjectionMatrix;
-            if (numInstance < particleGroup->GetMaxInstance()) {
-                particleGroup->GetParticleGroupData().instancingData[numInstance].WVP = worldViewProjectionMatrix;
-                particleGroup->GetParticleGroupData().instancingData[numInstance].World = worldMatrix;
-                particleGroup->GetParticleGroupData().instancingData[numInstance].color = particle.color;
-                particleGroup->GetParticleGroupData().instancingData[numInstance].color.w = particle.color.w;
-                ++numInstance;
-            }
-            aliveParticles.push_back(std::move(particle));
+            instancingData[pageOffset].WVP = worldMatrix * viewProjectionMatrix;
+            instancingData[pageOffset].World = worldMatrix;
+            instancingData[pageOffset].color = particle.color;
+            ++numInstance;
+        }
+        groupData.instanceCount = numInstance;
+
+        if (ParticleTrail *trail = particleGroup->GetTrail()) {
+            trail->WriteInstances(viewProjection);
         }
-        particles.swap(aliveParticles);
-        particleGroup->GetParticleGroupData().instanceCount = numInstance;
     }
 }
 
-// 軌跡パーティクル生成メソッド
-void ParticleManager::CreateTrailParticle(const Particle &parent, const ParticleSetting &setting) {
-    //// 現在の子パーティクル数をチェック
-    //auto &parentParticle = const_cast<Particle &>(parent);
-    //if (parentParticle.children.size() >= setting.maxTrailParticles) {
-    //    return; // 最大数に達している場合は生成しない
-    //}
+void ParticleManager::Clear() {
+    for (auto &[groupName, particleGroup] : particleGroups_) {
+        particleGroup->GetParticleGroupData().particles.clear();
+        particleGroup->GetParticleGroupData().instanceCount = 0;
+        if (ParticleTrail *trail = particleGroup->GetTrail()) {
+            trail->Clear();
+        }
+    }
+}
 
-    // 軌跡パーティクルを作成
-    Particle trailParticle;
-    trailParticle.isChild = true;
-    trailParticle.createTrail = false; // 軌跡は軌跡を作らない
+void ParticleManager::SetSeed(uint32_t seed) {
+    randomEngine.seed(seed);
+}
 
-    // 親の現在位置に配置
-    trailParticle.transform.translation_ = parent.transform.translation_;
-    trailParticle.transform.rotation_ = parent.transform.rotation_;
-    trailParticle.transform.scale_ = parent.transform.scale_ * setting.trailScaleMultiplier;
+bool ParticleManager::CanPrewarmAnalytically() const {
+    const Vector3 zero = {0.0f, 0.0f, 0.0f};
+    const Vector3 one = {1.0f, 1.0f, 1.0f};
+    for (const auto &[groupName, setting] : particleSettings_) {
+        // ギャザー・軌跡・ステップ単位の回転は積分できない
+        if (setting.isGatherMode || setting.enableTrail || setting.isRandomRotate) {
+            return false;
+        }
+        // 加速度カーブ・力場・近傍の力・当たり判定も位置に依存するので積分できない
+        if (setting.acceCurve.isEnabled || forceFields_.count(groupName) != 0 || setting.neighbor.mode != NeighborMode::None ||
+            setting.collision.response != ParticleCollisionResponse::None) {
+            return false;
+        }
+        // 加速度が恒等(加算なら0、乗算なら1)であること
+        const Vector3 &identity = setting.isAcceMultiply ? one : zero;
+        if (setting.startAcce != identity || setting.endAcce != identity) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    // 速度の設定
-    if (setting.trailInheritVelocity) {
-        trailParticle.velocity = parent.velocity * setting.trailVelocityScale;
-    } else {
-        trailParticle.velocity = {0.0f, 0.0f, 0.0f};
+float ParticleManager::GetMaxLifeTime() const {
+    float maxLifeTime = 0.0f;
+    for (const auto &[groupName, setting] : particleSettings_) {
+        maxLifeTime = std::max(maxLifeTime, std::max(setting.lifeTimeMin, setting.lifeTimeMax));
     }
+    return maxLifeTime;
+}
 
-    // 色と透明度
-    trailParticle.color = parent.color * setting.trailColorMultiplier;
-    trailParticle.initialAlpha = trailParticle.color.w;
+bool ParticleManager::GetBounds(Vector3 &min, Vector3 &max) const {
+    if (!hasBounds_) {
+        return false;
+    }
+    min = boundsMin_;
+    max = boundsMax_;
+    return true;
+}
 
-    // 寿命
-    trailParticle.lifeTime = parent.lifeTime * setting.trailLifeScale;
-    trailParticle.currentTime = 0.0f;
+void ParticleManager::BeginStaging() {
+    stagingParticles_.clear();
+    for (const auto &[groupName, particleGroup] : particleGroups_) {
+        stagingParticles_[groupName];
+    }
+    isStaging_ = true;
+}
 
-    // その他のプロパティをコピー
-    trailParticle.startScale = parent.startScale * setting.trailScaleMultiplier;
-    trailParticle.endScale = parent.endScale * setting.trailScaleMultiplier;
-    trailParticle.startAcce = parent.startAcce;
-    trailParticle.endAcce = parent.endAcce;
+void ParticleManager::CommitStaging() {
+    for (auto &[groupName, particleGroup] : particleGroups_) {
+        auto it = stagingParticles_.find(groupName);
+        if (it != stagingParticles_.end()) {
+            auto &particles = particleGroup->GetParticleGroupData().particles;
+            particles.splice(particles.end(), it->second);
+        }
+    }
+    stagingParticles_.clear();
+    isStaging_ = false;
+}
+
+std::list<Particle> &ParticleManager::GetParticles(const std::string &groupName, ParticleGroup *particleGroup) {
+    if (isStaging_) {
+        return stagingParticles_[groupName];
+    }
+    return particleGroup->GetParticleGroupData().particles;
+}
 
-    // パーティクルグループに追加
+void ParticleManager::EmitAdvanced(float age) {
     for (auto &[groupName, particleGroup] : particleGroups_) {
-        if (particleSettings_[groupName].enableTrail) {
-            particleGroup->GetParticleGroupData().particles.push_back(trailParticle);
-            break;
+        const ParticleSetting &setting = particleSettings_[groupName];
+        auto &particles = GetParticles(groupName, particleGroup);
+        for (uint32_t nowCount = 0; nowCount < setting.count; ++nowCount) {
+            Particle particle = MakeNewParticle(randomEngine, setting, FindEmitMesh(groupName));
+            if (particle.lifeTime <= age) {
+                continue;
+            }
+            // 等速運動+重力
+            particle.transform.translation_ += particle.velocity * age;
+            particle.transform.translation_.y -= 0.5f * setting.gravity * age * age;
+            particle.velocity.y -= setting.gravity * age;
+            particle.prevTranslation = particle.transform.translation_;
+            particle.currentTime = age;
+            particles.push_back(std::move(particle));
         }
     }
 }
 
+
+
+// 軌跡点の生成
+void ParticleManager::CreateTrailPoint(ParticleTrail &trail, const Particle &parent, const ParticleSetting &setting) {
+    if (parent.trailSlot == ParticleTrail::kInvalidSlot) {
+        return; // スロットが足りない場合は軌跡なし
+    }
+
+    ParticleTrail::TrailPoint point{};
+    // 親の現在位置に配置
+    point.position = parent.transform.translation_;
+    point.width = parent.transform.scale_.x * setting.trailScaleMultiplier.x;
+
+    // 速度の設定
+    if (setting.trailInheritVelocity) {
+        point.velocity = parent.velocity * setting.trailVelocityScale;
+    } else {
+        point.velocity = {0.0f, 0.0f, 0.0f};
+    }
+
+    // 色と寿命
+    point.color = parent.color * setting.trailColorMultiplier;
+    point.lifeTime = parent.lifeTime * setting.trailLifeScale;
+    point.age = 0.0f;
+
+    trail.PushPoint(parent.trailSlot, point);
+}
+
+
 void ParticleManager::SetTrailEnabled(const std::string &groupName, bool enabled) {
     if (particleSettings_.find(groupName) != particleSettings_.end()) {
         particleSettings_[groupName].enableTrail = enabled;
@@ -210,22 +488,34 @@ void ParticleManager::SetTrailSettings(const std::string &groupName, float inter
 
 void ParticleManager::Draw() {
     for (auto &[groupName, particleGroup] : particleGroups_) {
+        if (particleGroup->IsHeadless()) {
+            continue;
+        }
         const auto &meshes = particleGroup->GetModelData().meshes;
         for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex) {
             D3D12_INDEX_BUFFER_VIEW indexBufferView = particleGroup->GetIndexBufferView();
             D3D12_VERTEX_BUFFER_VIEW vertexBufferView = particleGroup->GetVertexBufferView();
             particleCommon->GetDxCommon()->GetCommandList()->IASetIndexBuffer(&indexBufferView);
             particleCommon->GetDxCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
-            if (particleGroup->GetParticleGroupData().instanceCount > 0) {
+            const uint32_t instanceCount = particleGroup->GetParticleGroupData().instanceCount;
+            if (instanceCount > 0) {
                 particleCommon->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(0, particleGroup->GetmaterialResource()->GetGPUVirtualAddress());
-                srvManager_->SetGraphicsRootDescriptorTable(1, particleGroup->GetParticleGroupData().instancingSRVIndex);
                 srvManager_->SetGraphicsRootDescriptorTable(2, particleGroup->GetParticleGroupData().materials[meshIndex].textureIndex);
-                particleCommon->GetDxCommon()->GetCommandList()->DrawIndexedInstanced(
-                    UINT(meshes[meshIndex].indices.size()),
-                    particleGroup->GetParticleGroupData().instanceCount,
-                    0, 0, 0);
+                // ページごとに1回のインスタンス描画
+                for (uint32_t first = 0, page = 0; first < instanceCount; first += ParticleInstancePool::kInstancesPerPage, ++page) {
+                    srvManager_->SetGraphicsRootDescriptorTable(1, particleGroup->GetInstancePageSrvIndex(page));
+                    particleCommon->GetDxCommon()->GetCommandList()->DrawIndexedInstanced(
+                        UINT(meshes[meshIndex].indices.size()),
+                        std::min(instanceCount - first, ParticleInstancePool::kInstancesPerPage),
+                        0, 0, 0);
+                }
             }
         }
+        // 軌跡はグループごとに1回のインスタンス描画
+        if (ParticleTrail *trail = particleGroup->GetTrail()) {
+            trail->Draw(particleGroup->GetmaterialResource()->GetGPUVirtualAddress(),
+                        particleGroup->GetParticleGroupData().materials[0].textureIndex);
+        }
     }
 }
 
@@ -244,6 +534,7 @@ void ParticleManager::RemoveParticleGroup(const std::string &name) {
     // マップから削除
     particleGroups_.erase(name);
     particleSettings_.erase(name);
+    neighborWorks_.erase(name);
 
     // vector からも削除
     auto it = std::find(particleGroupNames_.begin(), particleGroupNames_.end(), name);
@@ -255,29 +546,72 @@ void ParticleManager::RemoveParticleGroup(const std::string &name) {
 void ParticleManager::SetParticleSetting(const std::string &groupName, const ParticleSetting &setting) {
     particleSettings_[groupName] = setting;
 }
+void ParticleManager::SetEmitMesh(const std::string &groupName, const MeshSurfaceSampler *sampler) {
+    if (!sampler) {
+        emitMeshes_.erase(groupName);
+        return;
+    }
+    EmitMesh &emitMesh = emitMeshes_[groupName];
+    if (emitMesh.sampler != sampler) {
+        emitMesh.palette.clear();
+    }
+    emitMesh.sampler = sampler;
+}
+
+void ParticleManager::SetEmitMeshPose(const std::string &groupName, const Skeleton &skeleton) {
+    auto it = emitMeshes_.find(groupName);
+    if (it == emitMeshes_.end() || !it->second.sampler || !it->second.sampler->IsSkinned()) {
+        return;
+    }
+    // 容量は初回で確保されるので毎フレームの再確保は無い
+    it->second.sampler->ComputePalette(skeleton, it->second.palette);
+}
+
+void ParticleManager::SetForceField(const std::string &groupName, const ParticleForceField *forceField) {
+    if (forceField) {
+        forceFields_[groupName] = forceField;
+    } else {
+        forceFields_.erase(groupName);
+    }
+}
+
+void ParticleManager::SetEmitTransform(const Vector3 &translate, const Vector3 &rotation, const Vector3 &scale) {
+    for (auto &[groupName, setting] : particleSettings_) {
+        setting.translate = translate;
+        setting.rotation = rotation;
+        setting.scale = scale;
+    }
+}
 ParticleSetting &ParticleManager::GetParticleSetting(const std::string &groupName) {
     return particleSettings_[groupName];
 }
 std::vector<std::string> ParticleManager::GetParticleGroupsName() {
     return particleGroupNames_;
 }
+size_t ParticleManager::GetParticleCount() const {
+    size_t count = 0;
+    for (const auto &[groupName, particleGroup] : particleGroups_) {
+        count += particleGroup->GetParticleGroupData().particles.size();
+    }
+    return count;
+}
 
-Particle ParticleManager::MakeNewParticle(std::mt19937 &randomEngine, const ParticleSetting &setting) {
+Vector3 ParticleManager::MakeShapePosition(std::mt19937 &randomEngine, const ParticleSetting &setting, const EmitMesh *emitMesh, Vector3 &normal) {
     std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
-    std::uniform_real_distribution<float> distVelocityX(setting.velocityMin.x, setting.velocityMax.x);
-    std::uniform_real_distribution<float> distVelocityY(setting.velocityMin.y, setting.velocityMax.y);
-    std::uniform_real_distribution<float> distVelocityZ(setting.velocityMin.z, setting.velocityMax.z);
-    std::uniform_real_distribution<float> distLifeTime(setting.lifeTimeMin, setting.lifeTimeMax);
-    std::uniform_real_distribution<float> distAlpha(setting.alphaMin, setting.alphaMax);
+    std::uniform_real_distribution<float> distUnit(0.0f, 1.0f);
+    normal = {0.0f, 1.0f, 0.0f};
 
-    Particle particle;
-    Vector3 randomTranslate;
-    particle.emitterPosition = setting.translate;
-    if (setting.isEmitOnEdge) {
+    EmitShape shape = setting.emitShape;
+    // 旧データの「外周」は辺上の発生として扱う
+    if (shape == EmitShape::Box && setting.isEmitOnEdge) {
+        shape = EmitShape::Edge;
+    }
+
+    switch (shape) {
+    case EmitShape::Edge: {
         std::uniform_int_distribution<int> edgeSelector(0, 11);
-        std::uniform_real_distribution<float> edgePosition(0.0f, 1.0f);
         int selectedEdge = edgeSelector(randomEngine);
-        float position = edgePosition(randomEngine);
+        float position = distUnit(randomEngine);
         const Vector3 v0 = {-1.0f, -1.0f, -1.0f};
         const Vector3 v1 = {1.0f, -1.0f, -1.0f};
         const Vector3 v2 = {-1.0f, 1.0f, -1.0f};
@@ -290,25 +624,82 @@ Particle ParticleManager::MakeNewParticle(std::mt19937 &randomEngine, const Part
             {v0, v1}, {v1, v3}, {v3, v2}, {v2, v0}, {v4, v5}, {v5, v7}, {v7, v6}, {v6, v4}, {v0, v4}, {v1, v5}, {v2, v6}, {v3, v7}};
         const Vector3 &start = edges[selectedEdge].first;
         const Vector3 &end = edges[selectedEdge].second;
-        randomTranslate = {
+        Vector3 result = {
             start.x + (end.x - start.x) * position,
             start.y + (end.y - start.y) * position,
             start.z + (end.z - start.z) * position};
-        randomTranslate.x *= setting.scale.x;
-        randomTranslate.y *= setting.scale.y;
-        randomTranslate.z *= setting.scale.z;
-    } else {
-        randomTranslate = {
-            distribution(randomEngine) * setting.scale.x,
-            distribution(randomEngine) * setting.scale.y,
-            distribution(randomEngine) * setting.scale.z};
+        normal = result.Normalize();
+        return result;
+    }
+    case EmitShape::Sphere: {
+        // 一様な方向 + 体積で一様になる半径
+        float z = distribution(randomEngine);
+        float phi = distUnit(randomEngine) * 2.0f * DirectX::XM_PI;
+        float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+        normal = {r * std::cos(phi), z, r * std::sin(phi)};
+        float radius = setting.isEmitOnShell ? 1.0f : std::cbrt(distUnit(randomEngine));
+        return normal * radius;
+    }
+    case EmitShape::Cone: {
+        // 高さ1の円錐の体積で一様(断面積が高さの2乗に比例するので高さは立方根、断面の円内は面積で一様)
+        // 法線は頂点から発生点への向き
+        float tanAngle = std::tan(std::clamp(setting.coneAngle, 0.0f, DirectX::XM_PIDIV2 * 0.99f));
+        float height = std::cbrt(distUnit(randomEngine));
+        float radius = height * tanAngle * std::sqrt(distUnit(randomEngine));
+        float phi = distUnit(randomEngine) * 2.0f * DirectX::XM_PI;
+        Vector3 result = {radius * std::cos(phi), height, radius * std::sin(phi)};
+        normal = result.LengthSq() > 0.0f ? result.Normalize() : Vector3{0.0f, 1.0f, 0.0f};
+        return result;
+    }
+    case EmitShape::Ring: {
+        // 内径～外径の間で面積が一様
+        float inner = std::clamp(setting.ringInnerRatio, 0.0f, 1.0f);
+        float radius = std::sqrt(inner * inner + distUnit(randomEngine) * (1.0f - inner * inner));
+        float phi = distUnit(randomEngine) * 2.0f * DirectX::XM_PI;
+        normal = {std::cos(phi), 0.0f, std::sin(phi)};
+        return normal * radius;
     }
+    case EmitShape::MeshSurface:
+        if (emitMesh && emitMesh->sampler && !emitMesh->sampler->IsEmpty()) {
+            std::array<float, 3> random = {distUnit(randomEngine), distUnit(randomEngine), distUnit(randomEngine)};
+            MeshSurfaceSampler::Sample sample = emitMesh->sampler->SampleSurface(random, emitMesh->palette.empty() ? nullptr : &emitMesh->palette);
+            normal = sample.normal;
+            return sample.position;
+        }
+        // メッシュ未設定なら箱
+        [[fallthrough]];
+    case EmitShape::Box:
+    default:
+        return {distribution(randomEngine), distribution(randomEngine), distribution(randomEngine)};
+    }
+}
+
+const ParticleManager::EmitMesh *ParticleManager::FindEmitMesh(const std::string &groupName) const {
+    auto it = emitMeshes_.find(groupName);
+    return it != emitMeshes_.end() ? &it->second : nullptr;
+}
+
+Particle ParticleManager::MakeNewParticle(std::mt19937 &randomEngine, const ParticleSetting &setting, const EmitMesh *emitMesh) {
+    std::uniform_real_distribution<float> distVelocityX(setting.velocityMin.x, setting.velocityMax.x);
+    std::uniform_real_distribution<float> distVelocityY(setting.velocityMin.y, setting.velocityMax.y);
+    std::uniform_real_distribution<float> distVelocityZ(setting.velocityMin.z, setting.velocityMax.z);
+    std::uniform_real_distribution<float> distLifeTime(setting.lifeTimeMin, setting.lifeTimeMax);
+    std::uniform_real_distribution<float> distAlpha(setting.alphaMin, setting.alphaMax);
+
+    Particle particle;
+    particle.emitterPosition = setting.translate;
+    Vector3 shapeNormal;
+    Vector3 randomTranslate = MakeShapePosition(randomEngine, setting, emitMesh, shapeNormal);
+    randomTranslate.x *= setting.scale.x;
+    randomTranslate.y *= setting.scale.y;
+    randomTranslate.z *= setting.scale.z;
     Matrix4x4 rotationMatrix = MakeRotateXYZMatrix(setting.rotation);
     Vector3 rotatedPosition = {
         randomTranslate.x * rotationMatrix.m[0][0] + randomTranslate.y * rotationMatrix.m[1][0] + randomTranslate.z * rotationMatrix.m[2][0],
         randomTranslate.x * rotationMatrix.m[0][1] + randomTranslate.y * rotationMatrix.m[1][1] + randomTranslate.z * rotationMatrix.m[2][1],
         randomTranslate.x * rotationMatrix.m[0][2] + randomTranslate.y * rotationMatrix.m[1][2] + randomTranslate.z * rotationMatrix.m[2][2]};
     particle.transform.translation_ = setting.translate + rotatedPosition;
+    particle.prevTranslation = particle.transform.translation_;
 
     if (setting.isRandomAllSize) {
         std::uniform_real_distribution<float> distScaleX(setting.allScaleMin.x, setting.allScaleMax.x);
@@ -339,6 +730,9 @@ Particle ParticleManager::MakeNewParticle(std::mt19937 &randomEngine, const Part
         randomVelocity.x * rotationMatrix.m[0][0] + randomVelocity.y * rotationMatrix.m[1][0] + randomVelocity.z * rotationMatrix.m[2][0],
         randomVelocity.x * rotationMatrix.m[0][1] + randomVelocity.y * rotationMatrix.m[1][1] + randomVelocity.z * rotationMatrix.m[2][1],
         randomVelocity.x * rotationMatrix.m[0][2] + randomVelocity.y * rotationMatrix.m[1][2] + randomVelocity.z * rotationMatrix.m[2][2]};
+    if (setting.shapeNormalSpeed != 0.0f) {
+        particle.velocity += TransformNormal(shapeNormal, rotationMatrix) * setting.shapeNormalSpeed;
+    }
     if (setting.isRandomRotate) {
         std::uniform_real_distribution<float> distRotateX(setting.rotateStartMin.x, setting.rotateStartMax.x);
         std::uniform_real_distribution<float> distRotateY(setting.rotateStartMin.y, setting.rotateStartMax.y);
@@ -391,12 +785,11 @@ std::list<Particle> ParticleManager::Emit() {
         std::list<Particle> newParticles;
         ParticleSetting &setting = particleSettings_[groupName];
         for (uint32_t nowCount = 0; nowCount < setting.count; ++nowCount) {
-            Particle particle = MakeNewParticle(randomEngine, setting);
+            Particle particle = MakeNewParticle(randomEngine, setting, FindEmitMesh(groupName));
             newParticles.push_back(particle);
         }
-        particleGroup->GetParticleGroupData().particles.splice(
-            particleGroup->GetParticleGroupData().particles.end(),
-            newParticles);
+        auto &particles = GetParticles(groupName, particleGroup);
+        particles.splice(particles.end(), newParticles);
         allNewParticles.splice(allNewParticles.end(), newParticles);
     }
     return allNewParticles;
@@ -7,11 +7,27 @@
 #include "ViewProjection/ViewProjection.h"
 #include <type/Matrix4x4.h>
 #include <ModelStructs.h>
+#include <ParticleCollision.h>
+#include <ParticleCurve.h>
 #include <ParticleGroup.h>
+#include <ParticleNeighborGrid.h>
 #include <WorldTransform.h>
 #include <random>
 #include <unordered_map> // 追加
 
+class MeshSurfaceSampler;
+class ParticleForceField;
+
+// 発生位置の形状(いずれもtranslate/rotation/scaleで配置する単位形状)
+enum class EmitShape : int32_t {
+    Box,         // 箱の内部
+    Edge,        // 箱の辺上
+    Sphere,      // 球
+    Cone,        // 円錐(頂点が原点、+Y方向に開く)
+    Ring,        // XZ平面のリング
+    MeshSurface, // モデルの表面
+};
+
 struct ParticleSetting {
     Vector3 translate;
     Vector3 rotation;
@@ -51,54 +67,142 @@ struct ParticleSetting {
     bool isFaceDirection = false;
     bool isEndScale = false;
     bool isEmitOnEdge = false;
+    EmitShape emitShape = EmitShape::Box;
+    bool isEmitOnShell = false;    // 球: 表面からのみ発生
+    float coneAngle = 0.5f;        // 円錐の半角(ラジアン)
+    float ringInnerRatio = 0.8f;   // リングの内径(外径に対する比率)
+    float shapeNormalSpeed = 0.0f; // 発生点の法線方向に加える初速
+    float forceFieldScale = 1.0f;  // 力場の影響の倍率
+    ParticleNeighborSetting neighbor; // 近傍の振る舞い(群れ・分離・簡易流体)
+    ParticleCollisionSetting collision; // 平面・シーンのコライダーとの当たり判定
     bool isGatherMode = false;
     float gatherStartRatio = 0.5f;
     float gatherStrength = 2.0f;
     bool enableTrail;             // 軌跡機能を有効にするか
     float trailSpawnInterval;     // 軌跡パーティクル生成間隔
-    int maxTrailParticles;        // 最大軌跡パーティクル数
+    int maxTrailParticles;        // 1本の軌跡の最大点数
     float trailLifeScale;         // 軌跡パーティクルの寿命スケール
     Vector3 trailScaleMultiplier; // 軌跡パーティクルのサイズ倍率
     Vector4 trailColorMultiplier; // 軌跡パーティクルの色倍率
     bool trailInheritVelocity;    // 軌跡が親の速度を継承するか
     float trailVelocityScale;     // 軌跡の速度スケール
 
+    // 寿命に対するカーブ(有効なら2点補間の代わりに使う)
+    ParticleCurve colorCurve; // rgb:色 w:初期アルファへの倍率
+    ParticleCurve scaleCurve; // 初期スケールへの倍率(isSinMove時は使わず、sin波のLUTを引く)
+    ParticleCurve acceCurve;  // 加速度
+
     ParticleSetting() : enableTrail(false), trailSpawnInterval(0.05f),
                         maxTrailParticles(20), trailLifeScale(0.5f),
                         trailScaleMultiplier({0.8f, 0.8f, 0.8f}),
                         trailColorMultiplier({1.0f, 1.0f, 1.0f, 0.7f}),
-                        trailInheritVelocity(true), trailVelocityScale(0.3f) {}
+                        trailInheritVelocity(true), trailVelocityScale(0.3f) {
+        colorCurve.Reset({1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 0.0f});
+        scaleCurve.Reset({1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f, 0.0f});
+        acceCurve.Reset({1.0f, 1.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f, 0.0f});
+    }
+
+    // カーブをLUTに焼き直す(キーを変えたら呼ぶ)
+    void BakeCurves() {
+        colorCurve.Bake();
+        acceCurve.Bake();
+        scaleCurve.Bake();
+    }
 };
 
 class ParticleManager {
   public:
     void Initialize(SrvManager *srvManager);
+    // Simulate(Frame::DeltaTime()) + WriteInstances
     void Update(const ViewProjection &viewProjeciton);
+    // 1ステップ分シミュレーションを進める(GPUリソースには触れない)
+    void Simulate(float deltaTime);
+    // インスタンシングデータの書き込み(interpolationは前ステップとの補間率)
+    void WriteInstances(const ViewProjection &viewProjection, float interpolation);
     void Draw();
+    // 全グループのパーティクルを破棄
+    void Clear();
+    // 乱数シードの指定(再現用)
+    void SetSeed(uint32_t seed);
+    // 全グループが等速+重力だけで動くか(プリウォームを解析的に行えるか)
+    bool CanPrewarmAnalytically() const;
+    // 全グループの最大寿命
+    float GetMaxLifeTime() const;
+    // age秒前に発生したものとして解析的に進めたパーティクルを発生させる
+    void EmitAdvanced(float age);
+    // 以降の発生・シミュレーションを共有グループではなく専用のリストに貯める(ワーカースレッドでのプリウォーム用)
+    // 貯めている間は軌跡とAABBを更新しない
+    void BeginStaging();
+    // 貯めたパーティクルを各グループに移す(メインスレッドで呼ぶ)
+    void CommitStaging();
+    // 直近のシミュレーションでのパーティクルのAABB(パーティクルが無ければfalse)
+    bool GetBounds(Vector3 &min, Vector3 &max) const;
     void AddParticleGroup(ParticleGroup *particleGroup);
     void RemoveParticleGroup(const std::string &name);
 
     // グループごとのParticleSetting
     void SetParticleSetting(const std::string &groupName, const ParticleSetting &setting);
+    // 全グループの発生位置・回転・拡縮をまとめて差し替える
+    void SetEmitTransform(const Vector3 &translate, const Vector3 &rotation, const Vector3 &scale);
+    // MeshSurface形状で使うメッシュ(nullptrで解除)
+    void SetEmitMesh(const std::string &groupName, const MeshSurfaceSampler *sampler);
+    // スキンメッシュの現在のポーズを発生位置に反映する
+    void SetEmitMeshPose(const std::string &groupName, const Skeleton &skeleton);
+    // グループに掛ける力場(nullptrで解除、複数のマネージャーで共有してよい)
+    void SetForceField(const std::string &groupName, const ParticleForceField *forceField);
     ParticleSetting &GetParticleSetting(const std::string &groupName);
     std::vector<std::string> GetParticleGroupsName();
+    size_t GetParticleCount() const;
     void SetTrailEnabled(const std::string &groupName, bool enabled);
     void SetTrailSettings(const std::string &groupName, float interval, int maxTrails);
 
+  private:
+    // グループごとの発生用メッシュ
+    struct EmitMesh {
+        const MeshSurfaceSampler *sampler = nullptr;
+        std::vector<Matrix4x4> palette; // 空ならバインドポーズ
+    };
+
+    // グループごとの近傍計算の作業領域(毎フレーム使い回す)
+    struct NeighborWork {
+        ParticleNeighborGrid grid;
+        std::vector<Vector3> positions;
+        std::vector<Vector3> velocities;
+        std::vector<Vector3> forces;
+    };
+
   private:
     ParticleCommon *particleCommon = nullptr;
     SrvManager *srvManager_;
     std::unordered_map<std::string, ParticleGroup *> particleGroups_;
     std::unordered_map<std::string, ParticleSetting> particleSettings_; // ここがポイント
     std::vector<std::string> particleGroupNames_;
+    std::unordered_map<std::string, EmitMesh> emitMeshes_;
+    std::unordered_map<std::string, const ParticleForceField *> forceFields_;
+    std::unordered_map<std::string, NeighborWork> neighborWorks_;
+    ParticleCollider collider_; // グループごとに候補を集め直して使い回す
     std::random_device seedGenerator;
     std::mt19937 randomEngine;
 
+    // シミュレーション中に更新するAABB
+    Vector3 boundsMin_;
+    Vector3 boundsMax_;
+    bool hasBounds_ = false;
+
+    // プリウォーム中に貯めるパーティクル(グループはほかのマネージャーとも共有なので直接触らない)
+    std::unordered_map<std::string, std::list<Particle>> stagingParticles_;
+    bool isStaging_ = false;
+
   public:
     std::list<Particle> Emit();
 
   private:
-    void CreateTrailParticle(const Particle &parent, const ParticleSetting &setting);
+    void CreateTrailPoint(ParticleTrail &trail, const Particle &parent, const ParticleSetting &setting);
 
-    Particle MakeNewParticle(std::mt19937 &randomEngine, const ParticleSetting &setting);
+    Particle MakeNewParticle(std::mt19937 &randomEngine, const ParticleSetting &setting, const EmitMesh *emitMesh = nullptr);
+    // 発生形状内の点(単位形状のローカル座標)と法線
+    Vector3 MakeShapePosition(std::mt19937 &randomEngine, const ParticleSetting &setting, const EmitMesh *emitMesh, Vector3 &normal);
+    const EmitMesh *FindEmitMesh(const std::string &groupName) const;
+    // 発生・更新の対象になるリスト(ステージング中は専用のリスト)
+    std::list<Particle> &GetParticles(const std::string &groupName, ParticleGroup *particleGroup);
 };
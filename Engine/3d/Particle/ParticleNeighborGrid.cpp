@@ -0,0 +1,214 @@
+#include "ParticleNeighborGrid.h"
+#include "Log/Logger.h"
+#include "Thread/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace Logger;
+
+void to_json(nlohmann::json &j, const ParticleNeighborSetting &setting) {
+    j = nlohmann::json{
+        {"mode", static_cast<int32_t>(setting.mode)},
+        {"radius", setting.radius},
+        {"maxNeighbors", setting.maxNeighbors},
+        {"separationWeight", setting.separationWeight},
+        {"alignmentWeight", setting.alignmentWeight},
+        {"cohesionWeight", setting.cohesionWeight},
+        {"stiffness", setting.stiffness},
+        {"restDensity", setting.restDensity},
+        {"viscosity", setting.viscosity},
+    };
+}
+
+void from_json(const nlohmann::json &j, ParticleNeighborSetting &setting) {
+    ParticleNeighborSetting defaults;
+    setting.mode = static_cast<NeighborMode>(j.value("mode", static_cast<int32_t>(defaults.mode)));
+    setting.radius = j.value("radius", defaults.radius);
+    setting.maxNeighbors = j.value("maxNeighbors", defaults.maxNeighbors);
+    setting.separationWeight = j.value("separationWeight", defaults.separationWeight);
+    setting.alignmentWeight = j.value("alignmentWeight", defaults.alignmentWeight);
+    setting.cohesionWeight = j.value("cohesionWeight", defaults.cohesionWeight);
+    setting.stiffness = j.value("stiffness", defaults.stiffness);
+    setting.restDensity = j.value("restDensity", defaults.restDensity);
+    setting.viscosity = j.value("viscosity", defaults.viscosity);
+}
+
+void ParticleNeighborGrid::Build(const std::vector<Vector3> &positions, float cellSize) {
+    const uint32_t count = static_cast<uint32_t>(positions.size());
+    cellSize_ = std::max(cellSize, 0.0001f);
+    inverseCellSize_ = 1.0f / cellSize_;
+
+    // 粒子数の2倍以上の2のべき乗(衝突を減らしつつマスクで引けるように)
+    uint32_t tableSize = 64;
+    while (tableSize < count * 2) {
+        tableSize <<= 1;
+    }
+    tableMask_ = tableSize - 1;
+
+    // バケットごとの個数を数える
+    cellStart_.assign(tableSize + 1, 0);
+    particleBuckets_.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const Vector3 &position = positions[i];
+        uint32_t bucket = HashCell(CellCoord(position.x), CellCoord(position.y), CellCoord(position.z));
+        particleBuckets_[i] = bucket;
+        ++cellStart_[bucket];
+    }
+    // 累積して各バケットの終端にする
+    for (uint32_t bucket = 1; bucket < tableSize; ++bucket) {
+        cellStart_[bucket] += cellStart_[bucket - 1];
+    }
+    cellStart_[tableSize] = count;
+    // 末尾から詰めると元の順番のまま並び、終わると各バケットの値が開始位置になる
+    sortedIndices_.resize(count);
+    sortedPositions_.resize(count);
+    for (uint32_t i = count; i > 0; --i) {
+        uint32_t index = i - 1;
+        uint32_t slot = --cellStart_[particleBuckets_[index]];
+        sortedIndices_[slot] = index;
+        sortedPositions_[slot] = positions[index];
+    }
+}
+
+void ParticleNeighborGrid::Solve(const ParticleNeighborSetting &setting, const std::vector<Vector3> &positions,
+                                 const std::vector<Vector3> &velocities, std::vector<Vector3> &forces) {
+    forces.assign(positions.size(), Vector3{0.0f, 0.0f, 0.0f});
+    if (setting.mode == NeighborMode::None || positions.empty()) {
+        return;
+    }
+    Build(positions, setting.radius);
+    if (setting.mode == NeighborMode::Fluid) {
+        SolveFluid(setting, positions, velocities, forces);
+    } else {
+        SolveSeparation(setting, positions, velocities, forces);
+    }
+}
+
+void ParticleNeighborGrid::SolveSeparation(const ParticleNeighborSetting &setting, const std::vector<Vector3> &positions,
+                                           const std::vector<Vector3> &velocities, std::vector<Vector3> &forces) {
+    const bool isFlock = setting.mode == NeighborMode::Flock;
+    const uint32_t count = static_cast<uint32_t>(positions.size());
+
+    // ソート順に回して、同じチャンク内の粒子が同じセルを見るようにする
+    ThreadPool::GetInstance()->ParallelFor(count, kGrainSize, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t slot = begin; slot < end; ++slot) {
+            const uint32_t index = sortedIndices_[slot];
+            Vector3 separation = {0.0f, 0.0f, 0.0f};
+            Vector3 velocitySum = {0.0f, 0.0f, 0.0f};
+            Vector3 offsetSum = {0.0f, 0.0f, 0.0f};
+            uint32_t neighborCount = 0;
+
+            ForEachNeighbor(sortedPositions_[slot], [&](uint32_t other, const Vector3 &offset, float distanceSquared) {
+                if (other == index || distanceSquared <= 0.0f) {
+                    return true;
+                }
+                separation -= offset / distanceSquared;
+                velocitySum += velocities[other];
+                offsetSum += offset;
+                return ++neighborCount < setting.maxNeighbors;
+            });
+
+            Vector3 force = separation * setting.separationWeight;
+            if (isFlock && neighborCount > 0) {
+                float inverseCount = 1.0f / static_cast<float>(neighborCount);
+                force += (velocitySum * inverseCount - velocities[index]) * setting.alignmentWeight;
+                force += offsetSum * inverseCount * setting.cohesionWeight;
+            }
+            forces[index] = force;
+        }
+    });
+}
+
+void ParticleNeighborGrid::SolveFluid(const ParticleNeighborSetting &setting, const std::vector<Vector3> &positions,
+                                      const std::vector<Vector3> &velocities, std::vector<Vector3> &forces) {
+    const uint32_t count = static_cast<uint32_t>(positions.size());
+    const float inverseRadius = 1.0f / cellSize_;
+    densities_.resize(count);
+
+    // 1パス目: 密度(自分も含めた(1-d/h)^2の和)
+    ThreadPool::GetInstance()->ParallelFor(count, kGrainSize, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t slot = begin; slot < end; ++slot) {
+            float density = 0.0f;
+            uint32_t neighborCount = 0;
+            ForEachNeighbor(sortedPositions_[slot], [&](uint32_t, const Vector3 &, float distanceSquared) {
+                float q = 1.0f - std::sqrt(distanceSquared) * inverseRadius;
+                density += q * q;
+                return ++neighborCount < setting.maxNeighbors;
+            });
+            densities_[sortedIndices_[slot]] = density;
+        }
+    });
+
+    // 2パス目: 圧力(基準の密度との差に比例)と粘性
+    ThreadPool::GetInstance()->ParallelFor(count, kGrainSize, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t slot = begin; slot < end; ++slot) {
+            const uint32_t index = sortedIndices_[slot];
+            const float pressure = setting.stiffness * (densities_[index] - setting.restDensity);
+            Vector3 force = {0.0f, 0.0f, 0.0f};
+            uint32_t neighborCount = 0;
+            ForEachNeighbor(sortedPositions_[slot], [&](uint32_t other, const Vector3 &offset, float distanceSquared) {
+                if (other == index || distanceSquared <= 0.0f) {
+                    return true;
+                }
+                float distance = std::sqrt(distanceSquared);
+                float q = 1.0f - distance * inverseRadius;
+                float otherPressure = setting.stiffness * (densities_[other] - setting.restDensity);
+                force -= offset * ((pressure + otherPressure) * 0.5f * q / distance);
+                force += (velocities[other] - velocities[index]) * (setting.viscosity * q);
+                return ++neighborCount < setting.maxNeighbors;
+            });
+            forces[index] = force;
+        }
+    });
+}
+
+ParticleNeighborGrid::BenchmarkResult ParticleNeighborGrid::Benchmark(uint32_t count, uint32_t frames) {
+    ParticleNeighborSetting setting;
+    setting.mode = NeighborMode::Flock;
+
+    // 1粒子あたり平均20個ほどが半径に入る密度で立方体に並べる
+    const float kNeighborTarget = 20.0f;
+    float sphereVolume = 4.0f / 3.0f * 3.14159265f * setting.radius * setting.radius * setting.radius;
+    float side = std::cbrt(static_cast<float>(count) * sphereVolume / kNeighborTarget);
+
+    std::mt19937 randomEngine(count);
+    std::uniform_real_distribution<float> distPosition(0.0f, side);
+    std::uniform_real_distribution<float> distVelocity(-1.0f, 1.0f);
+    std::vector<Vector3> positions(count);
+    std::vector<Vector3> velocities(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        positions[i] = {distPosition(randomEngine), distPosition(randomEngine), distPosition(randomEngine)};
+        velocities[i] = {distVelocity(randomEngine), distVelocity(randomEngine), distVelocity(randomEngine)};
+    }
+    std::vector<Vector3> forces(count);
+
+    ParticleNeighborGrid grid;
+    BenchmarkResult result;
+    result.particleCount = count;
+    frames = std::max(frames, 1u);
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        auto start = std::chrono::steady_clock::now();
+        grid.Build(positions, setting.radius);
+        auto built = std::chrono::steady_clock::now();
+        grid.SolveSeparation(setting, positions, velocities, forces);
+        auto end = std::chrono::steady_clock::now();
+        result.buildMicroseconds += std::chrono::duration<double, std::micro>(built - start).count();
+        result.solveMicroseconds += std::chrono::duration<double, std::micro>(end - built).count();
+    }
+    result.buildMicroseconds /= frames;
+    result.solveMicroseconds /= frames;
+
+    uint64_t neighborTotal = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        grid.ForEachNeighbor(positions[i], [&](uint32_t, const Vector3 &, float) {
+            ++neighborTotal;
+            return true;
+        });
+    }
+    result.averageNeighbors = count > 0 ? static_cast<double>(neighborTotal) / count - 1.0 : 0.0;
+
+    Log("ParticleNeighborGrid: particles=" + std::to_string(count) + " build=" + std::to_string(result.buildMicroseconds) +
+        "us solve=" + std::to_string(result.solveMicroseconds) + "us neighbors=" + std::to_string(result.averageNeighbors) + "\n");
+    return result;
+}
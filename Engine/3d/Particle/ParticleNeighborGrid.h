@@ -0,0 +1,135 @@
+#pragma once
+#include "externals/nlohmann/json.hpp"
+#include "type/Vector3.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// 近傍のパーティクルを見て決める振る舞い
+enum class NeighborMode : int32_t {
+    None,       // 近傍を見ない(空間ハッシュも作らない)
+    Separation, // 近すぎる相手から離れる
+    Flock,      // 分離・整列・結合(群れ)
+    Fluid,      // 密度から圧力を求める簡易SPH(煙・水しぶき)
+};
+
+// 近傍の振る舞いの設定
+struct ParticleNeighborSetting {
+    NeighborMode mode = NeighborMode::None;
+    float radius = 0.5f;           // 近傍とみなす距離(ハッシュのセルの大きさ)
+    uint32_t maxNeighbors = 32;    // 1粒子あたりに見る近傍の上限
+    float separationWeight = 1.0f; // 分離
+    float alignmentWeight = 0.5f;  // 整列(Flock)
+    float cohesionWeight = 0.3f;   // 結合(Flock)
+    float stiffness = 1.0f;        // 圧力の強さ(Fluid)
+    float restDensity = 2.0f;      // 基準の密度(Fluid)
+    float viscosity = 0.1f;        // 粘性(Fluid)
+};
+
+void to_json(nlohmann::json &j, const ParticleNeighborSetting &setting);
+void from_json(const nlohmann::json &j, ParticleNeighborSetting &setting);
+
+/// <summary>
+/// 毎フレーム作り直す空間ハッシュ(カウンティングソートで平坦な配列に並べる)
+/// 近傍の力の計算はThreadPoolでチャンクごとに並列に行う
+/// </summary>
+class ParticleNeighborGrid {
+  public:
+    // ベンチマーク結果
+    struct BenchmarkResult {
+        uint32_t particleCount = 0;
+        double buildMicroseconds = 0.0; // ハッシュの構築
+        double solveMicroseconds = 0.0; // 近傍の力の計算
+        double averageNeighbors = 0.0;  // 1粒子あたりの近傍数
+    };
+
+  public:
+    /// <summary>
+    /// 位置をセルに振り分ける
+    /// </summary>
+    void Build(const std::vector<Vector3> &positions, float cellSize);
+
+    /// <summary>
+    /// 構築と近傍の力の計算をまとめて行う(forcesは加速度としてpositionsと同じ並びで返す)
+    /// </summary>
+    void Solve(const ParticleNeighborSetting &setting, const std::vector<Vector3> &positions,
+               const std::vector<Vector3> &velocities, std::vector<Vector3> &forces);
+
+    /// <summary>
+    /// 半径内の近傍を列挙する(自分自身も含む)
+    /// function(粒子番号, 自分からの相対位置, 距離の2乗)がfalseを返したら打ち切り
+    /// </summary>
+    template <typename Function>
+    void ForEachNeighbor(const Vector3 &position, Function function) const;
+
+    /// <summary>
+    /// 一様な密度でcount個を並べ、Flockの1フレーム分をframes回計測する
+    /// </summary>
+    static BenchmarkResult Benchmark(uint32_t count, uint32_t frames = 10);
+
+  private:
+    uint32_t HashCell(int32_t x, int32_t y, int32_t z) const {
+        // 大きな素数を掛けてXOR(Teschner et al.)
+        uint32_t hash = (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u) ^
+                        (static_cast<uint32_t>(z) * 83492791u);
+        return hash & tableMask_;
+    }
+    int32_t CellCoord(float value) const { return static_cast<int32_t>(std::floor(value * inverseCellSize_)); }
+
+    void SolveSeparation(const ParticleNeighborSetting &setting, const std::vector<Vector3> &positions,
+                         const std::vector<Vector3> &velocities, std::vector<Vector3> &forces);
+    void SolveFluid(const ParticleNeighborSetting &setting, const std::vector<Vector3> &positions,
+                    const std::vector<Vector3> &velocities, std::vector<Vector3> &forces);
+
+  private:
+    static constexpr uint32_t kGrainSize = 512; // 並列化の1チャンクの粒子数
+
+    float cellSize_ = 1.0f;
+    float inverseCellSize_ = 1.0f;
+    uint32_t tableMask_ = 0;
+    std::vector<uint32_t> cellStart_;         // バケットごとの開始位置(要素数はテーブルサイズ+1)
+    std::vector<uint32_t> particleBuckets_;   // 粒子ごとのバケット
+    std::vector<uint32_t> sortedIndices_;     // バケット順に並べた粒子番号
+    std::vector<Vector3> sortedPositions_;    // sortedIndices_の順の位置(近傍走査を連続アクセスにする)
+    std::vector<float> densities_;            // Fluidの密度
+};
+
+template <typename Function>
+void ParticleNeighborGrid::ForEachNeighbor(const Vector3 &position, Function function) const {
+    const float radiusSquared = cellSize_ * cellSize_;
+    const int32_t cx = CellCoord(position.x);
+    const int32_t cy = CellCoord(position.y);
+    const int32_t cz = CellCoord(position.z);
+
+    // 別のセルが同じバケットになった場合に2回数えないよう、見たバケットを覚える
+    uint32_t visited[27];
+    uint32_t visitedCount = 0;
+    for (int32_t z = cz - 1; z <= cz + 1; ++z) {
+        for (int32_t y = cy - 1; y <= cy + 1; ++y) {
+            for (int32_t x = cx - 1; x <= cx + 1; ++x) {
+                uint32_t bucket = HashCell(x, y, z);
+                bool isVisited = false;
+                for (uint32_t i = 0; i < visitedCount; ++i) {
+                    if (visited[i] == bucket) {
+                        isVisited = true;
+                        break;
+                    }
+                }
+                if (isVisited) {
+                    continue;
+                }
+                visited[visitedCount++] = bucket;
+
+                for (uint32_t slot = cellStart_[bucket]; slot < cellStart_[bucket + 1]; ++slot) {
+                    Vector3 offset = sortedPositions_[slot] - position;
+                    float distanceSquared = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+                    if (distanceSquared <= radiusSquared) {
+                        if (!function(sortedIndices_[slot], offset, distanceSquared)) {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
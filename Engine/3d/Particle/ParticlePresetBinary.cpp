@@ -0,0 +1,259 @@
+#include "ParticlePresetBinary.h"
+#include "Log/Logger.h"
+#include "ParticleEffectLibrary.h"
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace Logger;
+namespace fs = std::filesystem;
+
+const std::string ParticlePresetBinary::kDirectoryPath = "resources/jsons/ParticleCompiled/";
+const std::string ParticlePresetBinary::kSourceDirectoryPath = "resources/jsons/Particle/";
+
+namespace {
+uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// 固定長の文字列に収まらないものはコンパイルしない
+bool CopyName(char *dest, size_t size, const std::string &src) {
+    if (src.size() >= size) {
+        return false;
+    }
+    std::memset(dest, 0, size);
+    std::memcpy(dest, src.data(), src.size());
+    return true;
+}
+
+std::string ToString(const char *src, size_t size) {
+    return std::string(src, strnlen(src, size));
+}
+
+// FNV-1aで値を混ぜる
+constexpr uint32_t HashCombine(uint32_t hash, size_t value) {
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        hash ^= static_cast<uint32_t>((value >> (i * 8)) & 0xff);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 各メンバの位置と大きさを混ぜる(サイズが同じでも並びや型が変われば別の値になる)
+#define PFXB_MEMBER(type, member) \
+    hash = HashCombine(hash, offsetof(type, member)); \
+    hash = HashCombine(hash, sizeof(type::member))
+
+uint32_t ComputeLayoutHash() {
+    uint32_t hash = 2166136261u;
+    hash = HashCombine(hash, sizeof(ParticleSetting));
+    hash = HashCombine(hash, sizeof(ParticleNeighborSetting));
+    hash = HashCombine(hash, sizeof(ParticleCollisionSetting));
+    hash = HashCombine(hash, sizeof(ParticleCurve));
+
+    PFXB_MEMBER(ParticleSetting, translate);
+    PFXB_MEMBER(ParticleSetting, rotation);
+    PFXB_MEMBER(ParticleSetting, scale);
+    PFXB_MEMBER(ParticleSetting, startColor);
+    PFXB_MEMBER(ParticleSetting, endColor);
+    PFXB_MEMBER(ParticleSetting, count);
+    PFXB_MEMBER(ParticleSetting, velocityMin);
+    PFXB_MEMBER(ParticleSetting, velocityMax);
+    PFXB_MEMBER(ParticleSetting, lifeTimeMin);
+    PFXB_MEMBER(ParticleSetting, lifeTimeMax);
+    PFXB_MEMBER(ParticleSetting, gravity);
+    PFXB_MEMBER(ParticleSetting, particleStartScale);
+    PFXB_MEMBER(ParticleSetting, particleEndScale);
+    PFXB_MEMBER(ParticleSetting, startAcce);
+    PFXB_MEMBER(ParticleSetting, endAcce);
+    PFXB_MEMBER(ParticleSetting, startRote);
+    PFXB_MEMBER(ParticleSetting, endRote);
+    PFXB_MEMBER(ParticleSetting, isRandomColor);
+    PFXB_MEMBER(ParticleSetting, alphaMin);
+    PFXB_MEMBER(ParticleSetting, alphaMax);
+    PFXB_MEMBER(ParticleSetting, rotateVelocityMin);
+    PFXB_MEMBER(ParticleSetting, rotateVelocityMax);
+    PFXB_MEMBER(ParticleSetting, allScaleMax);
+    PFXB_MEMBER(ParticleSetting, allScaleMin);
+    PFXB_MEMBER(ParticleSetting, scaleMin);
+    PFXB_MEMBER(ParticleSetting, scaleMax);
+    PFXB_MEMBER(ParticleSetting, rotateStartMax);
+    PFXB_MEMBER(ParticleSetting, rotateStartMin);
+    PFXB_MEMBER(ParticleSetting, isBillboard);
+    PFXB_MEMBER(ParticleSetting, isRandomRotate);
+    PFXB_MEMBER(ParticleSetting, isRotateVelocity);
+    PFXB_MEMBER(ParticleSetting, isAcceMultiply);
+    PFXB_MEMBER(ParticleSetting, isRandomSize);
+    PFXB_MEMBER(ParticleSetting, isRandomAllSize);
+    PFXB_MEMBER(ParticleSetting, isSinMove);
+    PFXB_MEMBER(ParticleSetting, isFaceDirection);
+    PFXB_MEMBER(ParticleSetting, isEndScale);
+    PFXB_MEMBER(ParticleSetting, isEmitOnEdge);
+    PFXB_MEMBER(ParticleSetting, emitShape);
+    PFXB_MEMBER(ParticleSetting, isEmitOnShell);
+    PFXB_MEMBER(ParticleSetting, coneAngle);
+    PFXB_MEMBER(ParticleSetting, ringInnerRatio);
+    PFXB_MEMBER(ParticleSetting, shapeNormalSpeed);
+    PFXB_MEMBER(ParticleSetting, forceFieldScale);
+    PFXB_MEMBER(ParticleSetting, neighbor);
+    PFXB_MEMBER(ParticleSetting, collision);
+    PFXB_MEMBER(ParticleSetting, isGatherMode);
+    PFXB_MEMBER(ParticleSetting, gatherStartRatio);
+    PFXB_MEMBER(ParticleSetting, gatherStrength);
+    PFXB_MEMBER(ParticleSetting, enableTrail);
+    PFXB_MEMBER(ParticleSetting, trailSpawnInterval);
+    PFXB_MEMBER(ParticleSetting, maxTrailParticles);
+    PFXB_MEMBER(ParticleSetting, trailLifeScale);
+    PFXB_MEMBER(ParticleSetting, trailScaleMultiplier);
+    PFXB_MEMBER(ParticleSetting, trailColorMultiplier);
+    PFXB_MEMBER(ParticleSetting, trailInheritVelocity);
+    PFXB_MEMBER(ParticleSetting, trailVelocityScale);
+    PFXB_MEMBER(ParticleSetting, colorCurve);
+    PFXB_MEMBER(ParticleSetting, scaleCurve);
+    PFXB_MEMBER(ParticleSetting, acceCurve);
+
+    PFXB_MEMBER(ParticleNeighborSetting, mode);
+    PFXB_MEMBER(ParticleNeighborSetting, radius);
+    PFXB_MEMBER(ParticleNeighborSetting, maxNeighbors);
+    PFXB_MEMBER(ParticleNeighborSetting, separationWeight);
+    PFXB_MEMBER(ParticleNeighborSetting, alignmentWeight);
+    PFXB_MEMBER(ParticleNeighborSetting, cohesionWeight);
+    PFXB_MEMBER(ParticleNeighborSetting, stiffness);
+    PFXB_MEMBER(ParticleNeighborSetting, restDensity);
+    PFXB_MEMBER(ParticleNeighborSetting, viscosity);
+
+    PFXB_MEMBER(ParticleCollisionSetting, response);
+    PFXB_MEMBER(ParticleCollisionSetting, isCollideScene);
+    PFXB_MEMBER(ParticleCollisionSetting, radius);
+    PFXB_MEMBER(ParticleCollisionSetting, restitution);
+    PFXB_MEMBER(ParticleCollisionSetting, friction);
+    PFXB_MEMBER(ParticleCollisionSetting, planeCount);
+    PFXB_MEMBER(ParticleCollisionSetting, planes);
+
+    PFXB_MEMBER(ParticleCurve, isEnabled);
+    PFXB_MEMBER(ParticleCurve, keyCount);
+    PFXB_MEMBER(ParticleCurve, keys);
+    PFXB_MEMBER(ParticleCurve, lut);
+    return hash;
+}
+
+#undef PFXB_MEMBER
+} // namespace
+
+uint32_t ParticlePresetBinary::GetLayoutHash() {
+    static const uint32_t hash = ComputeLayoutHash();
+    return hash;
+}
+
+bool ParticlePresetBinary::Write(const ParticleEffectTemplate &effect) {
+    const uint32_t groupCount = static_cast<uint32_t>(effect.groupNames.size());
+
+    Header header{};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.settingSize = sizeof(ParticleSetting);
+    header.layoutHash = GetLayoutHash();
+    header.groupCount = groupCount;
+    header.settingOffset = AlignUp(static_cast<uint32_t>(sizeof(Header) + sizeof(GroupEntry) * groupCount), alignof(ParticleSetting));
+    header.flags = (effect.isVisible ? 1u : 0u) | (effect.isActive ? 2u : 0u) | (effect.isAuto ? 4u : 0u);
+    header.translation = effect.translation;
+    header.rotation = effect.rotation;
+    header.scale = effect.scale;
+    header.emitFrequency = effect.emitFrequency;
+    header.prewarmTime = effect.prewarmTime;
+    header.maxLifeTime = effect.maxLifeTime;
+
+    std::vector<char> buffer(header.settingOffset + sizeof(ParticleSetting) * groupCount, 0);
+    std::memcpy(buffer.data(), &header, sizeof(Header));
+    GroupEntry *entries = reinterpret_cast<GroupEntry *>(buffer.data() + sizeof(Header));
+    for (uint32_t i = 0; i < groupCount; ++i) {
+        if (!CopyName(entries[i].name, kNameLength, effect.groupNames[i]) ||
+            !CopyName(entries[i].emitModel, kPathLength, effect.emitModels[i]) ||
+            !CopyName(entries[i].forceField, kNameLength, effect.forceFields[i])) {
+            Log("ParticlePresetBinary: name too long in " + effect.name + ", not compiled\n");
+            return false;
+        }
+    }
+    if (groupCount > 0) {
+        std::memcpy(buffer.data() + header.settingOffset, effect.settings.data(), sizeof(ParticleSetting) * groupCount);
+    }
+
+    fs::create_directories(kDirectoryPath);
+    std::ofstream file(GetFilePath(effect.name), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        Log("ParticlePresetBinary: failed to write " + GetFilePath(effect.name) + "\n");
+        return false;
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
+
+bool ParticlePresetBinary::Read(const std::string &name, ParticleEffectTemplate &effect) {
+    std::ifstream file(GetFilePath(name), std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    // ファイル全体を1回で読む
+    const std::streamsize size = file.tellg();
+    if (size < static_cast<std::streamsize>(sizeof(Header))) {
+        return false;
+    }
+    std::vector<char> buffer(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(buffer.data(), size)) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, buffer.data(), sizeof(Header));
+    if (header.magic != kMagic || header.version != kVersion || header.settingSize != sizeof(ParticleSetting) ||
+        header.layoutHash != GetLayoutHash()) {
+        Log("ParticlePresetBinary: " + name + " is outdated, recompiling\n");
+        return false;
+    }
+    const size_t expected = static_cast<size_t>(header.settingOffset) + sizeof(ParticleSetting) * header.groupCount;
+    if (header.settingOffset < sizeof(Header) + sizeof(GroupEntry) * header.groupCount || buffer.size() < expected) {
+        return false;
+    }
+
+    effect.name = name;
+    effect.translation = header.translation;
+    effect.rotation = header.rotation;
+    effect.scale = header.scale;
+    effect.emitFrequency = header.emitFrequency;
+    effect.prewarmTime = header.prewarmTime;
+    effect.maxLifeTime = header.maxLifeTime;
+    effect.isVisible = (header.flags & 1u) != 0;
+    effect.isActive = (header.flags & 2u) != 0;
+    effect.isAuto = (header.flags & 4u) != 0;
+
+    effect.groupNames.resize(header.groupCount);
+    effect.emitModels.resize(header.groupCount);
+    effect.forceFields.resize(header.groupCount);
+    const GroupEntry *entries = reinterpret_cast<const GroupEntry *>(buffer.data() + sizeof(Header));
+    for (uint32_t i = 0; i < header.groupCount; ++i) {
+        effect.groupNames[i] = ToString(entries[i].name, kNameLength);
+        effect.emitModels[i] = ToString(entries[i].emitModel, kPathLength);
+        effect.forceFields[i] = ToString(entries[i].forceField, kNameLength);
+    }
+    effect.settings.resize(header.groupCount);
+    if (header.groupCount > 0) {
+        std::memcpy(effect.settings.data(), buffer.data() + header.settingOffset, sizeof(ParticleSetting) * header.groupCount);
+    }
+    return true;
+}
+
+bool ParticlePresetBinary::IsUpToDate(const std::string &name) {
+    std::error_code error;
+    const fs::path binaryPath = GetFilePath(name);
+    if (!fs::exists(binaryPath, error)) {
+        return false;
+    }
+    const fs::path sourcePath = kSourceDirectoryPath + name + ".json";
+    if (!fs::exists(sourcePath, error)) {
+        return true;
+    }
+    return fs::last_write_time(binaryPath, error) >= fs::last_write_time(sourcePath, error);
+}
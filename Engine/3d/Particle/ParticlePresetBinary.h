@@ -0,0 +1,70 @@
+#pragma once
+#include "ParticleManager.h"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+struct ParticleEffectTemplate;
+
+// バイナリにそのまま書き出すため、設定はmemcpyできる型に保つ
+static_assert(std::is_trivially_copyable_v<ParticleSetting>, "ParticleSetting must stay trivially copyable");
+
+/// <summary>
+/// エフェクト定義をコンパイルしたバイナリ(エディタのJSONから生成)
+/// [Header][GroupEntry x groupCount][ParticleSetting x groupCount] の並びで、
+/// 設定は1回の読み込みからそのままParticleSettingの配列へコピーする(カーブは焼き込み済み)
+/// </summary>
+class ParticlePresetBinary {
+  public:
+    static constexpr uint32_t kMagic = 0x42584650; // "PFXB"
+    static constexpr uint32_t kVersion = 2;
+    static constexpr size_t kNameLength = 64;
+    static constexpr size_t kPathLength = 128;
+    static const std::string kDirectoryPath;
+    static const std::string kSourceDirectoryPath;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t settingSize; // sizeof(ParticleSetting)が変わったら読み直す
+        uint32_t layoutHash;  // メンバの並び(offsetof)のハッシュ。並べ替えや型の変更でも読み直す
+        uint32_t groupCount;
+        uint32_t settingOffset; // ファイル先頭からParticleSettingの配列までのバイト数
+        uint32_t flags;         // bit0:isVisible bit1:isActive bit2:isAuto
+        Vector3 translation;
+        Vector3 rotation;
+        Vector3 scale;
+        float emitFrequency;
+        float prewarmTime;
+        float maxLifeTime;
+    };
+
+    struct GroupEntry {
+        char name[kNameLength];
+        char emitModel[kPathLength];
+        char forceField[kNameLength];
+    };
+
+  public:
+    /// <summary>
+    /// テンプレートをバイナリに書き出す
+    /// </summary>
+    static bool Write(const ParticleEffectTemplate &effect);
+
+    /// <summary>
+    /// バイナリからテンプレートを読む(形式・バージョンが合わなければfalse)
+    /// </summary>
+    static bool Read(const std::string &name, ParticleEffectTemplate &effect);
+
+    /// <summary>
+    /// バイナリがJSONより新しいか(JSONが無くバイナリだけある場合もtrue)
+    /// </summary>
+    static bool IsUpToDate(const std::string &name);
+
+    /// <summary>
+    /// ParticleSettingのメンバ配置から求めるハッシュ
+    /// </summary>
+    static uint32_t GetLayoutHash();
+
+    static std::string GetFilePath(const std::string &name) { return kDirectoryPath + name + ".pfx"; }
+};
@@ -0,0 +1,230 @@
+#include "ParticleRecorder.h"
+#include "Data/DataHandler.h"
+#include "Log/Logger.h"
+#include "ParticleEmitter.h"
+#include "ParticleEmitterManager.h"
+#include <algorithm>
+#include <chrono>
+#include <myMath.h>
+
+using namespace Logger;
+
+namespace {
+json ToJson(const Matrix4x4 &matrix) {
+    json values = json::array();
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            values.push_back(matrix.m[row][column]);
+        }
+    }
+    return values;
+}
+
+Matrix4x4 MatrixFromJson(const json &values) {
+    Matrix4x4 matrix = MakeIdentity4x4();
+    for (int index = 0; index < 16 && index < static_cast<int>(values.size()); ++index) {
+        matrix.m[index / 4][index % 4] = values[index].get<float>();
+    }
+    return matrix;
+}
+} // namespace
+
+const std::string ParticleRecorder::kDirectoryPath = "resources/jsons/ParticleRecord/";
+
+void ParticleRecorder::Start(const std::string &name, uint32_t seed) {
+    ParticleEmitterManager *emitterManager = ParticleEmitterManager::GetInstance();
+    name_ = name;
+    seed_ = seed;
+    frames_.clear();
+    cameras_.clear();
+    events_.clear();
+    initialEmitters_.clear();
+    lastTranslations_.clear();
+
+    // 記録開始時の状態をそろえる
+    emitterManager->ResetAccumulator();
+    for (ParticleEmitter *emitter : emitterManager->GetEmitters()) {
+        emitter->Reset();
+        emitter->SetSeed(MakeEmitterSeed(seed_, emitter->GetName()));
+        initialEmitters_.emplace_back(emitter->GetName(), emitter->GetTranslation());
+        lastTranslations_.push_back(emitter->GetTranslation());
+    }
+    isRecording_ = true;
+}
+
+void ParticleRecorder::Stop() {
+    if (!isRecording_) {
+        return;
+    }
+    isRecording_ = false;
+
+    ParticleEmitterManager *emitterManager = ParticleEmitterManager::GetInstance();
+    json root;
+    root["seed"] = seed_;
+    root["isFixedStep"] = emitterManager->IsFixedStep();
+    root["fixedDeltaTime"] = emitterManager->GetFixedDeltaTime();
+    root["isReducedRate"] = emitterManager->IsReducedRateEnabled();
+    root["reducedRateDistance"] = emitterManager->GetReducedRateDistance();
+    root["reducedRateInterval"] = emitterManager->GetReducedRateInterval();
+    root["frames"] = frames_;
+    root["cameras"] = json::array();
+    for (const Camera &camera : cameras_) {
+        root["cameras"].push_back({{"view", ToJson(camera.view)},
+                                   {"fovAngleY", camera.fovAngleY},
+                                   {"aspectRatio", camera.aspectRatio},
+                                   {"nearZ", camera.nearZ},
+                                   {"farZ", camera.farZ}});
+    }
+    root["emitters"] = json::array();
+    for (const auto &[emitterName, translation] : initialEmitters_) {
+        root["emitters"].push_back({{"name", emitterName}, {"translation", translation}});
+    }
+    root["events"] = json::array();
+    for (const Event &event : events_) {
+        root["events"].push_back(
+            {{"frame", event.frame}, {"emitter", event.emitterName}, {"translation", event.translation}, {"burst", event.isBurst}});
+    }
+
+    fs::create_directories(kDirectoryPath);
+    std::ofstream file(kDirectoryPath + name_ + ".json");
+    if (!file.is_open()) {
+        Log("ParticleRecorder: failed to write " + name_ + "\n");
+        return;
+    }
+    file << root.dump(4);
+}
+
+void ParticleRecorder::RecordFrame(float deltaTime, const ViewProjection &viewProjection) {
+    if (!isRecording_) {
+        return;
+    }
+    // このフレームの更新で動いたエミッターの位置(発生より前に反映する)
+    ParticleEmitterManager *emitterManager = ParticleEmitterManager::GetInstance();
+    const uint32_t frame = static_cast<uint32_t>(frames_.size());
+    for (size_t i = 0; i < initialEmitters_.size(); ++i) {
+        const ParticleEmitter *emitter = emitterManager->FindEmitter(initialEmitters_[i].first);
+        if (emitter && emitter->GetTranslation() != lastTranslations_[i]) {
+            lastTranslations_[i] = emitter->GetTranslation();
+            events_.push_back({frame, initialEmitters_[i].first, lastTranslations_[i], false});
+        }
+    }
+    frames_.push_back(deltaTime);
+    cameras_.push_back({viewProjection.matView_, viewProjection.fovAngleY, viewProjection.aspectRatio, viewProjection.nearZ, viewProjection.farZ});
+}
+
+void ParticleRecorder::RecordBurst(const ParticleEmitter &emitter) {
+    if (isRecording_) {
+        events_.push_back({static_cast<uint32_t>(frames_.size()), emitter.GetName(), emitter.GetTranslation()});
+    }
+}
+
+bool ParticleRecorder::Replay(const std::string &name, ReplayResult &result) {
+    std::ifstream file(kDirectoryPath + name + ".json");
+    if (!file.is_open()) {
+        Log("ParticleRecorder: record not found " + name + "\n");
+        return false;
+    }
+    json root;
+    file >> root;
+
+    ParticleEmitterManager *emitterManager = ParticleEmitterManager::GetInstance();
+    uint32_t seed = root.value("seed", 0u);
+    std::vector<float> frames = root["frames"].get<std::vector<float>>();
+    const json &cameras = root.contains("cameras") ? root["cameras"] : json::array();
+    const json &events = root["events"];
+
+    // 記録時の設定で再生し、終わったら戻す(カメラの無い古い記録は間引きなし)
+    const bool isFixedStep = emitterManager->IsFixedStep();
+    const float fixedDeltaTime = emitterManager->GetFixedDeltaTime();
+    const bool isReducedRate = emitterManager->IsReducedRateEnabled();
+    const float reducedRateDistance = emitterManager->GetReducedRateDistance();
+    const uint32_t reducedRateInterval = emitterManager->GetReducedRateInterval();
+    emitterManager->SetFixedStep(root.value("isFixedStep", false), root.value("fixedDeltaTime", 1.0f / 60.0f));
+    emitterManager->SetReducedRate(root.value("isReducedRate", false) && cameras.size() == frames.size(),
+                                   root.value("reducedRateDistance", reducedRateDistance), root.value("reducedRateInterval", reducedRateInterval));
+    emitterManager->ResetAccumulator();
+
+    // 記録開始時の状態を復元
+    for (const auto &entry : root["emitters"]) {
+        std::string emitterName = entry.at("name").get<std::string>();
+        ParticleEmitter *emitter = emitterManager->FindEmitter(emitterName);
+        if (!emitter) {
+            Log("ParticleRecorder: emitter not found " + emitterName + "\n");
+            continue;
+        }
+        emitter->Reset();
+        emitter->SetSeed(MakeEmitterSeed(seed, emitterName));
+        emitter->SetTranslation(entry.at("translation").get<Vector3>());
+    }
+
+    size_t eventIndex = 0;
+    ViewProjection camera;
+
+    fs::create_directories(kDirectoryPath);
+    std::ofstream csv(kDirectoryPath + name + "_replay.csv");
+    csv << "frame,deltaTime,simulateMicroseconds,particleCount\n";
+
+    result = ReplayResult{};
+    double totalMicroseconds = 0.0;
+    for (uint32_t frame = 0; frame < frames.size(); ++frame) {
+        // このフレームのトリガーを適用
+        while (eventIndex < events.size() && events[eventIndex].at("frame").get<uint32_t>() == frame) {
+            const json &event = events[eventIndex];
+            if (ParticleEmitter *emitter = emitterManager->FindEmitter(event.at("emitter").get<std::string>())) {
+                emitter->SetTranslation(event.at("translation").get<Vector3>());
+                if (event.value("burst", true)) {
+                    emitter->UpdateOnce();
+                }
+            }
+            ++eventIndex;
+        }
+
+        if (frame < cameras.size()) {
+            const json &entry = cameras[frame];
+            camera.matView_ = MatrixFromJson(entry.at("view"));
+            camera.fovAngleY = entry.value("fovAngleY", camera.fovAngleY);
+            camera.aspectRatio = entry.value("aspectRatio", camera.aspectRatio);
+            camera.nearZ = entry.value("nearZ", camera.nearZ);
+            camera.farZ = entry.value("farZ", camera.farZ);
+        }
+
+        // 実行時と同じ間引き・サブステップの経路で進める
+        auto start = std::chrono::steady_clock::now();
+        emitterManager->Simulate(frames[frame], camera);
+        auto end = std::chrono::steady_clock::now();
+        double microseconds = std::chrono::duration<double, std::micro>(end - start).count();
+
+        size_t particleCount = 0;
+        for (ParticleEmitter *emitter : emitterManager->GetEmitters()) {
+            particleCount += emitter->GetParticleCount();
+        }
+        csv << frame << "," << frames[frame] << "," << microseconds << "," << particleCount << "\n";
+
+        totalMicroseconds += microseconds;
+        result.maxMicroseconds = std::max(result.maxMicroseconds, microseconds);
+        result.maxParticleCount = std::max(result.maxParticleCount, particleCount);
+    }
+    emitterManager->SetFixedStep(isFixedStep, fixedDeltaTime);
+    emitterManager->SetReducedRate(isReducedRate, reducedRateDistance, reducedRateInterval);
+    emitterManager->ResetAccumulator();
+
+    result.frameCount = static_cast<uint32_t>(frames.size());
+    if (result.frameCount > 0) {
+        result.averageMicroseconds = totalMicroseconds / result.frameCount;
+    }
+
+    Log("ParticleRecorder: " + name + " frames=" + std::to_string(result.frameCount) +
+        " avg=" + std::to_string(result.averageMicroseconds) + "us max=" + std::to_string(result.maxMicroseconds) +
+        "us particles=" + std::to_string(result.maxParticleCount) + "\n");
+    return true;
+}
+
+uint32_t ParticleRecorder::MakeEmitterSeed(uint32_t seed, const std::string &emitterName) {
+    // 実装依存のstd::hashは使わず、ビルド間で同じ値になるFNV-1a
+    uint32_t hash = 2166136261u;
+    for (char c : emitterName) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash ^ seed;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "type/Matrix4x4.h"
+#include "type/Vector3.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ParticleEmitter;
+class ViewProjection;
+
+/// <summary>
+/// エミッターのトリガー記録と、記録を使った再生ベンチマーク
+/// 記録ファイルは resources/jsons/ParticleRecord/<name>.json
+/// </summary>
+class ParticleRecorder {
+  public:
+    // エミッターへのトリガー(isBurstがfalseなら移動だけ)
+    struct Event {
+        uint32_t frame;
+        std::string emitterName;
+        Vector3 translation;
+        bool isBurst = true;
+    };
+
+    // フレームごとのカメラ(間引きの判定を再現する)
+    struct Camera {
+        Matrix4x4 view;
+        float fovAngleY;
+        float aspectRatio;
+        float nearZ;
+        float farZ;
+    };
+
+    // 再生結果
+    struct ReplayResult {
+        uint32_t frameCount = 0;
+        double averageMicroseconds = 0.0;
+        double maxMicroseconds = 0.0;
+        size_t maxParticleCount = 0;
+    };
+
+  public:
+    /// <summary>
+    /// 記録開始(登録済みエミッターをリセットしてシードを配る)
+    /// </summary>
+    void Start(const std::string &name, uint32_t seed);
+
+    /// <summary>
+    /// 記録終了してファイルに書き出す
+    /// </summary>
+    void Stop();
+
+    bool IsRecording() const { return isRecording_; }
+
+    /// <summary>
+    /// 1フレーム分の記録(時間・カメラ・動いたエミッターの位置)
+    /// </summary>
+    void RecordFrame(float deltaTime, const ViewProjection &viewProjection);
+    void RecordBurst(const ParticleEmitter &emitter);
+
+    /// <summary>
+    /// 記録を再生し、フレームごとのシミュレーション時間をCSVに書き出す(描画はしない)
+    /// 固定ステップ・間引きの設定は記録時のものを使い、終わったら元に戻す
+    /// </summary>
+    static bool Replay(const std::string &name, ReplayResult &result);
+
+    /// <summary>
+    /// エミッター名とベースシードからエミッターごとのシードを求める
+    /// </summary>
+    static uint32_t MakeEmitterSeed(uint32_t seed, const std::string &emitterName);
+
+  private:
+    static const std::string kDirectoryPath;
+
+    bool isRecording_ = false;
+    std::string name_;
+    uint32_t seed_ = 0;
+    std::vector<float> frames_;
+    std::vector<Camera> cameras_; // frames_と同じ並び
+    std::vector<Event> events_;
+    std::vector<std::pair<std::string, Vector3>> initialEmitters_;
+    std::vector<Vector3> lastTranslations_; // initialEmitters_と同じ並び(移動の検出用)
+};
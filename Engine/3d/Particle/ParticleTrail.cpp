@@ -0,0 +1,227 @@
+#include "ParticleTrail.h"
+#include "ParticleCommon.h"
+#include "Srv/SrvManager.h"
+#include <algorithm>
+
+void ParticleTrail::Initialize(bool isHeadless) {
+    isHeadless_ = isHeadless;
+    segmentCount_ = 0;
+    if (isHeadless_) {
+        cpuInstances_.resize(kNumMaxSegment);
+        instancingData_ = cpuInstances_.data();
+        return;
+    }
+    CreateVertexData();
+
+    instancingResource_ = ParticleCommon::GetInstance()->GetDxCommon()->CreateBufferResource(sizeof(ParticleForGPU) * kNumMaxSegment);
+    instancingSRVIndex_ = SrvManager::GetInstance()->Allocate() + 1;
+    instancingResource_->Map(0, nullptr, reinterpret_cast<void **>(&instancingData_));
+    SrvManager::GetInstance()->CreateSRVforStructuredBuffer(instancingSRVIndex_, instancingResource_.Get(), kNumMaxSegment, sizeof(ParticleForGPU));
+    segmentCount_ = 0;
+}
+
+bool ParticleTrail::Reserve(uint32_t pointsPerTrail) {
+    pointsPerTrail = std::clamp(pointsPerTrail, 2u, kNumMaxPointsPerTrail);
+    if (pointsPerTrail == pointsPerTrail_) {
+        return false;
+    }
+    pointsPerTrail_ = pointsPerTrail;
+
+    // セグメント上限に収まるだけのスロットを確保する
+    uint32_t slotCount = kNumMaxSegment / pointsPerTrail_;
+    points_.assign(static_cast<size_t>(slotCount) * pointsPerTrail_, TrailPoint{});
+    slots_.assign(slotCount, TrailSlot{});
+    freeSlots_.clear();
+    freeSlots_.reserve(slotCount);
+    // 若い番号から取り出せるよう逆順に積む
+    for (uint32_t i = slotCount; i > 0; --i) {
+        freeSlots_.push_back(i - 1);
+    }
+    segmentCount_ = 0;
+    return true;
+}
+
+int32_t ParticleTrail::Acquire() {
+    if (freeSlots_.empty()) {
+        return kInvalidSlot;
+    }
+    uint32_t index = freeSlots_.back();
+    freeSlots_.pop_back();
+    slots_[index] = TrailSlot{};
+    slots_[index].inUse = true;
+    return static_cast<int32_t>(index);
+}
+
+void ParticleTrail::Release(int32_t slot) {
+    if (slot < 0 || static_cast<size_t>(slot) >= slots_.size()) {
+        return;
+    }
+    // 残っている点が消えるまでは描画を続ける
+    slots_[slot].orphan = true;
+}
+
+void ParticleTrail::Clear() {
+    for (uint32_t i = 0; i < slots_.size(); ++i) {
+        if (slots_[i].inUse) {
+            slots_[i] = TrailSlot{};
+            freeSlots_.push_back(i);
+        }
+    }
+    segmentCount_ = 0;
+}
+
+void ParticleTrail::PushPoint(int32_t slot, const TrailPoint &point) {
+    if (slot < 0 || static_cast<size_t>(slot) >= slots_.size()) {
+        return;
+    }
+    TrailSlot &trail = slots_[slot];
+    trail.head = (trail.head + 1) % pointsPerTrail_;
+    points_[static_cast<size_t>(slot) * pointsPerTrail_ + trail.head] = point;
+    trail.count = std::min(trail.count + 1, pointsPerTrail_);
+}
+
+void ParticleTrail::SetHead(int32_t slot, const Vector3 &position, float width, const Vector4 &color) {
+    if (slot < 0 || static_cast<size_t>(slot) >= slots_.size()) {
+        return;
+    }
+    slots_[slot].headPosition = position;
+    slots_[slot].headWidth = width;
+    slots_[slot].headColor = color;
+}
+
+void ParticleTrail::Update(float deltaTime) {
+    for (uint32_t slotIndex = 0; slotIndex < slots_.size(); ++slotIndex) {
+        TrailSlot &trail = slots_[slotIndex];
+        if (!trail.inUse) {
+            continue;
+        }
+        TrailPoint *base = &points_[static_cast<size_t>(slotIndex) * pointsPerTrail_];
+
+        // 寿命と移動
+        for (uint32_t i = 0; i < trail.count; ++i) {
+            TrailPoint &point = base[(trail.head + pointsPerTrail_ - i) % pointsPerTrail_];
+            point.age += deltaTime;
+            point.position += point.velocity * deltaTime;
+        }
+        // 古い点から消す
+        while (trail.count > 0) {
+            const TrailPoint &oldest = base[(trail.head + pointsPerTrail_ - (trail.count - 1)) % pointsPerTrail_];
+            if (oldest.age < oldest.lifeTime) {
+                break;
+            }
+            --trail.count;
+        }
+        if (trail.orphan && trail.count == 0) {
+            trail = TrailSlot{};
+            freeSlots_.push_back(slotIndex);
+        }
+    }
+}
+
+void ParticleTrail::WriteInstances(const ViewProjection &viewProjection) {
+    segmentCount_ = 0;
+    if (slots_.empty()) {
+        return;
+    }
+
+    Matrix4x4 viewProjectionMatrix = viewProjection.matView_ * viewProjection.matProjection_;
+    Matrix4x4 cameraMatrix = Inverse(viewProjection.matView_);
+    Vector3 cameraPosition = {cameraMatrix.m[3][0], cameraMatrix.m[3][1], cameraMatrix.m[3][2]};
+
+    for (uint32_t slotIndex = 0; slotIndex < slots_.size(); ++slotIndex) {
+        const TrailSlot &trail = slots_[slotIndex];
+        if (!trail.inUse || trail.count == 0) {
+            continue;
+        }
+        const TrailPoint *base = &points_[static_cast<size_t>(slotIndex) * pointsPerTrail_];
+
+        // 先端(親の現在位置)から最新の点まで
+        const TrailPoint &newest = base[trail.head];
+        if (!trail.orphan) {
+            WriteSegment(trail.headPosition, newest.position, trail.headWidth, trail.headColor, cameraPosition, viewProjectionMatrix);
+        }
+        // 点同士をつなぐ
+        for (uint32_t i = 0; i + 1 < trail.count; ++i) {
+            const TrailPoint &start = base[(trail.head + pointsPerTrail_ - i) % pointsPerTrail_];
+            const TrailPoint &end = base[(trail.head + pointsPerTrail_ - i - 1) % pointsPerTrail_];
+            float fade = 1.0f - std::clamp(start.age / start.lifeTime, 0.0f, 1.0f);
+            Vector4 color = start.color;
+            color.w *= fade;
+            WriteSegment(start.position, end.position, start.width * fade, color, cameraPosition, viewProjectionMatrix);
+        }
+    }
+}
+
+void ParticleTrail::WriteSegment(const Vector3 &start, const Vector3 &end, float width, const Vector4 &color,
+                                 const Vector3 &cameraPosition, const Matrix4x4 &viewProjectionMatrix) {
+    if (segmentCount_ >= kNumMaxSegment) {
+        return;
+    }
+    Vector3 axisX = end - start;
+    Vector3 toCamera = cameraPosition - start;
+    // カメラに向けて帯を広げる
+    Vector3 side = axisX.Cross(toCamera).Normalize();
+    if (side.LengthSq() == 0.0f) {
+        return;
+    }
+    Vector3 axisY = side * width;
+    Vector3 axisZ = axisX.Cross(axisY).Normalize();
+
+    Matrix4x4 worldMatrix = MakeIdentity4x4();
+    worldMatrix.m[0][0] = axisX.x;
+    worldMatrix.m[0][1] = axisX.y;
+    worldMatrix.m[0][2] = axisX.z;
+    worldMatrix.m[1][0] = axisY.x;
+    worldMatrix.m[1][1] = axisY.y;
+    worldMatrix.m[1][2] = axisY.z;
+    worldMatrix.m[2][0] = axisZ.x;
+    worldMatrix.m[2][1] = axisZ.y;
+    worldMatrix.m[2][2] = axisZ.z;
+    worldMatrix.m[3][0] = start.x;
+    worldMatrix.m[3][1] = start.y;
+    worldMatrix.m[3][2] = start.z;
+
+    instancingData_[segmentCount_].WVP = worldMatrix * viewProjectionMatrix;
+    instancingData_[segmentCount_].World = worldMatrix;
+    instancingData_[segmentCount_].color = color;
+    ++segmentCount_;
+}
+
+void ParticleTrail::Draw(D3D12_GPU_VIRTUAL_ADDRESS materialAddress, uint32_t textureIndex) {
+    if (segmentCount_ == 0 || isHeadless_) {
+        return;
+    }
+    auto commandList = ParticleCommon::GetInstance()->GetDxCommon()->GetCommandList();
+    commandList->IASetIndexBuffer(&indexBufferView_);
+    commandList->IASetVertexBuffers(0, 1, &vertexBufferView_);
+    commandList->SetGraphicsRootConstantBufferView(0, materialAddress);
+    SrvManager::GetInstance()->SetGraphicsRootDescriptorTable(1, instancingSRVIndex_);
+    SrvManager::GetInstance()->SetGraphicsRootDescriptorTable(2, textureIndex);
+    commandList->DrawIndexedInstanced(6, segmentCount_, 0, 0, 0);
+}
+
+void ParticleTrail::CreateVertexData() {
+    // x:始点→終点(0～1), y:帯の幅(-0.5～0.5)
+    const VertexData vertices[] = {
+        {{0.0f, -0.5f, 0.0f, 1.0f}, {0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}},
+        {{1.0f, -0.5f, 0.0f, 1.0f}, {1.0f, 1.0f}, {0.0f, 0.0f, 1.0f}},
+        {{0.0f, 0.5f, 0.0f, 1.0f}, {0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+        {{1.0f, 0.5f, 0.0f, 1.0f}, {1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}};
+    const uint32_t indices[] = {0, 2, 1, 1, 2, 3};
+
+    VertexData *vertexData = nullptr;
+    vertexResource_ = ParticleCommon::GetInstance()->GetDxCommon()->CreateBufferResource(sizeof(vertices));
+    vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
+    vertexBufferView_.SizeInBytes = UINT(sizeof(vertices));
+    vertexBufferView_.StrideInBytes = sizeof(VertexData);
+    vertexResource_->Map(0, nullptr, reinterpret_cast<void **>(&vertexData));
+    std::memcpy(vertexData, vertices, sizeof(vertices));
+
+    uint32_t *indexData = nullptr;
+    indexResource_ = ParticleCommon::GetInstance()->GetDxCommon()->CreateBufferResource(sizeof(indices));
+    indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+    indexBufferView_.SizeInBytes = UINT(sizeof(indices));
+    indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
+    indexResource_->Map(0, nullptr, reinterpret_cast<void **>(&indexData));
+    std::memcpy(indexData, indices, sizeof(indices));
+}
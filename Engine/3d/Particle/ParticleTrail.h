@@ -0,0 +1,123 @@
+#pragma once
+#include "ModelStructs.h"
+#include "ViewProjection/ViewProjection.h"
+#include "type/Vector3.h"
+#include "type/Vector4.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// パーティクルの軌跡(リボン)
+/// 親パーティクルごとに固定長のリングバッファを持ち、
+/// プールは事前確保するため定常状態ではアロケーションしない
+/// </summary>
+class ParticleTrail {
+  public:
+    // 軌跡の点
+    struct TrailPoint {
+        Vector3 position;
+        Vector3 velocity;
+        Vector4 color;
+        float width;
+        float age;
+        float lifeTime;
+    };
+
+    // 1本分の軌跡
+    struct TrailSlot {
+        uint32_t head = 0;   // 最新の点の位置
+        uint32_t count = 0;  // 有効な点の数
+        bool inUse = false;  // 使用中か
+        bool orphan = false; // 親が消えた(点が消えきったら返却)
+        Vector3 headPosition;
+        Vector4 headColor;
+        float headWidth = 0.0f;
+    };
+
+    static const uint32_t kNumMaxSegment = 8192; // リボンの最大セグメント数(インスタンス数)
+    static constexpr uint32_t kNumMaxPointsPerTrail = 100;
+    static const int32_t kInvalidSlot = -1;
+
+  public:
+    /// <summary>
+    /// 初期化(GPUリソース生成、isHeadlessならCPUの配列に書き込むだけで描画しない)
+    /// </summary>
+    void Initialize(bool isHeadless = false);
+
+    /// <summary>
+    /// 1本あたりの点数に合わせてプールを確保し直す(設定変更時のみ)
+    /// </summary>
+    /// <returns>作り直した場合true(割り当て済みのスロットは無効になる)</returns>
+    bool Reserve(uint32_t pointsPerTrail);
+
+    /// <summary>
+    /// 空きスロットの取得(空きが無ければkInvalidSlot)
+    /// </summary>
+    int32_t Acquire();
+
+    /// <summary>
+    /// 親が消えたスロットを解放待ちにする
+    /// </summary>
+    void Release(int32_t slot);
+
+    /// <summary>
+    /// 全スロットを即時返却
+    /// </summary>
+    void Clear();
+
+    /// <summary>
+    /// 点の追加(満杯なら最古の点を上書き)
+    /// </summary>
+    void PushPoint(int32_t slot, const TrailPoint &point);
+
+    /// <summary>
+    /// 親の現在位置(リボンの先端)を更新
+    /// </summary>
+    void SetHead(int32_t slot, const Vector3 &position, float width, const Vector4 &color);
+
+    /// <summary>
+    /// 点の寿命と移動を進める
+    /// </summary>
+    void Update(float deltaTime);
+
+    /// <summary>
+    /// リボンのインスタンスデータを書き込む
+    /// </summary>
+    void WriteInstances(const ViewProjection &viewProjection);
+
+    /// <summary>
+    /// 描画
+    /// </summary>
+    void Draw(D3D12_GPU_VIRTUAL_ADDRESS materialAddress, uint32_t textureIndex);
+
+    uint32_t GetSegmentCount() const { return segmentCount_; }
+    uint32_t GetPointsPerTrail() const { return pointsPerTrail_; }
+
+  private:
+    void CreateVertexData();
+    void WriteSegment(const Vector3 &start, const Vector3 &end, float width, const Vector4 &color,
+                      const Vector3 &cameraPosition, const Matrix4x4 &viewProjectionMatrix);
+
+  private:
+    // 点のプール(スロット数 × 1本あたりの点数)
+    std::vector<TrailPoint> points_;
+    std::vector<TrailSlot> slots_;
+    std::vector<uint32_t> freeSlots_;
+    uint32_t pointsPerTrail_ = 0;
+    uint32_t segmentCount_ = 0;
+
+    // リボン用の板ポリ
+    Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_ = nullptr;
+    Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_ = nullptr;
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferView_{};
+    D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+
+    // セグメントごとのインスタンスデータ
+    Microsoft::WRL::ComPtr<ID3D12Resource> instancingResource_ = nullptr;
+    ParticleForGPU *instancingData_ = nullptr;
+    uint32_t instancingSRVIndex_ = 0;
+
+    // ヘッドレス時の書き込み先
+    bool isHeadless_ = false;
+    std::vector<ParticleForGPU> cpuInstances_;
+};
@@ -44,6 +44,10 @@ void Framework::Initialize() {
     srvManager->Initialize();
     ///--------------------------
 
+    ///--------ThreadPool--------
+    ThreadPool::GetInstance()->Initialize();
+    ///--------------------------
+
     ///--------BaseObjectManager--------
     baseObjectManager_ = BaseObjectManager::GetInstance();
     ///---------------------------------
@@ -114,6 +118,11 @@ void Framework::Initialize() {
     collisionManager_->Initialize();
     ///-------------------------------------
 
+    ///-------AnimationLibrary-------
+    // クリップを読み込む前に圧縮設定を読む
+    AnimationLibrary::GetInstance()->LoadCompressionSettings();
+    ///------------------------------
+
     ///-------SceneManager--------
     sceneManager_ = SceneManager::GetInstance();
     sceneManager_->Initialize();
@@ -148,6 +157,10 @@ void Framework::Initialize() {
 void Framework::Finalize() {
     sceneManager_->Finalize();
 
+    ///-------ThreadPool-------
+    ThreadPool::GetInstance()->Finalize();
+    ///------------------------
+
     // WindowsAPIの終了処理
     winApp->Finalize();
 
@@ -161,6 +174,8 @@ void Framework::Finalize() {
 
     ///-------ModelCommon-------
     modelManager_->Finalize();
+    AnimationLibrary::GetInstance()->Finalize();
+    AnimationUpdateQueue::GetInstance()->Finalize();
     ///---------------------------
 
     ///-------PrimitiveModel-------
@@ -180,6 +195,11 @@ void Framework::Finalize() {
     audio->Finalize();
     LightGroup::GetInstance()->Finalize();
     particleEditor->Finalize();
+    ParticleEmitterManager::GetInstance()->Finalize();
+    ParticleEffectLibrary::GetInstance()->Finalize();
+    MeshSurfaceSampler::ClearCache();
+    ParticleForceFieldManager::GetInstance()->Finalize();
+    ParticleInstancePool::GetInstance()->Finalize();
     spriteCommon->Finalize();
     particleCommon->Finalize();
     dxCommon->Finalize();
@@ -191,7 +211,9 @@ void Framework::Update() {
     /// deltaTimeの更新
     Frame::Update();
 
-    baseObjectManager_->Update();
+    // アニメーションのLODは実行中のシーンのカメラで選ぶ
+    BaseScene *scene = sceneManager_->GetBaseScene();
+    baseObjectManager_->Update(scene ? scene->GetViewProjection() : nullptr);
 
     sceneManager_->Update();
 
@@ -199,6 +221,9 @@ void Framework::Update() {
 
     LightGroup::GetInstance()->Update(*sceneManager_->GetBaseScene()->GetViewProjection());
 
+    // パーティクルのシミュレーション(描画では進めない)
+    ParticleEmitterManager::GetInstance()->Update(*sceneManager_->GetBaseScene()->GetViewProjection());
+
     /// -------更新処理開始----------
 
     // -------Input-------
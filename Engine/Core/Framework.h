@@ -7,6 +7,8 @@
 #include "CollisionManager.h"
 #include "Input.h"
 #include"Model/ModelManager.h"
+#include"Animation/AnimationLibrary.h"
+#include"Animation/AnimationUpdateQueue.h"
 #include"Object/Object3dCommon.h"
 #include "ParticleCommon.h"
 #include "ParticleEditor.h"
@@ -20,7 +22,13 @@
 #include"ImGui/ImGuizmoManager.h"
 #include"Object/BaseObjectManager.h"
 #include"Particle/ParticleGroupManager.h"
+#include"Particle/MeshSurfaceSampler.h"
+#include"Particle/ParticleForceField.h"
+#include"Particle/ParticleInstancePool.h"
+#include"Particle/ParticleEffectLibrary.h"
+#include"Particle/ParticleEmitterManager.h"
 #include"PipeLine/PipeLineManager.h"
+#include"Thread/ThreadPool.h"
 
 class Framework {
   public: // メンバ関数
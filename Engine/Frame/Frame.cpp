@@ -61,6 +61,14 @@ float Frame::DeltaTime() {
     return deltaTime_;
 }
 
+/// <summary>
+/// 経過時間を固定する
+/// </summary>
+/// <param name="deltaTime">次のUpdateまで返す経過時間</param>
+void Frame::SetDeltaTime(float deltaTime) {
+    deltaTime_ = deltaTime;
+}
+
 /// <summary>
 /// 現在のFPSを取得
 /// </summary>
@@ -22,5 +22,6 @@ class Frame {
     static void Init();       ///< フレームの初期化処理
     static void Update();     ///< フレームの更新処理
     static float DeltaTime(); ///< 前回の更新からの経過時間を取得
+    static void SetDeltaTime(float deltaTime); ///< 経過時間を固定する(Updateを回さないベンチマーク用)
     static float GetFPS();    ///< 現在のFPSを取得
 };
@@ -2,11 +2,19 @@
 #include "CollisionManager.h"
 #include "Object/Object3dCommon.h"
 #include "myMath.h"
+#include <algorithm>
 
 std::unordered_map<std::string, Collider *> CollisionManager::colliders_;
+std::vector<ColliderShape> CollisionManager::broadphase_;
+float CollisionManager::broadphaseMaxWidth_ = 0.0f;
+std::mutex CollisionManager::broadphaseMutex_;
+
 void CollisionManager::Reset() {
     // リストを空っぽにする
     colliders_.clear();
+    std::lock_guard<std::mutex> lock(broadphaseMutex_);
+    broadphase_.clear();
+    broadphaseMaxWidth_ = 0.0f;
 }
 
 // Colliderを削除する
@@ -42,6 +50,70 @@ void CollisionManager::UpdateWorldTransform() {
         // フレームごとの衝突フラグリセット
         collider->ResetCollisionFlag();
     }
+
+    RebuildBroadphase();
+}
+
+void CollisionManager::RebuildBroadphase() {
+    std::vector<ColliderShape> shapes;
+    shapes.reserve(colliders_.size());
+    float maxWidth = 0.0f;
+    for (auto &[name, collider] : colliders_) {
+        if (!collider->IsCollisionEnabled()) {
+            continue;
+        }
+        // 複数の判定が有効なら一番細かいもの(OBB→AABB→球)を使う
+        ColliderShape shape{};
+        if (collider->IsOBB()) {
+            OBB obb = collider->GetOBB();
+            shape.type = ColliderShape::Type::OBB;
+            shape.center = obb.scaleCenterRotated;
+            shape.size = obb.size;
+            const float size[3] = {obb.size.x, obb.size.y, obb.size.z};
+            Vector3 extent = {0.0f, 0.0f, 0.0f};
+            for (int i = 0; i < 3; ++i) {
+                shape.axes[i] = obb.orientations[i];
+                extent.x += std::abs(obb.orientations[i].x) * size[i];
+                extent.y += std::abs(obb.orientations[i].y) * size[i];
+                extent.z += std::abs(obb.orientations[i].z) * size[i];
+            }
+            shape.bounds = {shape.center - extent, shape.center + extent};
+        } else if (collider->IsAABB()) {
+            shape.type = ColliderShape::Type::AABB;
+            shape.aabb = collider->GetAABB();
+            shape.bounds = shape.aabb;
+        } else if (collider->IsSphere()) {
+            shape.type = ColliderShape::Type::Sphere;
+            shape.sphere = collider->GetSphere();
+            Vector3 extent = {shape.sphere.radius, shape.sphere.radius, shape.sphere.radius};
+            shape.bounds = {shape.sphere.center - extent, shape.sphere.center + extent};
+        } else {
+            continue;
+        }
+        maxWidth = std::max(maxWidth, shape.bounds.max.x - shape.bounds.min.x);
+        shapes.push_back(shape);
+    }
+    std::sort(shapes.begin(), shapes.end(), [](const ColliderShape &a, const ColliderShape &b) { return a.bounds.min.x < b.bounds.min.x; });
+
+    std::lock_guard<std::mutex> lock(broadphaseMutex_);
+    broadphase_.swap(shapes);
+    broadphaseMaxWidth_ = maxWidth;
+}
+
+void CollisionManager::QueryShapes(const AABB &bounds, std::vector<ColliderShape> &results) {
+    results.clear();
+    std::lock_guard<std::mutex> lock(broadphaseMutex_);
+    // min.xがbounds.min.x - 最大幅より小さいものは届かない
+    float searchStart = bounds.min.x - broadphaseMaxWidth_;
+    auto it = std::lower_bound(broadphase_.begin(), broadphase_.end(), searchStart,
+                               [](const ColliderShape &shape, float x) { return shape.bounds.min.x < x; });
+    for (; it != broadphase_.end() && it->bounds.min.x <= bounds.max.x; ++it) {
+        const AABB &other = it->bounds;
+        if (other.max.x >= bounds.min.x && other.min.y <= bounds.max.y && other.max.y >= bounds.min.y &&
+            other.min.z <= bounds.max.z && other.max.z >= bounds.min.z) {
+            results.push_back(*it);
+        }
+    }
 }
 
 void CollisionManager::Draw(const ViewProjection &viewProjection) {
@@ -5,6 +5,8 @@
 #include "SceneManager.h"
 #include "list"
 #include "myMath.h"
+#include <mutex>
+#include <vector>
 class CollisionManager {
   public:
     struct pair_hash {
@@ -21,6 +23,10 @@ class CollisionManager {
     // コライダー
     static std::unordered_map<std::string, Collider *> colliders_;
     std::unordered_map<std::pair<Collider *, Collider *>, bool, pair_hash> collisionStates;
+    // 一括問い合わせ用(bounds.min.xの昇順)
+    static std::vector<ColliderShape> broadphase_;
+    static float broadphaseMaxWidth_; // X方向の最大の幅(探索開始位置を決める)
+    static std::mutex broadphaseMutex_;
     bool isCollidingNow = false;
 
   public:
@@ -69,7 +75,16 @@ class CollisionManager {
     /// </summary>
     static void AddCollider(Collider *collider);
 
+    /// <summary>
+    /// boundsと重なるコライダーの形状をまとめて取得(X軸でソートした配列を二分探索して走査する)
+    /// 形状はUpdateWorldTransform時点のコピーなので、別スレッドから呼んでもよい
+    /// </summary>
+    static void QueryShapes(const AABB &bounds, std::vector<ColliderShape> &results);
+
   private:
+    // 一括問い合わせ用の形状を作り直す
+    void RebuildBroadphase();
+
     bool IsCollision(const AABB &aabb1, const AABB &aabb2);
     bool IsCollision(const OBB &obb1, const OBB &obb2);
     bool IsCollision(const AABB &aabb, const Sphere &sphere);
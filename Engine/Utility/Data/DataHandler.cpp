@@ -6,6 +6,23 @@ DataHandler::DataHandler(const std::string &folder, const std::string &file) {
     fs::create_directories(folderPath); // フォルダを作成
 }
 
+json DataHandler::LoadAll() const {
+    std::string filePath = folderPath + "/" + fileName;
+    json j = json::object();
+
+    std::ifstream inFile(filePath);
+    if (!inFile.is_open()) {
+        return j; // ファイルがない場合
+    }
+    try {
+        inFile >> j;
+    } catch (const json::exception &e) {
+        std::cerr << "JSON Load Error: " << e.what() << " (File: " << filePath << ")" << std::endl;
+        j = json::object();
+    }
+    return j;
+}
+
 // 明示的なテンプレートインスタンス化
 template void DataHandler::Save<int>(const std::string &, const int &);
 template void DataHandler::Save<int32_t>(const std::string &, const int32_t &);
@@ -30,6 +30,9 @@ class DataHandler {
     // JSONデータをロード
     template <typename T>
     T Load(const std::string &key, const T &defaultValue);
+
+    // ファイル全体を1回で読み込む(無ければ空のオブジェクト)
+    json LoadAll() const;
 };
 
 // JSON変換の定義 (Vector2)
@@ -0,0 +1,96 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef ENABLE_ALLOCATION_COUNTER
+namespace {
+// スレッドごとの数(キャッシュラインを分けて取り合わないようにする。上限を超えたスレッドは最後の枠を共有)
+constexpr uint32_t kMaxThreads = 64;
+struct alignas(64) ThreadCount {
+    std::atomic<size_t> count{0};
+};
+ThreadCount threadCounts[kMaxThreads];
+std::atomic<uint32_t> nextSlot{0};
+thread_local uint32_t slot = UINT32_MAX;
+
+// 計測していないときは分岐1つだけのコストにする
+std::atomic<bool> isCounting{false};
+
+void *Allocate(size_t size) {
+    if (isCounting.load(std::memory_order_relaxed)) {
+        if (slot == UINT32_MAX) {
+            uint32_t next = nextSlot.fetch_add(1, std::memory_order_relaxed);
+            slot = next < kMaxThreads ? next : kMaxThreads - 1;
+        }
+        threadCounts[slot].count.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+} // namespace
+
+namespace AllocationCounter {
+bool IsEnabled() {
+    return true;
+}
+
+void Begin() {
+    for (ThreadCount &threadCount : threadCounts) {
+        threadCount.count.store(0, std::memory_order_relaxed);
+    }
+    isCounting.store(true, std::memory_order_release);
+}
+
+size_t End() {
+    isCounting.store(false, std::memory_order_release);
+    size_t total = 0;
+    for (const ThreadCount &threadCount : threadCounts) {
+        total += threadCount.count.load(std::memory_order_acquire);
+    }
+    return total;
+}
+} // namespace AllocationCounter
+
+// アラインメント指定版・nothrow版は既定の実装(内部でこちらを呼ぶもの以外は数えない)
+void *operator new(size_t size) {
+    return Allocate(size);
+}
+
+void *operator new[](size_t size) {
+    return Allocate(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+#else
+namespace AllocationCounter {
+bool IsEnabled() {
+    return false;
+}
+
+void Begin() {
+}
+
+size_t End() {
+    return 0;
+}
+} // namespace AllocationCounter
+#endif
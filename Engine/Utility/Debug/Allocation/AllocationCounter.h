@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+
+/// <summary>
+/// ヒープ確保回数の計測(グローバルのoperator newを置き換えて数える)
+/// Begin～Endの間に全スレッド(ワーカー含む)で行われたnew/new[]の回数を返す(スレッドごとに数えて合計する)
+/// 置き換えはENABLE_ALLOCATION_COUNTERを定義したビルド(Debug構成)だけで、それ以外では何も数えない
+/// </summary>
+namespace AllocationCounter {
+// operator newを置き換えて数えているか
+bool IsEnabled();
+void Begin();
+size_t End();
+} // namespace AllocationCounter
@@ -0,0 +1,37 @@
+#include "CommandLine.h"
+#include <sstream>
+
+namespace CommandLine {
+bool FindOption(const std::string &commandLine, const std::string &key, std::string &value) {
+    std::istringstream stream(commandLine);
+    std::string token;
+    const std::string prefix = "--" + key + "=";
+    while (stream >> token) {
+        if (token.rfind(prefix, 0) == 0) {
+            value = token.substr(prefix.size());
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> Split(const std::string &text) {
+    std::vector<std::string> result;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            result.push_back(item);
+        }
+    }
+    return result;
+}
+
+std::vector<uint32_t> SplitNumbers(const std::string &text) {
+    std::vector<uint32_t> result;
+    for (const std::string &item : Split(text)) {
+        result.push_back(static_cast<uint32_t>(std::stoul(item)));
+    }
+    return result;
+}
+} // namespace CommandLine
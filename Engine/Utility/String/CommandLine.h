@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// コマンドライン引数の解釈(ベンチマーク用の "--key=value" 形式)
+/// </summary>
+namespace CommandLine {
+// "--key=a,b,c" の値を取り出す(見つからなければfalse)
+bool FindOption(const std::string &commandLine, const std::string &key, std::string &value);
+// カンマ区切りを分割する(空の要素は除く)
+std::vector<std::string> Split(const std::string &text);
+// カンマ区切りの数値を分割する
+std::vector<uint32_t> SplitNumbers(const std::string &text);
+} // namespace CommandLine
@@ -0,0 +1,136 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+
+ThreadPool *ThreadPool::instance = nullptr;
+
+ThreadPool *ThreadPool::GetInstance() {
+    if (instance == nullptr) {
+        instance = new ThreadPool();
+    }
+    return instance;
+}
+
+void ThreadPool::Finalize() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isStop_ = true;
+    }
+    condition_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    delete instance;
+    instance = nullptr;
+}
+
+void ThreadPool::Initialize(uint32_t threadCount) {
+    if (threadCount == 0) {
+        // メインスレッドの分を残す
+        threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+    workers_.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+std::future<void> ThreadPool::Submit(std::function<void()> task) {
+    std::packaged_task<void()> packagedTask(std::move(task));
+    std::future<void> future = packagedTask.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push(std::move(packagedTask));
+    }
+    condition_.notify_one();
+    return future;
+}
+
+void ThreadPool::ParallelFor(uint32_t count, uint32_t grainSize, RangeFunction function, const void *context) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = std::max(grainSize, 1u);
+    const uint32_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (chunkCount == 1 || workers_.empty()) {
+        function(context, 0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 枠が使用中(ワーカーの中から・別スレッドから同時に呼ばれた)なら呼び出し側で全部処理する
+        if (parallelJob_.isActive) {
+            function(context, 0, count);
+            return;
+        }
+        parallelJob_.function = function;
+        parallelJob_.context = context;
+        parallelJob_.count = count;
+        parallelJob_.grainSize = grainSize;
+        parallelJob_.chunkCount = chunkCount;
+        parallelJob_.maxHelperCount = std::min(static_cast<uint32_t>(workers_.size()), chunkCount - 1);
+        parallelJob_.nextChunk.store(0, std::memory_order_relaxed);
+        parallelJob_.doneChunk.store(0, std::memory_order_relaxed);
+        ++parallelJob_.generation;
+        parallelJob_.isActive = true;
+    }
+    condition_.notify_all();
+
+    RunParallelChunks();
+    // 取り出されたチャンクが全部終わるまで待つ
+    while (parallelJob_.doneChunk.load(std::memory_order_acquire) < chunkCount) {
+        std::this_thread::yield();
+    }
+    // 新しく参加させないようにしてから、参加済みのワーカーが抜けるのを待つ(抜けるまで枠を書き換えない)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        parallelJob_.isActive = false;
+    }
+    while (parallelJob_.helperCount.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+
+void ThreadPool::RunParallelChunks() {
+    uint32_t chunk;
+    while ((chunk = parallelJob_.nextChunk.fetch_add(1)) < parallelJob_.chunkCount) {
+        uint32_t begin = chunk * parallelJob_.grainSize;
+        uint32_t end = std::min(begin + parallelJob_.grainSize, parallelJob_.count);
+        parallelJob_.function(parallelJob_.context, begin, end);
+        parallelJob_.doneChunk.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    uint32_t parallelGeneration = 0; // 最後に参加したParallelForのジョブ
+    while (true) {
+        std::packaged_task<void()> task;
+        bool isParallel = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto canJoin = [this, &parallelGeneration] {
+                return parallelJob_.isActive && parallelJob_.generation != parallelGeneration &&
+                       parallelJob_.helperCount.load(std::memory_order_relaxed) < parallelJob_.maxHelperCount;
+            };
+            condition_.wait(lock, [this, &canJoin] { return isStop_ || !tasks_.empty() || canJoin(); });
+            if (canJoin()) {
+                parallelGeneration = parallelJob_.generation;
+                parallelJob_.helperCount.fetch_add(1, std::memory_order_relaxed);
+                isParallel = true;
+            } else if (isStop_ && tasks_.empty()) {
+                return;
+            } else {
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+        }
+        if (isParallel) {
+            RunParallelChunks();
+            parallelJob_.helperCount.fetch_sub(1, std::memory_order_release);
+        } else {
+            task();
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// ワーカースレッドプール
+/// </summary>
+class ThreadPool {
+  private:
+    static ThreadPool *instance;
+
+    ThreadPool() = default;
+    ~ThreadPool() = default;
+    ThreadPool(ThreadPool &) = delete;
+    ThreadPool &operator=(ThreadPool &) = delete;
+
+  public:
+    /// <summary>
+    /// シングルトンインスタンスの取得
+    /// </summary>
+    static ThreadPool *GetInstance();
+
+    /// <summary>
+    /// 終了(実行中のタスクを待ってからスレッドを止める)
+    /// </summary>
+    void Finalize();
+
+    /// <summary>
+    /// 初期化(0ならハードウェアスレッド数-1)
+    /// </summary>
+    void Initialize(uint32_t threadCount = 0);
+
+    /// <summary>
+    /// タスクの投入
+    /// </summary>
+    std::future<void> Submit(std::function<void()> task);
+
+    /// <summary>
+    /// [0, count)をgrainSize個ずつに分けて並列に実行する(呼び出し側のスレッドも分担する)
+    /// ジョブの枠は使い回すのでヒープ確保しない(functionはコピーせず、戻るまで呼び出し側のものを参照する)
+    /// ワーカースレッドの中から呼んだり、別のParallelForの実行中に呼んだりした場合は、呼び出し側が全部処理する
+    /// </summary>
+    template <typename Function>
+    void ParallelFor(uint32_t count, uint32_t grainSize, const Function &function) {
+        ParallelFor(count, grainSize, &InvokeRange<Function>, &function);
+    }
+
+    // 範囲を処理する関数(contextはParallelForに渡した関数オブジェクト)
+    using RangeFunction = void (*)(const void *context, uint32_t begin, uint32_t end);
+    void ParallelFor(uint32_t count, uint32_t grainSize, RangeFunction function, const void *context);
+
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+  private:
+    // ParallelForの実行中のジョブ(1つだけ、mutex_で守る項目と、チャンクの取り合いのatomicに分かれる)
+    struct ParallelJob {
+        RangeFunction function = nullptr;
+        const void *context = nullptr;
+        uint32_t count = 0;
+        uint32_t grainSize = 0;
+        uint32_t chunkCount = 0;
+        uint32_t maxHelperCount = 0;
+        uint32_t generation = 0; // 投入ごとに増やし、ワーカーが同じジョブに2回入らないようにする
+        bool isActive = false;
+        std::atomic<uint32_t> helperCount{0}; // 参加中のワーカー数(0になるまで枠を使い回さない)
+        std::atomic<uint32_t> nextChunk{0};
+        std::atomic<uint32_t> doneChunk{0};
+    };
+
+    template <typename Function>
+    static void InvokeRange(const void *context, uint32_t begin, uint32_t end) {
+        (*static_cast<const Function *>(context))(begin, end);
+    }
+
+    void WorkerLoop();
+    void RunParallelChunks();
+
+  private:
+    std::vector<std::thread> workers_;
+    std::queue<std::packaged_task<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool isStop_ = false;
+    ParallelJob parallelJob_;
+};
@@ -28,6 +28,12 @@ void BaseObject::Update() {
     SetBlendMode(blendMode_);
 }
 
+void BaseObject::SelectAnimationLod(const ViewProjection &viewProjection) {
+    if (obj3d_->GetHaveAnimation()) {
+        obj3d_->SelectAnimationLod(transform_, viewProjection);
+    }
+}
+
 void BaseObject::Draw(const ViewProjection &viewProjection, Vector3 offSet) {
     // オフセットを加える前の現在の位置を取得
     Vector3 currentPosition = transform_.translation_;
@@ -197,6 +203,21 @@ void BaseObject::DebugObject() {
                 ShowFileSelector();
                 ImGui::TreePop();
             }
+            if (ImGui::TreeNode("LOD")) {
+                AnimationLodSettings lod = obj3d_->GetAnimationLodSettings();
+                ImGui::Checkbox("有効", &lod.isEnabled);
+                ImGui::DragFloat("間引く大きさ", &lod.reducedCoverage, 0.01f, 0.0f, 1.0f);
+                ImGui::DragFloat("末端を省く大きさ", &lod.minimumCoverage, 0.01f, 0.0f, 1.0f);
+                ImGui::DragInt("間引く間隔", &lod.reducedInterval, 1.0f, 1, 16);
+                ImGui::DragInt("末端を省く間隔", &lod.minimumInterval, 1.0f, 1, 16);
+                ImGui::DragInt("省くJointの高さ", &lod.skipJointHeight, 1.0f, 0, 8);
+                ImGui::DragFloat("半径(0で自動)", &lod.radius, 0.01f, 0.0f, 100.0f);
+                obj3d_->SetAnimationLodSettings(lod);
+                static const char *tierNames[] = {"Full", "Reduced", "Minimum", "Frozen"};
+                ImGui::Text("段階: %s 大きさ: %.3f", tierNames[static_cast<int>(obj3d_->GetAnimationLod().GetTier())],
+                            obj3d_->GetAnimationLod().GetCoverage());
+                ImGui::TreePop();
+            }
         }
     }
 }
@@ -245,11 +266,29 @@ void BaseObject::AnimaSaveToJson() {
         return;
     }
     AnimaDatas_->Save<bool>("Loop", isLoop_);
+    const AnimationLodSettings &lod = obj3d_->GetAnimationLodSettings();
+    AnimaDatas_->Save<bool>("LodEnabled", lod.isEnabled);
+    AnimaDatas_->Save<float>("LodReducedCoverage", lod.reducedCoverage);
+    AnimaDatas_->Save<float>("LodMinimumCoverage", lod.minimumCoverage);
+    AnimaDatas_->Save<int>("LodReducedInterval", lod.reducedInterval);
+    AnimaDatas_->Save<int>("LodMinimumInterval", lod.minimumInterval);
+    AnimaDatas_->Save<int>("LodSkipJointHeight", lod.skipJointHeight);
+    AnimaDatas_->Save<float>("LodRadius", lod.radius);
 }
 
 void BaseObject::AnimaLoadFromJson() {
     AnimaDatas_ = std::make_unique<DataHandler>("Animation", objectName_);
     isLoop_ = AnimaDatas_->Load<bool>("Loop", false);
+    // アニメーションのLOD(無ければ既定値、無効)
+    AnimationLodSettings lod;
+    lod.isEnabled = AnimaDatas_->Load<bool>("LodEnabled", lod.isEnabled);
+    lod.reducedCoverage = AnimaDatas_->Load<float>("LodReducedCoverage", lod.reducedCoverage);
+    lod.minimumCoverage = AnimaDatas_->Load<float>("LodMinimumCoverage", lod.minimumCoverage);
+    lod.reducedInterval = AnimaDatas_->Load<int>("LodReducedInterval", lod.reducedInterval);
+    lod.minimumInterval = AnimaDatas_->Load<int>("LodMinimumInterval", lod.minimumInterval);
+    lod.skipJointHeight = AnimaDatas_->Load<int>("LodSkipJointHeight", lod.skipJointHeight);
+    lod.radius = AnimaDatas_->Load<float>("LodRadius", lod.radius);
+    obj3d_->SetAnimationLodSettings(lod);
 }
 
 void BaseObject::ShowFileSelector() {
@@ -55,6 +55,9 @@ class BaseObject : public Collider {
 
     virtual void ImGui();
 
+    // カメラから見た大きさでアニメーションのLODを選ぶ(BaseObjectManagerがUpdateの後に呼ぶ)
+    void SelectAnimationLod(const ViewProjection &viewProjection);
+
     Vector3 GetCenterPosition() const override;
     Vector3 GetCenterRotation() const override;
 
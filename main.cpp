@@ -1,8 +1,19 @@
 #include"d3dx12.h"
 #include "MyGame.h"
+#include "Animation/AnimationBenchmark.h"
+#include "Particle/ParticleBenchmark.h"
 
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR lpCmdLine, int)
 {
+	// パーティクルのヘッドレスベンチマーク(デバイスを作らずに計測して終了)
+	if (ParticleBenchmark::IsRequested(lpCmdLine)) {
+		return ParticleBenchmark::RunFromCommandLine(lpCmdLine);
+	}
+	// キーフレームのサンプリングのベンチマーク
+	if (AnimationBenchmark::IsRequested(lpCmdLine)) {
+		return AnimationBenchmark::RunFromCommandLine(lpCmdLine);
+	}
+
 	std::unique_ptr<Framework> game = std::make_unique<MyGame>();
 
 	game->Run();
@@ -3,6 +3,7 @@
 #include "type/Vector4.h"
 #include "assert.h"
 #include "cmath"
+#include <cstdint>
 #include <type/Vector3.h>
 #include <type/Quaternion.h>
 
@@ -21,6 +22,21 @@ struct OBB {
 	Vector3 size;            // サイズ
 	Vector3 orientations[3]; // 各軸の方向ベクトル
 };
+// コライダーの形状のワールド座標でのコピー(パーティクルなどからの一括問い合わせ用)
+struct ColliderShape {
+	enum class Type : int32_t {
+		Sphere,
+		AABB,
+		OBB,
+	};
+	Type type;
+	AABB bounds;     // 形状を囲むAABB
+	Sphere sphere;
+	AABB aabb;
+	Vector3 center;  // OBBの中心
+	Vector3 axes[3]; // OBBの各軸
+	Vector3 size;    // OBBの各軸方向の半分の大きさ
+};
 
 class ViewProjection;
 
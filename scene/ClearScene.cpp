@@ -1,5 +1,6 @@
 #include "ClearScene.h"
 #include "SceneManager.h"
+#include "ParticleEmitterManager.h"
 
 void ClearScene::Initialize() {
     audio_ = Audio::GetInstance();
@@ -37,6 +38,7 @@ void ClearScene::Draw() {
     /// Particleの描画準備
     ptCommon_->DrawCommonSetting();
     //------Particleの描画開始-------
+    ParticleEmitterManager::GetInstance()->DrawPools();
 
     //-----------------------------
 
@@ -1,5 +1,6 @@
 #include "DemoScene.h"
 #include "SceneManager.h"
+#include "ParticleEmitterManager.h"
 
 void DemoScene::Initialize() {
     audio_ = Audio::GetInstance();
@@ -39,7 +40,8 @@ void DemoScene::Draw() {
     /// Particleの描画準備
     ptCommon_->DrawCommonSetting();
     //------Particleの描画開始-------
-    ptEditor_->DrawAll(vp_);
+    ParticleEmitterManager::GetInstance()->DrawPools();
+    ptEditor_->DrawAll();
     //-----------------------------
 
     /// ----------------------------------
@@ -1,5 +1,6 @@
 #include "GameScene.h"
 #include "SceneManager.h"
+#include "ParticleEmitterManager.h"
 
 void GameScene::Initialize() {
     audio_ = Audio::GetInstance();
@@ -37,6 +38,7 @@ void GameScene::Draw() {
     /// Particleの描画準備
     ptCommon_->DrawCommonSetting();
     //------Particleの描画開始-------
+    ParticleEmitterManager::GetInstance()->DrawPools();
 
     //-----------------------------
 